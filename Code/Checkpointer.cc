@@ -0,0 +1,357 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "Checkpointer.h"
+#include <algorithm>
+#include <csignal>
+#include <cstdio>
+#include <utility>
+#include <vector>
+#include "io/formats/checkpoint.h"
+#include "net/MpiFile.h"
+#include "log/Logger.h"
+#include "Exception.h"
+
+namespace
+{
+  volatile std::sig_atomic_t terminationSignalled = 0;
+
+  extern "C" void OnTerminationSignal(int)
+  {
+    terminationSignalled = 1;
+  }
+}
+
+Checkpointer::Checkpointer(const hemelb::net::IOCommunicator& ioComms, hemelb::geometry::LatticeData& latticeData,
+                           hemelb::lb::SimulationState& simulationState,
+                           hemelb::colloids::ColloidController* colloidController,
+                           hemelb::reporting::Timers& timings) :
+    ioComms(ioComms), latticeData(latticeData), simulationState(simulationState), colloidController(colloidController),
+        timings(timings), writeTimeStep(0), writeSiteType(MPI_DATATYPE_NULL), writeRequest(MPI_REQUEST_NULL)
+{
+}
+
+Checkpointer::~Checkpointer()
+{
+  Finish();
+}
+
+void Checkpointer::CatchTerminationSignal()
+{
+  std::signal(SIGTERM, OnTerminationSignal);
+}
+
+bool Checkpointer::IsTerminationRequested() const
+{
+  int signalled = terminationSignalled;
+  return ioComms.AllReduce(signalled, MPI_MAX) != 0;
+}
+
+MPI_Offset Checkpointer::GetParticleRecordLength()
+{
+  int size;
+  HEMELB_MPI_CALL(MPI_Type_size, (hemelb::net::MpiDataType<hemelb::colloids::PersistedParticle>(), &size));
+  return size;
+}
+
+void Checkpointer::GetSitesInGeometryOrder(std::vector<std::pair<hemelb::site_t, hemelb::site_t> >& sites) const
+{
+  // Each rank knows which sites are fluid on the blocks it has sites on, so between them they
+  // know how many fluid sites are on every block.
+  const hemelb::site_t blockCount = latticeData.GetBlockCount();
+  const hemelb::site_t sitesPerBlock = latticeData.GetSitesPerBlockVolumeUnit();
+  std::vector<hemelb::site_t> fluidSitesOnEachBlock(blockCount, 0);
+  for (hemelb::site_t blockId = 0; blockId < blockCount; ++blockId)
+  {
+    const hemelb::geometry::Block& block = latticeData.GetBlock(blockId);
+    if (block.IsEmpty())
+    {
+      continue;
+    }
+    for (hemelb::site_t site = 0; site < sitesPerBlock; ++site)
+    {
+      if (block.GetProcessorRankForSite(site) != hemelb::SITE_OR_BLOCK_SOLID)
+      {
+        ++fluidSitesOnEachBlock[blockId];
+      }
+    }
+  }
+  fluidSitesOnEachBlock = ioComms.AllReduce(fluidSitesOnEachBlock, MPI_MAX);
+
+  sites.clear();
+  hemelb::site_t geometryIndex = 0;
+  for (hemelb::site_t blockId = 0; blockId < blockCount; ++blockId)
+  {
+    const hemelb::geometry::Block& block = latticeData.GetBlock(blockId);
+    if (block.IsEmpty())
+    {
+      geometryIndex += fluidSitesOnEachBlock[blockId];
+      continue;
+    }
+    for (hemelb::site_t site = 0; site < sitesPerBlock; ++site)
+    {
+      const hemelb::proc_t rank = block.GetProcessorRankForSite(site);
+      if (rank == hemelb::SITE_OR_BLOCK_SOLID)
+      {
+        continue;
+      }
+      if (rank == ioComms.Rank())
+      {
+        sites.push_back(std::make_pair(geometryIndex, block.GetLocalContiguousIndexForSite(site)));
+      }
+      ++geometryIndex;
+    }
+  }
+}
+
+MPI_Datatype Checkpointer::SetSitesView(hemelb::net::MpiFile& file,
+                                        const std::vector<std::pair<hemelb::site_t, hemelb::site_t> >& sites) const
+{
+  const int numVectors = latticeData.GetLatticeInfo().GetNumVectors();
+  MPI_Datatype siteType;
+  HEMELB_MPI_CALL(MPI_Type_contiguous, (numVectors, hemelb::net::MpiDataType<hemelb::distribn_t>(), &siteType));
+  HEMELB_MPI_CALL(MPI_Type_commit, (&siteType));
+
+  // One piece for each run of sites next to each other in the file.
+  std::vector<int> lengths;
+  std::vector<MPI_Aint> displacements;
+  for (size_t index = 0; index < sites.size(); ++index)
+  {
+    if (index > 0 && sites[index].first == sites[index - 1].first + 1)
+    {
+      ++lengths.back();
+    }
+    else
+    {
+      lengths.push_back(1);
+      displacements.push_back(sites[index].first * numVectors * sizeof(hemelb::distribn_t));
+    }
+  }
+  MPI_Datatype fileType;
+  HEMELB_MPI_CALL(MPI_Type_create_hindexed,
+                  (lengths.size(), lengths.empty() ? NULL : &lengths[0],
+                      displacements.empty() ? NULL : &displacements[0], siteType, &fileType));
+  HEMELB_MPI_CALL(MPI_Type_commit, (&fileType));
+  file.SetView(hemelb::io::formats::checkpoint::HeaderLength, siteType, fileType, "native", MPI_INFO_NULL);
+  HEMELB_MPI_CALL(MPI_Type_free, (&fileType));
+  return siteType;
+}
+
+void Checkpointer::Start(const std::string& path)
+{
+  namespace checkpoint = hemelb::io::formats::checkpoint;
+  Finish();
+  timings[hemelb::reporting::Timers::checkpoint].Start();
+  const uint64_t numVectors = latticeData.GetLatticeInfo().GetNumVectors();
+
+  // Copy the distributions, in the order of the sites in the file, for the simulation to carry
+  // on while they are written.
+  std::vector<std::pair<hemelb::site_t, hemelb::site_t> > sites;
+  GetSitesInGeometryOrder(sites);
+  std::vector<hemelb::distribn_t> localDistributions;
+  latticeData.GetLocalDistributions(localDistributions);
+  writeDistributions.clear();
+  writeDistributions.reserve(localDistributions.size());
+  for (size_t index = 0; index < sites.size(); ++index)
+  {
+    writeDistributions.insert(writeDistributions.end(),
+                              localDistributions.begin() + sites[index].second * numVectors,
+                              localDistributions.begin() + (sites[index].second + 1) * numVectors);
+  }
+
+  std::vector<hemelb::colloids::Particle> particles;
+  if (colloidController != NULL)
+  {
+    colloidController->GetParticleSet().GetLocalParticles(particles);
+  }
+  // Each rank's particles go after those of the ranks before it.
+  const std::vector<uint64_t> particleCounts = ioComms.AllGather((uint64_t) particles.size());
+  uint64_t particlesBefore = 0, totalParticles = 0;
+  for (int rank = 0; rank < ioComms.Size(); ++rank)
+  {
+    if (rank == ioComms.Rank())
+    {
+      particlesBefore = totalParticles;
+    }
+    totalParticles += particleCounts[rank];
+  }
+  const uint64_t totalSites = latticeData.GetTotalFluidSites();
+  const MPI_Offset particlesStart = checkpoint::HeaderLength
+      + (MPI_Offset) (totalSites * numVectors * sizeof(hemelb::distribn_t));
+
+  // Write to another name first, so that a run killed part way through still leaves the last
+  // checkpoint whole.
+  writePath = path;
+  writeTimeStep = simulationState.GetTimeStep();
+  writeFile = hemelb::net::MpiFile::Open(ioComms, writePath + ".tmp", MPI_MODE_WRONLY | MPI_MODE_CREATE);
+  HEMELB_MPI_CALL(MPI_File_set_size,
+                  (writeFile, particlesStart + (MPI_Offset) totalParticles * GetParticleRecordLength()));
+
+  if (ioComms.OnIORank())
+  {
+    std::vector<uint64_t> header;
+    header.push_back(hemelb::io::formats::HemeLbMagicNumber);
+    header.push_back(checkpoint::MagicNumber);
+    header.push_back(checkpoint::VersionNumber);
+    header.push_back(numVectors);
+    header.push_back(writeTimeStep);
+    header.push_back(ioComms.Size());
+    header.push_back(totalSites);
+    header.push_back(totalParticles);
+    writeFile.WriteAt(0, header);
+  }
+
+  // The particles are few, so just write them, before the view changes to the distributions.
+  // Their datatype covers just their persisted properties.
+  hemelb::colloids::Particle* particleData = particles.empty() ?
+    NULL :
+    &particles[0];
+  HEMELB_MPI_CALL(MPI_File_write_at_all,
+                  (writeFile, particlesStart + (MPI_Offset) particlesBefore * GetParticleRecordLength(), particleData,
+                      particles.size(), hemelb::net::MpiDataType<hemelb::colloids::PersistedParticle>(), MPI_STATUS_IGNORE));
+
+  writeSiteType = SetSitesView(writeFile, sites);
+  hemelb::distribn_t* distributionData = writeDistributions.empty() ?
+    NULL :
+    &writeDistributions[0];
+  HEMELB_MPI_CALL(MPI_File_iwrite_all,
+                  (writeFile, distributionData, sites.size(), writeSiteType, &writeRequest));
+
+  timings[hemelb::reporting::Timers::checkpointBackground].Start();
+  timings[hemelb::reporting::Timers::checkpoint].Stop();
+}
+
+bool Checkpointer::IsWriting() const
+{
+  return !writePath.empty();
+}
+
+bool Checkpointer::IsWritten()
+{
+  int written;
+  HEMELB_MPI_CALL(MPI_Test, (&writeRequest, &written, MPI_STATUS_IGNORE));
+  return ioComms.AllReduce(written, MPI_MIN) != 0;
+}
+
+void Checkpointer::Finish()
+{
+  if (!IsWriting())
+  {
+    return;
+  }
+  timings[hemelb::reporting::Timers::checkpoint].Start();
+
+  HEMELB_MPI_CALL(MPI_Wait, (&writeRequest, MPI_STATUS_IGNORE));
+  HEMELB_MPI_CALL(MPI_Type_free, (&writeSiteType));
+  writeFile.Close();
+  timings[hemelb::reporting::Timers::checkpointBackground].Stop();
+
+  const std::string temporaryPath = writePath + ".tmp";
+  if (ioComms.OnIORank() && std::rename(temporaryPath.c_str(), writePath.c_str()) != 0)
+  {
+    throw hemelb::Exception() << "Couldn't rename " << temporaryPath << " to " << writePath;
+  }
+  hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("time step %lu, wrote checkpoint to %s",
+                                                                      writeTimeStep,
+                                                                      writePath.c_str());
+  writePath.clear();
+  std::vector<hemelb::distribn_t>().swap(writeDistributions);
+
+  timings[hemelb::reporting::Timers::checkpoint].Stop();
+}
+
+void Checkpointer::Write(const std::string& path)
+{
+  Start(path);
+  Finish();
+}
+
+void Checkpointer::Read(const std::string& path)
+{
+  namespace checkpoint = hemelb::io::formats::checkpoint;
+  const uint64_t numVectors = latticeData.GetLatticeInfo().GetNumVectors();
+
+  hemelb::net::MpiFile file = hemelb::net::MpiFile::Open(ioComms, path, MPI_MODE_RDONLY);
+
+  std::vector<uint64_t> header(checkpoint::HeaderLength / sizeof(uint64_t));
+  if (ioComms.OnIORank())
+  {
+    file.ReadAt(0, header);
+  }
+  ioComms.Broadcast(header, ioComms.GetIORank());
+  if (header[0] != (uint64_t) hemelb::io::formats::HemeLbMagicNumber || header[1] != (uint64_t) checkpoint::MagicNumber)
+  {
+    throw hemelb::Exception() << path << " is not a checkpoint";
+  }
+  if (header[2] != (uint64_t) checkpoint::VersionNumber)
+  {
+    throw hemelb::Exception() << path << " is a version " << header[2] << " checkpoint, not version "
+        << checkpoint::VersionNumber;
+  }
+  if (header[3] != numVectors)
+  {
+    throw hemelb::Exception() << path << " has " << header[3] << " distributions per site, not " << numVectors;
+  }
+  if (header[6] != (uint64_t) latticeData.GetTotalFluidSites())
+  {
+    throw hemelb::Exception() << path << " has " << header[6] << " fluid sites, not " << latticeData.GetTotalFluidSites();
+  }
+  const hemelb::LatticeTimeStep timeStep = header[4];
+  const uint64_t writers = header[5];
+  const uint64_t totalSites = header[6];
+  const uint64_t totalParticles = header[7];
+  const MPI_Offset particlesStart = checkpoint::HeaderLength
+      + (MPI_Offset) (totalSites * numVectors * sizeof(hemelb::distribn_t));
+
+  // The sites are in the geometry's order, so each rank can pick out its own, however the
+  // domain is decomposed.
+  std::vector<std::pair<hemelb::site_t, hemelb::site_t> > sites;
+  GetSitesInGeometryOrder(sites);
+  std::vector<hemelb::distribn_t> distributions(sites.size() * numVectors);
+  MPI_Datatype siteType = SetSitesView(file, sites);
+  hemelb::distribn_t* distributionData = distributions.empty() ?
+    NULL :
+    &distributions[0];
+  HEMELB_MPI_CALL(MPI_File_read_all, (file, distributionData, sites.size(), siteType, MPI_STATUS_IGNORE));
+  HEMELB_MPI_CALL(MPI_Type_free, (&siteType));
+  file.SetView(0, MPI_BYTE, MPI_BYTE, "native", MPI_INFO_NULL);
+
+  std::vector<hemelb::distribn_t> localDistributions(distributions.size());
+  for (size_t index = 0; index < sites.size(); ++index)
+  {
+    std::copy(distributions.begin() + index * numVectors,
+              distributions.begin() + (index + 1) * numVectors,
+              localDistributions.begin() + sites[index].second * numVectors);
+  }
+  latticeData.SetLocalDistributions(localDistributions);
+
+  // There are few enough particles for every rank to read them all, and keep those it owns.
+  std::vector<hemelb::colloids::Particle> particles(totalParticles);
+  hemelb::colloids::Particle* particleData = particles.empty() ?
+    NULL :
+    &particles[0];
+  HEMELB_MPI_CALL(MPI_File_read_at_all,
+                  (file, particlesStart, particleData, particles.size(),
+                      hemelb::net::MpiDataType<hemelb::colloids::PersistedParticle>(), MPI_STATUS_IGNORE));
+  file.Close();
+
+  if (colloidController != NULL)
+  {
+    colloidController->GetParticleSet().RestoreParticles(particles);
+  }
+  else if (totalParticles > 0)
+  {
+    hemelb::log::Logger::Log<hemelb::log::Warning, hemelb::log::Singleton>("Ignoring the %lu colloid particles in %s, as the simulation has no colloids",
+                                                                           (unsigned long) totalParticles,
+                                                                           path.c_str());
+  }
+
+  simulationState.SetTimeStep(timeStep + 1);
+  hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Restarted from %s, written by %lu ranks at time step %lu",
+                                                                      path.c_str(),
+                                                                      (unsigned long) writers,
+                                                                      (unsigned long) timeStep);
+}
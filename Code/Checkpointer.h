@@ -0,0 +1,148 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_CHECKPOINTER_H
+#define HEMELB_CHECKPOINTER_H
+#include <string>
+#include <utility>
+#include <vector>
+#include "net/IOCommunicator.h"
+#include "net/MpiFile.h"
+#include "geometry/LatticeData.h"
+#include "lb/SimulationState.h"
+#include "colloids/ColloidController.h"
+#include "reporting/Timers.h"
+
+/**
+ * Saves the state of a simulation to a file, and restores it, so that a run can be resumed from
+ * where it was stopped, e.g. by the end of its allocation in a queue.
+ *
+ * The state is the distributions of the fluid sites, the time step and the colloid particles.
+ * Nothing else is saved, so SimulationMaster refuses to checkpoint or restart a simulation that
+ * keeps other state between time steps: a kernel that keeps data for each site (e.g. the tau of
+ * LBGKNN or the alpha of the entropic kernels, see LBM::CanRebuild) or a stateful iolet, such as
+ * a multiscale one (see InOutLet::IsStateful). The other iolets' conditions are functions of the
+ * time step alone, so they come back with it.
+ *
+ * The file is in the format of io/formats/checkpoint.h, and all ranks write and read it
+ * together. The sites are stored in the order of the geometry, so a run can be restarted on a
+ * different number of ranks.
+ *
+ * Checkpoints are written in the background: the state is copied when one is started, and
+ * written with nonblocking MPI-IO as the simulation goes on, until it is finished. Only one is
+ * written at a time.
+ */
+class Checkpointer
+{
+  public:
+    /**
+     * @param ioComms
+     * @param latticeData
+     * @param simulationState
+     * @param colloidController The colloids, or NULL if there are none
+     * @param timings
+     */
+    Checkpointer(const hemelb::net::IOCommunicator& ioComms, hemelb::geometry::LatticeData& latticeData,
+                 hemelb::lb::SimulationState& simulationState,
+                 hemelb::colloids::ColloidController* colloidController, hemelb::reporting::Timers& timings);
+
+    /**
+     * Finishes any checkpoint still being written. Collective.
+     */
+    ~Checkpointer();
+
+    /**
+     * Take the state at the end of the current time step, which must be one after which the
+     * lattice could be rebuilt, and start writing it in the background, once any checkpoint
+     * already being written is finished. Collective.
+     * @param path
+     */
+    void Start(const std::string& path);
+
+    /**
+     * Whether a checkpoint is being written.
+     */
+    bool IsWriting() const;
+
+    /**
+     * Whether every rank has written its part of the checkpoint, so that it can be finished
+     * without waiting. Collective.
+     */
+    bool IsWritten();
+
+    /**
+     * Wait for the checkpoint being written, if any, and put it in place. Collective.
+     */
+    void Finish();
+
+    /**
+     * Write the state at the end of the current time step, and wait for it to be written.
+     * Collective.
+     * @param path
+     */
+    void Write(const std::string& path);
+
+    /**
+     * Restore the state from a file, and move the simulation on to the time step after the one
+     * it was written at. Collective.
+     * @param path
+     */
+    void Read(const std::string& path);
+
+    /**
+     * Have SIGTERM ask for a checkpoint and an orderly end to the run, rather than end the
+     * process.
+     */
+    static void CatchTerminationSignal();
+
+    /**
+     * Whether any rank has been sent SIGTERM. Collective.
+     */
+    bool IsTerminationRequested() const;
+
+    /** The number of time steps between checks for SIGTERM, which need all ranks to agree */
+    static const hemelb::LatticeTimeStep SIGNAL_CHECK_PERIOD = 10;
+
+  private:
+    /**
+     * The length of the record of a colloid particle in the file.
+     */
+    static MPI_Offset GetParticleRecordLength();
+
+    /**
+     * Find where each local fluid site comes among all the fluid sites in the order of the
+     * geometry file, which is the order they are in the checkpoint. Collective.
+     * @param sites The position in that order and the local index of each local fluid site,
+     * sorted by position
+     */
+    void GetSitesInGeometryOrder(std::vector<std::pair<hemelb::site_t, hemelb::site_t> >& sites) const;
+
+    /**
+     * Set the view of the file to the distributions of the given sites, one site at a time.
+     * Collective.
+     * @param file
+     * @param sites As from GetSitesInGeometryOrder
+     * @return The datatype of one site's distributions, for the caller to free
+     */
+    MPI_Datatype SetSitesView(hemelb::net::MpiFile& file,
+                              const std::vector<std::pair<hemelb::site_t, hemelb::site_t> >& sites) const;
+
+    const hemelb::net::IOCommunicator& ioComms;
+    hemelb::geometry::LatticeData& latticeData;
+    hemelb::lb::SimulationState& simulationState;
+    hemelb::colloids::ColloidController* colloidController;
+    hemelb::reporting::Timers& timings;
+
+    /* The checkpoint being written, if any */
+    std::string writePath; //! Where it goes once written, or empty if none is being written
+    hemelb::LatticeTimeStep writeTimeStep; //! The time step it was taken at
+    hemelb::net::MpiFile writeFile; //! The temporary file it is being written to
+    std::vector<hemelb::distribn_t> writeDistributions; //! The distributions being written, in the file's order
+    MPI_Datatype writeSiteType; //! The type of one site's distributions
+    MPI_Request writeRequest; //! The write of the distributions
+};
+
+#endif /* HEMELB_CHECKPOINTER_H */
@@ -6,12 +6,14 @@
 
 #include "SimulationMaster.h"
 #include "configuration/SimConfig.h"
+#include "Exception.h"
 #include "extraction/PropertyActor.h"
 #include "extraction/LbDataSourceIterator.h"
 #include "io/writers/xdr/XdrFileWriter.h"
 #include "util/utilityFunctions.h"
 #include "geometry/GeometryReader.h"
 #include "geometry/LatticeData.h"
+#include "geometry/SiteRendezvous.h"
 #include "util/fileutils.h"
 #include "log/Logger.h"
 #include "lb/HFunction.h"
@@ -19,6 +21,7 @@
 #include "colloids/ColloidController.h"
 #include "net/BuildInfo.h"
 #include "net/IOCommunicator.h"
+#include "net/MpiEnvironment.h"
 #include "colloids/BodyForces.h"
 #include "colloids/BoundaryConditions.h"
 
@@ -48,9 +51,21 @@ SimulationMaster::SimulationMaster(hemelb::configuration::CommandLine & options,
   simulationState = NULL;
   stepManager = NULL;
   netConcern = NULL;
+  tracer = NULL;
+  loadBalancer = NULL;
+  checkpointer = NULL;
+  checkpointPending = false;
+  terminateAfterCheckpoint = false;
   neighbouringDataManager = NULL;
   imagesPerSimulation = options.NumberOfImages();
   steeringSessionId = options.GetSteeringSessionId();
+  threadCount = options.GetThreadCount();
+  if (threadCount != 1 && !hemelb::net::MpiEnvironment::IsFunnelledThreadingSupported())
+  {
+    hemelb::log::Logger::Log<hemelb::log::Warning, hemelb::log::Singleton>("The MPI library doesn't support MPI_THREAD_FUNNELED, so ignoring -threads and running the LB update on one thread");
+    threadCount = 1;
+  }
+  restartFile = options.GetRestartFile();
 
   fileManager = new hemelb::io::PathManager(options, IsCurrentProcTheIOProc(), GetProcessorCount());
   simConfig = hemelb::configuration::SimConfig::New(fileManager->GetInputFile());
@@ -71,6 +86,7 @@ SimulationMaster::SimulationMaster(hemelb::configuration::CommandLine & options,
     reporter->AddReportable(&timings);
     reporter->AddReportable(latticeData);
     reporter->AddReportable(simulationState);
+    reporter->AddReportable(&communicationNet);
   }
 }
 
@@ -110,6 +126,9 @@ SimulationMaster::~SimulationMaster()
   }
   delete stepManager;
   delete netConcern;
+  delete tracer;
+  delete loadBalancer;
+  delete checkpointer;
 }
 
 /**
@@ -147,9 +166,21 @@ void SimulationMaster::Initialise()
   // Use a reader to read in the file.
   hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Loading file and decomposing geometry.");
 
+  const hemelb::configuration::SimConfig::DecompositionConfig* decompositionConfig =
+      simConfig->GetDecompositionConfiguration();
+  if (!decompositionConfig->siteWeightsPath.empty())
+  {
+    siteWeights = hemelb::geometry::decomposition::SiteWeights::Read(decompositionConfig->siteWeightsPath);
+    hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Using site weights from %s",
+                                                                        decompositionConfig->siteWeightsPath.c_str());
+  }
+
   hemelb::geometry::GeometryReader reader(hemelb::steering::SteeringComponent::RequiresSeparateSteeringCore(),
                                           latticeType::GetLatticeInfo(),
                                           timings, ioComms);
+  reader.SetSiteWeights(siteWeights);
+  reader.SetPartitioner(GetPartitioner());
+  reader.SetDecompositionCache(decompositionConfig->cacheDirectory);
   hemelb::geometry::Geometry readGeometryData =
       reader.LoadAndDecompose(simConfig->GetDataFilePath());
 
@@ -158,6 +189,23 @@ void SimulationMaster::Initialise()
 
   timings[hemelb::reporting::Timers::latDatInitialise].Stop();
 
+  // Use the communication implementations the config file asks for, if any.
+  const hemelb::configuration::SimConfig::CommunicationsConfig* communicationsConfig =
+      simConfig->GetCommunicationsConfiguration();
+  if (!communicationsConfig->gathers.empty())
+  {
+    communicationNet.SelectGathers(communicationsConfig->gathers);
+  }
+  if (!communicationsConfig->allToAll.empty())
+  {
+    communicationNet.SelectAllToAll(communicationsConfig->allToAll);
+  }
+  if (!communicationsConfig->pointPoint.empty() && communicationsConfig->pointPoint != "auto")
+  {
+    communicationNet.SelectPointPoint(communicationsConfig->pointPoint);
+  }
+  communicationNet.SetNeighbourhood(latticeData->GetNeighbouringRanks());
+
   neighbouringDataManager =
       new hemelb::geometry::neighbouring::NeighbouringDataManager(*latticeData,
                                                                   latticeData->GetNeighbouringData(),
@@ -168,7 +216,8 @@ void SimulationMaster::Initialise()
                                                            latticeData,
                                                            simulationState,
                                                            timings,
-                                                           neighbouringDataManager);
+                                                           neighbouringDataManager,
+                                                           threadCount);
 
   hemelb::lb::MacroscopicPropertyCache& propertyCache = latticeBoltzmannModel->GetPropertyCache();
 
@@ -212,6 +261,7 @@ void SimulationMaster::Initialise()
   stabilityTester = new hemelb::lb::StabilityTester<latticeType>(latticeData,
                                                                  &communicationNet,
                                                                  simulationState,
+                                                                 latticeBoltzmannModel->GetPropertyCache(),
                                                                  timings,
                                                                  monitoringConfig);
   entropyTester = NULL;
@@ -305,10 +355,83 @@ void SimulationMaster::Initialise()
 
   imagesPeriod = OutputPeriod(imagesPerSimulation);
 
+  netConcern = new hemelb::net::phased::NetConcern(communicationNet);
+  if (monitoringConfig->doTimeline)
+  {
+    tracer = new hemelb::net::phased::Tracer(ioComms,
+                                             fileManager->GetTimelinePath(),
+                                             monitoringConfig->timelineFirstStep,
+                                             monitoringConfig->timelineSteps,
+                                             monitoringConfig->timelineEvents);
+  }
+  RegisterActors();
+
+  const hemelb::configuration::SimConfig::CheckpointConfig* checkpointConfig =
+      simConfig->GetCheckpointConfiguration();
+  if (checkpointConfig->doCheckpoint || !restartFile.empty())
+  {
+    // A checkpoint holds only the distributions, the time step and the colloids, so refuse to
+    // write or restart from one for anything that keeps other state between time steps.
+    if (!latticeBoltzmannModel->CanRebuild())
+    {
+      throw hemelb::Exception() << "Can't checkpoint or restart with the " << hemelb::reporting::kernel_type
+          << " kernel, which keeps data for each site between time steps";
+    }
+    const std::vector<hemelb::lb::iolets::InOutLet*>* iolets[] = { &simConfig->GetInlets(), &simConfig->GetOutlets() };
+    for (unsigned ioletType = 0; ioletType < 2; ++ioletType)
+    {
+      for (size_t iolet = 0; iolet < iolets[ioletType]->size(); ++iolet)
+      {
+        if ( (*iolets[ioletType])[iolet]->IsStateful())
+        {
+          throw hemelb::Exception() << "Can't checkpoint or restart with an iolet, such as a multiscale one, "
+              << "whose condition isn't a function of the time step alone";
+        }
+      }
+    }
+    checkpointer = new Checkpointer(ioComms, *latticeData, *simulationState, colloidController, timings);
+    if (!restartFile.empty())
+    {
+      checkpointer->Read(restartFile);
+    }
+    if (checkpointConfig->doCheckpoint)
+    {
+      Checkpointer::CatchTerminationSignal();
+    }
+  }
+
+  if (decompositionConfig->doRebalance)
+  {
+    // Only the distributions move with the sites to their new ranks, so refuse to rebalance
+    // anything that keeps other state for the sites it holds.
+    if (colloidController != NULL)
+    {
+      throw hemelb::Exception() << "Can't rebalance the decomposition of a simulation with colloids";
+    }
+    if (!latticeBoltzmannModel->CanRebuild())
+    {
+      throw hemelb::Exception() << "Can't rebalance the decomposition with the "
+          << hemelb::reporting::kernel_type << " kernel, which keeps data for each site between time steps";
+    }
+    loadBalancer = new hemelb::geometry::decomposition::LoadBalancer(ioComms,
+                                                                     timings,
+                                                                     decompositionConfig->rebalanceThreshold,
+                                                                     siteWeights);
+  }
+
+  // Tune the point-to-point implementation over the first time steps, which exchange the same
+  // data as all the rest.
+  if (communicationsConfig->pointPoint == "auto")
+  {
+    communicationNet.AutoTunePointPoint(communicationsConfig->autoTuneExchanges);
+  }
+}
+
+void SimulationMaster::RegisterActors()
+{
   stepManager = new hemelb::net::phased::StepManager(2,
                                                      &timings,
                                                      hemelb::net::separate_communications);
-  netConcern = new hemelb::net::phased::NetConcern(communicationNet);
   stepManager->RegisterIteratedActorSteps(*neighbouringDataManager, 0);
   if (colloidController != NULL)
   {
@@ -340,6 +463,100 @@ void SimulationMaster::Initialise()
     stepManager->RegisterIteratedActorSteps(*network, 1);
   }
   stepManager->RegisterCommsForAllPhases(*netConcern);
+
+  if (tracer != NULL)
+  {
+    stepManager->SetTracer(tracer);
+  }
+}
+
+void SimulationMaster::Rebalance()
+{
+  timings[hemelb::reporting::Timers::rebalance].Start();
+  const double imbalanceBefore = loadBalancer->GetImbalance();
+
+  std::vector<float> blockCostFactors;
+  loadBalancer->CalculateBlockCostFactors(*latticeData, blockCostFactors);
+
+  // Leave the distributions with ranks fixed by the sites' ids while the sites move.
+  const hemelb::util::Vector3D<hemelb::site_t>& siteDimensions = latticeData->GetSiteDimensions();
+  hemelb::geometry::SiteRendezvous rendezvous(ioComms,
+                                              siteDimensions.x * siteDimensions.y * siteDimensions.z,
+                                              latticeType::NUMVECTORS);
+  std::vector<hemelb::site_t> siteIds(latticeData->GetLocalFluidSiteCount());
+  for (hemelb::site_t site = 0; site < latticeData->GetLocalFluidSiteCount(); ++site)
+  {
+    siteIds[site] =
+        latticeData->GetGlobalNoncontiguousSiteIdFromGlobalCoords(latticeData->GetSite(site).GetGlobalSiteCoords());
+  }
+  std::vector<hemelb::distribn_t> distributions;
+  latticeData->GetLocalDistributions(distributions);
+  rendezvous.Deposit(siteIds, distributions);
+
+  hemelb::geometry::GeometryReader reader(hemelb::steering::SteeringComponent::RequiresSeparateSteeringCore(),
+                                          latticeType::GetLatticeInfo(),
+                                          timings, ioComms);
+  reader.SetSiteWeights(siteWeights);
+  reader.SetPartitioner(GetPartitioner());
+  reader.SetBlockCostFactors(blockCostFactors);
+  hemelb::geometry::Geometry readGeometryData = reader.LoadAndDecompose(simConfig->GetDataFilePath());
+  latticeData->Rebuild(readGeometryData);
+  communicationNet.SetNeighbourhood(latticeData->GetNeighbouringRanks());
+
+  // These all hold on to parts of the old lattice, so make them afresh.
+  delete neighbouringDataManager;
+  neighbouringDataManager =
+      new hemelb::geometry::neighbouring::NeighbouringDataManager(*latticeData,
+                                                                  latticeData->GetNeighbouringData(),
+                                                                  communicationNet);
+  delete inletValues;
+  inletValues = new hemelb::lb::iolets::BoundaryValues(hemelb::geometry::INLET_TYPE,
+                                                       latticeData,
+                                                       simConfig->GetInlets(),
+                                                       simulationState,
+                                                       ioComms,
+                                                       *unitConverter);
+  delete outletValues;
+  outletValues = new hemelb::lb::iolets::BoundaryValues(hemelb::geometry::OUTLET_TYPE,
+                                                        latticeData,
+                                                        simConfig->GetOutlets(),
+                                                        simulationState,
+                                                        ioComms,
+                                                        *unitConverter);
+  latticeBoltzmannModel->Rebuild(inletValues, outletValues, neighbouringDataManager);
+  neighbouringDataManager->ShareNeeds();
+  neighbouringDataManager->TransferNonFieldDependentInformation();
+
+  siteIds.resize(latticeData->GetLocalFluidSiteCount());
+  for (hemelb::site_t site = 0; site < latticeData->GetLocalFluidSiteCount(); ++site)
+  {
+    siteIds[site] =
+        latticeData->GetGlobalNoncontiguousSiteIdFromGlobalCoords(latticeData->GetSite(site).GetGlobalSiteCoords());
+  }
+  rendezvous.Collect(siteIds, distributions);
+  latticeData->SetLocalDistributions(distributions);
+
+  visualisationControl->Rebuild();
+  if (propertyExtractor != NULL)
+  {
+    propertyExtractor->Rebuild();
+  }
+
+  delete stepManager;
+  RegisterActors();
+
+  loadBalancer->Restart();
+  timings[hemelb::reporting::Timers::rebalance].Stop();
+  hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("time step %i, redecomposed the domain, as the slowest rank took %.2f times the mean LB time",
+                                                                      simulationState->GetTimeStep(),
+                                                                      imbalanceBefore);
+}
+
+hemelb::geometry::decomposition::Partitioner SimulationMaster::GetPartitioner() const
+{
+  return simConfig->GetDecompositionConfiguration()->partitioner == "hilbert" ?
+    hemelb::geometry::decomposition::HILBERT_PARTITIONER :
+    hemelb::geometry::decomposition::PARMETIS_PARTITIONER;
 }
 
 unsigned int SimulationMaster::OutputPeriod(unsigned int frequency)
@@ -461,6 +678,15 @@ void SimulationMaster::RunSimulation()
 
 void SimulationMaster::Finalise()
 {
+  if (checkpointer != NULL)
+  {
+    checkpointer->Finish();
+  }
+  // The run may have stopped before the end of the timeline's window.
+  if (tracer != NULL)
+  {
+    tracer->Finish();
+  }
   timings[hemelb::reporting::Timers::total].Stop();
   timings.Reduce();
   if (IsCurrentProcTheIOProc())
@@ -566,6 +792,58 @@ void SimulationMaster::DoTimeStep()
     GenerateNetworkImages();
   }
 
+  // The lattice can only be rebuilt between whole exchanges of the halo, with no images left
+  // to finish, which every rank must agree on.
+  if (loadBalancer != NULL
+      && simulationState->GetTimeStep() % simConfig->GetDecompositionConfiguration()->rebalanceInterval == 0)
+  {
+    int ready = latticeData->IsRebuildable() && writtenImagesCompleted.empty()
+        && networkImagesCompleted.empty();
+    if (ioComms.AllReduce(ready, MPI_MIN) && loadBalancer->Measure(*latticeData))
+    {
+      Rebalance();
+    }
+  }
+
+  const hemelb::configuration::SimConfig::CheckpointConfig* checkpointConfig =
+      simConfig->GetCheckpointConfiguration();
+  if (checkpointConfig->doCheckpoint)
+  {
+    // Look for SIGTERM, and whether the checkpoint being written has been, only now and then,
+    // as all ranks must agree on them.
+    if (simulationState->GetTimeStep() % Checkpointer::SIGNAL_CHECK_PERIOD == 0)
+    {
+      if (checkpointer->IsTerminationRequested())
+      {
+        hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Received SIGTERM, so ending the run after a checkpoint");
+        checkpointPending = true;
+        terminateAfterCheckpoint = true;
+      }
+      if (checkpointer->IsWriting() && checkpointer->IsWritten())
+      {
+        checkpointer->Finish();
+      }
+    }
+    if (checkpointConfig->interval != 0 && simulationState->GetTimeStep() % checkpointConfig->interval == 0)
+    {
+      checkpointPending = true;
+    }
+    // Like rebalancing, a checkpoint can only be taken after whole exchanges of the halo.
+    if (checkpointPending && latticeData->IsRebuildable())
+    {
+      checkpointPending = false;
+      if (terminateAfterCheckpoint)
+      {
+        checkpointer->Write(fileManager->GetCheckpointPath());
+        simulationState->SetIsTerminating(true);
+      }
+      else
+      {
+        checkpointer->Start(fileManager->GetCheckpointPath());
+      }
+    }
+  }
+
   if (simulationState->GetTimeStep() % FORCE_FLUSH_PERIOD == 0 && IsCurrentProcTheIOProc())
   {
     fflush(NULL);
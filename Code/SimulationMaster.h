@@ -26,6 +26,8 @@
 #include "net/phased/StepManager.h"
 #include "net/phased/NetConcern.h"
 #include "geometry/neighbouring/NeighbouringDataManager.h"
+#include "geometry/decomposition/LoadBalancer.h"
+#include "Checkpointer.h"
 
 class SimulationMaster
 {
@@ -60,6 +62,20 @@ class SimulationMaster
 
   private:
     void Initialise();
+    /**
+     * Create the step manager and register all the actors with it.
+     */
+    void RegisterActors();
+    /**
+     * Redecompose the domain with weights adjusted by the measured load, and move the
+     * distributions and everything set up for the old decomposition over to the new one.
+     * Collective.
+     */
+    void Rebalance();
+    /**
+     * The way to split the sites between the ranks that the config file asks for.
+     */
+    hemelb::geometry::decomposition::Partitioner GetPartitioner() const;
     void SetupReporting(); // set up the reporting file
     unsigned int OutputPeriod(unsigned int frequency);
     void HandleActors();
@@ -111,9 +127,23 @@ class SimulationMaster
 
     hemelb::net::phased::StepManager* stepManager;
     hemelb::net::phased::NetConcern* netConcern;
+    hemelb::net::phased::Tracer* tracer;
+    /** Null unless the decomposition is to be rebalanced during the run */
+    hemelb::geometry::decomposition::LoadBalancer* loadBalancer;
+    /** The weight the decomposition gives a site of each collision type */
+    hemelb::geometry::decomposition::SiteWeights siteWeights;
+    /** Null unless the run is checkpointed or restarted */
+    Checkpointer* checkpointer;
+    /** The checkpoint file to restart from, or empty */
+    std::string restartFile;
+    /** Whether a checkpoint is due, but waiting for a time step after which it can be taken */
+    bool checkpointPending;
+    /** Whether to end the run once the pending checkpoint is written */
+    bool terminateAfterCheckpoint;
 
     unsigned int imagesPerSimulation;
     int steeringSessionId;
+    unsigned int threadCount;
     unsigned int imagesPeriod;
     static const hemelb::LatticeTimeStep FORCE_FLUSH_PERIOD=1000;
 };
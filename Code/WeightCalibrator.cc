@@ -0,0 +1,204 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <cmath>
+#include <algorithm>
+#include "WeightCalibrator.h"
+#include "geometry/LatticeData.h"
+#include "log/Logger.h"
+#include "Exception.h"
+
+const double WeightCalibrator::MAX_SPREAD = 0.15;
+
+WeightCalibrator::WeightCalibrator(const hemelb::configuration::CommandLine &options,
+                                   const hemelb::net::IOCommunicator& ioComm) :
+    ioComms(ioComm), selfComms(ioComm.Split(ioComm.Rank())), weightsPath(options.GetCalibrationFile()),
+        timings(selfComms), communicationNet(selfComms)
+{
+  simConfig = hemelb::configuration::SimConfig::New(options.GetInputFile());
+  if (simConfig->GetInlets().empty() || simConfig->GetOutlets().empty())
+  {
+    throw hemelb::Exception() << "Calibrating needs a config file with at least one inlet and one outlet";
+  }
+
+  simulationState = new hemelb::lb::SimulationState(simConfig->GetTimeStepLength(),
+                                                    simConfig->GetTotalTimeSteps());
+
+  const hemelb::geometry::Geometry channel = MakeChannel();
+  latticeData = new hemelb::geometry::LatticeData(latticeType::GetLatticeInfo(), channel, selfComms);
+  communicationNet.SetNeighbourhood(latticeData->GetNeighbouringRanks());
+
+  neighbouringDataManager =
+      new hemelb::geometry::neighbouring::NeighbouringDataManager(*latticeData,
+                                                                  latticeData->GetNeighbouringData(),
+                                                                  communicationNet);
+  latticeBoltzmannModel = new hemelb::lb::LBM<latticeType>(simConfig,
+                                                           &communicationNet,
+                                                           latticeData,
+                                                           simulationState,
+                                                           timings,
+                                                           neighbouringDataManager,
+                                                           1);
+  inletValues = new hemelb::lb::iolets::BoundaryValues(hemelb::geometry::INLET_TYPE,
+                                                       latticeData,
+                                                       simConfig->GetInlets(),
+                                                       simulationState,
+                                                       selfComms,
+                                                       simConfig->GetUnitConverter());
+  outletValues = new hemelb::lb::iolets::BoundaryValues(hemelb::geometry::OUTLET_TYPE,
+                                                        latticeData,
+                                                        simConfig->GetOutlets(),
+                                                        simulationState,
+                                                        selfComms,
+                                                        simConfig->GetUnitConverter());
+  // Nothing is drawn, so there is no visualisation.
+  latticeBoltzmannModel->Initialise(NULL, inletValues, outletValues, &simConfig->GetUnitConverter());
+}
+
+WeightCalibrator::~WeightCalibrator()
+{
+  delete latticeBoltzmannModel;
+  delete inletValues;
+  delete outletValues;
+  delete neighbouringDataManager;
+  delete latticeData;
+  delete simulationState;
+  delete simConfig;
+}
+
+bool WeightCalibrator::IsInChannel(const hemelb::util::Vector3D<hemelb::site_t>& location)
+{
+  return location.x > 0 && location.y > 0 && location.z > 0 && location.x < CHANNEL_BLOCK_SIZE - 1
+      && location.y < CHANNEL_BLOCK_SIZE - 1 && location.z < CHANNEL_BLOCK_SIZE - 1
+      && location.x % CHANNEL_PITCH != 0 && location.y % CHANNEL_PITCH != 0;
+}
+
+hemelb::geometry::GeometrySite WeightCalibrator::MakeChannelSite(const hemelb::util::Vector3D<hemelb::site_t>& location)
+{
+  if (!IsInChannel(location))
+  {
+    return hemelb::geometry::GeometrySite(false);
+  }
+
+  hemelb::geometry::GeometrySite site(true);
+  site.targetProcessor = 0;
+
+  // The channels run along z, from the inlet below the first layer of sites to the outlet above
+  // the last, and each is walled in on the other four sides. Every boundary is half way between
+  // sites.
+  const hemelb::lb::lattices::LatticeInfo& latticeInfo = latticeType::GetLatticeInfo();
+  site.links.resize(latticeInfo.GetNumVectors() - 1);
+  hemelb::util::Vector3D<float> wallward = hemelb::util::Vector3D<float>::Zero();
+  for (hemelb::Direction direction = 1; direction < latticeInfo.GetNumVectors(); ++direction)
+  {
+    const hemelb::util::Vector3D<int>& vector = latticeInfo.GetVector(direction);
+    const hemelb::util::Vector3D<hemelb::site_t> neighbour = location
+        + hemelb::util::Vector3D<hemelb::site_t>(vector);
+    if (IsInChannel(neighbour))
+    {
+      continue;
+    }
+
+    hemelb::geometry::GeometrySiteLink& link = site.links[direction - 1];
+    link.distanceToIntersection = 0.5;
+    if (neighbour.z == 0)
+    {
+      link.type = hemelb::geometry::GeometrySiteLink::INLET_INTERSECTION;
+      link.ioletId = 0;
+    }
+    else if (neighbour.z == CHANNEL_BLOCK_SIZE - 1)
+    {
+      link.type = hemelb::geometry::GeometrySiteLink::OUTLET_INTERSECTION;
+      link.ioletId = 0;
+    }
+    else
+    {
+      link.type = hemelb::geometry::GeometrySiteLink::WALL_INTERSECTION;
+      wallward += hemelb::util::Vector3D<float>(vector);
+    }
+  }
+
+  // As in geometry files, the sites next to walls have the wall normal, pointing out of the fluid.
+  if (wallward.GetMagnitudeSquared() > 0)
+  {
+    site.wallNormalAvailable = true;
+    site.wallNormal = wallward.GetNormalised();
+  }
+  return site;
+}
+
+hemelb::geometry::Geometry WeightCalibrator::MakeChannel()
+{
+  hemelb::geometry::Geometry channel(hemelb::util::Vector3D<hemelb::site_t>::Ones(), CHANNEL_BLOCK_SIZE);
+  // In the order the geometry reader reads the sites of a block in.
+  hemelb::util::Vector3D<hemelb::site_t> location;
+  for (location.x = 0; location.x < CHANNEL_BLOCK_SIZE; ++location.x)
+  {
+    for (location.y = 0; location.y < CHANNEL_BLOCK_SIZE; ++location.y)
+    {
+      for (location.z = 0; location.z < CHANNEL_BLOCK_SIZE; ++location.z)
+      {
+        channel.Blocks[0].Sites.push_back(MakeChannelSite(location));
+      }
+    }
+  }
+  return channel;
+}
+
+void WeightCalibrator::Run()
+{
+  hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Timing the collision types.");
+
+  // Each type's time relative to a bulk site's, on each repeat. Anything else running slows all
+  // the types on a repeat alike, so these vary less than the times themselves.
+  std::vector<std::vector<double> > relativeSeconds(hemelb::COLLISION_TYPES);
+  std::vector<double> bulkSeconds;
+  for (unsigned repeat = 0; repeat < REPEATS; ++repeat)
+  {
+    std::vector<double> secondsPerSite;
+    latticeBoltzmannModel->TimeCollisionTypes(ROUNDS, secondsPerSite);
+    // Average over the ranks, in case they differ.
+    secondsPerSite = ioComms.AllReduce(secondsPerSite, MPI_SUM);
+
+    bulkSeconds.push_back(secondsPerSite[0] / ioComms.Size());
+    for (unsigned collisionType = 0; collisionType < hemelb::COLLISION_TYPES; ++collisionType)
+    {
+      relativeSeconds[collisionType].push_back(secondsPerSite[collisionType] / secondsPerSite[0]);
+    }
+  }
+  std::sort(bulkSeconds.begin(), bulkSeconds.end());
+
+  hemelb::geometry::decomposition::SiteWeights weights;
+  for (unsigned collisionType = 0; collisionType < hemelb::COLLISION_TYPES; ++collisionType)
+  {
+    std::vector<double>& relative = relativeSeconds[collisionType];
+    std::sort(relative.begin(), relative.end());
+    const double median = relative[relative.size() / 2];
+    const double spread = (relative.back() - relative.front()) / median;
+    if (!(spread <= MAX_SPREAD))
+    {
+      throw hemelb::Exception() << "The timings of "
+          << hemelb::geometry::decomposition::SiteWeights::GetCollisionTypeName(collisionType)
+          << " sites varied between " << relative.front() << " and " << relative.back()
+          << " times a bulk site's, too much to trust, so the weights have not been written."
+          << " Calibrate again with less else running on the machine.";
+    }
+
+    const int weight = (int) std::floor(BULK_WEIGHT * median + 0.5);
+    weights.Set(collisionType, std::max(1, weight));
+    hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("%s sites: %.3g us per update, weight %i",
+                                                                        hemelb::geometry::decomposition::SiteWeights::GetCollisionTypeName(collisionType),
+                                                                        1e6 * median
+                                                                            * bulkSeconds[bulkSeconds.size() / 2],
+                                                                        weights[collisionType]);
+  }
+
+  if (ioComms.OnIORank())
+  {
+    weights.Write(weightsPath);
+  }
+  hemelb::log::Logger::Log<hemelb::log::Info, hemelb::log::Singleton>("Wrote site weights to %s", weightsPath.c_str());
+}
@@ -0,0 +1,95 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_WEIGHTCALIBRATOR_H
+#define HEMELB_WEIGHTCALIBRATOR_H
+#include "lb/lattices/Lattices.h"
+#include "lb/lb.hpp"
+#include "net/net.h"
+#include "net/IOCommunicator.h"
+#include "lb/iolets/BoundaryValues.h"
+#include "configuration/CommandLine.h"
+#include "configuration/SimConfig.h"
+#include "reporting/Timers.h"
+#include "geometry/Geometry.h"
+#include "geometry/neighbouring/NeighbouringDataManager.h"
+#include "geometry/decomposition/SiteWeights.h"
+
+/**
+ * Works out the decomposition weights for this build and machine, by timing the stream-and-
+ * collide of a site of each collision type, and writes them to a file for the decomposition to
+ * read.
+ *
+ * Each rank times its own copy of a block filled with parallel channels of square cross-section,
+ * with the inlets at one end and the outlets at the other, which has plenty of sites of all six
+ * types. The iolets and LB parameters are those of the config file, so that the boundary
+ * conditions are timed as they will run.
+ */
+class WeightCalibrator
+{
+  public:
+    WeightCalibrator(const hemelb::configuration::CommandLine &options, const hemelb::net::IOCommunicator& ioComms);
+    ~WeightCalibrator();
+
+    /**
+     * Time the collision types, averaged over the ranks, and write the weights to the file
+     * given on the command line. Collective. Throws without writing the file if the timings
+     * vary too much between repeats to be trusted.
+     */
+    void Run();
+
+  private:
+    typedef hemelb::lb::lattices:: HEMELB_LATTICE latticeType;
+
+    /**
+     * Make the geometry of the channels, all of it on this rank.
+     */
+    static hemelb::geometry::Geometry MakeChannel();
+
+    /**
+     * Make one site of the channels.
+     * @param location The site's coordinates
+     */
+    static hemelb::geometry::GeometrySite MakeChannelSite(const hemelb::util::Vector3D<hemelb::site_t>& location);
+
+    /**
+     * @param location
+     * @return Whether the site at location is inside one of the channels
+     */
+    static bool IsInChannel(const hemelb::util::Vector3D<hemelb::site_t>& location);
+
+    /** The side of the block holding the channels, which is a whole number of channel pitches and a solid site */
+    static const hemelb::site_t CHANNEL_BLOCK_SIZE = 43;
+    /** The distance between the channels, each of which is a solid site and the width of a channel */
+    static const hemelb::site_t CHANNEL_PITCH = 7;
+    /** The number of updates of the channels to time in each repeat, of which the median counts */
+    static const unsigned ROUNDS = 20;
+    /** The number of times to repeat the timings, of which the median counts */
+    static const unsigned REPEATS = 5;
+    /**
+     * The largest spread of each collision type's time relative to a bulk site over the
+     * repeats, as the range over the median, to accept
+     */
+    static const double MAX_SPREAD;
+    /** The weight to give a bulk site, which sets how finely the others can differ from it */
+    static const int BULK_WEIGHT = 10;
+
+    const hemelb::net::IOCommunicator& ioComms;
+    /** This rank on its own, to simulate the channel */
+    hemelb::net::IOCommunicator selfComms;
+    std::string weightsPath;
+    hemelb::configuration::SimConfig* simConfig;
+    hemelb::reporting::Timers timings;
+    hemelb::net::Net communicationNet;
+    hemelb::lb::SimulationState* simulationState;
+    hemelb::geometry::LatticeData* latticeData;
+    hemelb::geometry::neighbouring::NeighbouringDataManager* neighbouringDataManager;
+    hemelb::lb::iolets::BoundaryValues* inletValues;
+    hemelb::lb::iolets::BoundaryValues* outletValues;
+    hemelb::lb::LBM<latticeType>* latticeBoltzmannModel;
+};
+
+#endif /* HEMELB_WEIGHTCALIBRATOR_H */
@@ -27,6 +27,9 @@ if(HEMELB_BUILD_MULTISCALE)
   add_definitions(-DHEMELB_BUILD_MULTISCALE)
 endif()
 
+#------Threads ----------------
+find_package(Threads REQUIRED)
+
 #------zlib ----------------
 find_package(ZLIB REQUIRED)
 include_directories(${ZLIB_INCLUDE_DIR})
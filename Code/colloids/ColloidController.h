@@ -48,6 +48,12 @@ namespace hemelb
 
         const void OutputInformation(const LatticeTimeStep timestep) const;
 
+        /** the set of Particles that this processor knows about, e.g. to checkpoint them */
+        ParticleSet& GetParticleSet()
+        {
+          return *particleSet;
+        }
+
       private:
         /** Main code communicator */
         const net::IOCommunicator& ioComms;
@@ -35,6 +35,19 @@ namespace hemelb
           globalPosition.x, globalPosition.y, globalPosition.z);
     }
 
+    const void Particle::Restore(const geometry::LatticeData& latDatLBM,
+                                 const hemelb::lb::LbmParameters *lbmParams)
+    {
+      this->lbmParams = lbmParams;
+
+      // as in the constructor, updating the position with no velocity sets the owner rank
+      ownerRank = SITE_OR_BLOCK_SOLID;
+      velocity = LatticeVelocity::Zero();
+      bodyForces = LatticeVelocity::Zero();
+      lubricationVelocityAdjustment = LatticeVelocity::Zero();
+      UpdatePosition(latDatLBM);
+    }
+
 //    const bool Particle::operator<(const Particle& other) const
 //    {
 //      // ORDER BY isLocal, ownerRank, particleId
@@ -38,6 +38,12 @@ namespace hemelb
         /** constructor - gets an invalid particle for making MPI data types */
         Particle() {};
 
+        /** sets up the properties that are not persisted, and the owner rank,
+         *  for a particle whose persisted properties were read from a checkpoint
+         */
+        const void Restore(const geometry::LatticeData& latDatLBM,
+                           const hemelb::lb::LbmParameters *lbmParams);
+
         /** property getter for particleId */
         const unsigned long GetParticleId() const { return particleId; }
         const LatticePosition& GetGlobalPosition() const { return globalPosition; }
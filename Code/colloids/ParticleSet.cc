@@ -45,7 +45,7 @@ namespace hemelb
                              std::vector<proc_t>& neighbourProcessors,
                              const net::IOCommunicator& ioComms_,
                              const std::string& outputPath) :
-        ioComms(ioComms_), localRank(ioComms.Rank()), latDatLBM(latDatLBM), propertyCache(propertyCache), path(outputPath), net(ioComms)
+        ioComms(ioComms_), localRank(ioComms.Rank()), latDatLBM(latDatLBM), lbmParams(lbmParams), propertyCache(propertyCache), path(outputPath), net(ioComms)
     {
       /**
        * Open the file, unless it already exists, for writing only, creating it if it doesn't exist.
@@ -175,6 +175,35 @@ namespace hemelb
       }
     }
 
+    const void ParticleSet::GetLocalParticles(std::vector<Particle>& localParticles) const
+    {
+      localParticles.clear();
+      for (std::vector<Particle>::const_iterator iter = particles.begin(); iter != particles.end(); iter++)
+      {
+        if (iter->GetOwnerRank() == localRank)
+          localParticles.push_back(*iter);
+      }
+    }
+
+    const void ParticleSet::RestoreParticles(std::vector<Particle>& restoredParticles)
+    {
+      particles.clear();
+      scanMap[localRank].first = 0;
+      for (std::vector<Particle>::iterator iter = restoredParticles.begin(); iter != restoredParticles.end(); iter++)
+      {
+        Particle& particle = *iter;
+        particle.Restore(latDatLBM, lbmParams);
+        // keep the particle if it is valid, i.e. in fluid, and is locally owned
+        if (particle.IsValid() && particle.GetOwnerRank() == localRank)
+        {
+          particles.push_back(particle);
+          scanMap[localRank].first++;
+        }
+      }
+      if (!restoredParticles.empty())
+        propertyCache.velocityCache.SetRefreshFlag();
+    }
+
     const void ParticleSet::UpdatePositions()
     {
       if (log::Logger::ShouldDisplay<log::Debug>())
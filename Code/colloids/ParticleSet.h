@@ -60,6 +60,14 @@ namespace hemelb
 
         const void OutputInformation(const LatticeTimeStep timestep);
 
+        /** copies the particles owned by this process, e.g. to checkpoint them */
+        const void GetLocalParticles(std::vector<Particle>& localParticles) const;
+
+        /** replaces the particles with those of these that this process owns,
+         *  whose persisted properties have been read from a checkpoint
+         */
+        const void RestoreParticles(std::vector<Particle>& restoredParticles);
+
       private:
         const net::IOCommunicator& ioComms;
         /** cached copy of local rank (obtained from topology) */
@@ -87,6 +95,9 @@ namespace hemelb
         /** contains useful geometry manipulation functions */
         const geometry::LatticeData& latDatLBM;
 
+        /** supplies the value of tau to the particles */
+        const hemelb::lb::LbmParameters *lbmParams;
+
         /**
          * primary mechanism for interacting with the LB simulation
          * - the velocity cache  : is used for velocity interpolation
@@ -13,8 +13,8 @@ namespace hemelb
   {
 
     CommandLine::CommandLine(int aargc, const char * const * const aargv) :
-      inputFile("input.xml"), outputDir(""), images(10), steeringSessionId(1), debugMode(false), argc(aargc),
-          argv(aargv)
+      inputFile("input.xml"), outputDir(""), images(10), steeringSessionId(1), threadCount(1), debugMode(false),
+          calibrationFile(""), restartFile(""), argc(aargc), argv(aargv)
     {
 
       // There should be an odd number of arguments since the parameters occur in pairs.
@@ -47,10 +47,23 @@ namespace hemelb
           char *dummy;
           steeringSessionId = (unsigned int) (strtoul(paramValue, &dummy, 10));
         }
+        else if (std::strcmp(paramName, "-threads") == 0)
+        {
+          char *dummy;
+          threadCount = (unsigned int) (strtoul(paramValue, &dummy, 10));
+        }
         else if (std::strcmp(paramName, "-debug") == 0)
         {
           debugMode = std::strcmp(paramName, "0") == 0 ? false : true;
         }
+        else if (std::strcmp(paramName, "-calibrate") == 0)
+        {
+          calibrationFile = std::string(paramValue);
+        }
+        else if (std::strcmp(paramName, "-restart") == 0)
+        {
+          restartFile = std::string(paramValue);
+        }
         else
         {
           throw OptionError() << "Unknown option: " << paramName;
@@ -66,6 +79,10 @@ namespace hemelb
       ans.append("-out \t Path to the output folder (default is based on input file, e.g. config_xml_results)\n");
       ans.append("-i \t Number of images to create (default is 10)\n");
       ans.append("-ss \t Steering session identifier (default is 1)\n");
+      ans.append("-threads \t Threads per process for the LB update (default is 1, 0 for one per hardware thread)\n");
+      ans.append("-calibrate \t Instead of simulating, time the collision types and write site weights for the\n"
+                 "\t decomposition to this file\n");
+      ans.append("-restart \t Resume the run from this checkpoint file\n");
       return ans;
     }
   }
@@ -23,6 +23,7 @@ namespace hemelb
      * - -out output folder (empty default, but the hemelb::io::PathManager will guess a value from the input file if not given.)
      * - -i number of images (default 10)
      * - -ss steering session i.d. (default 1)
+     * - -threads number of threads per process for the LB update (default 1, 0 for one per hardware thread)
      */
     class CommandLine
     {
@@ -69,6 +70,31 @@ namespace hemelb
           return (steeringSessionId);
         }
 
+        /**
+         * @return The number of threads each process should use for the LB update.
+         */
+        unsigned int GetThreadCount() const
+        {
+          return threadCount;
+        }
+
+        /**
+         * @return The file to write calibrated site weights to, or empty to run the simulation
+         * rather than calibrate.
+         */
+        std::string const & GetCalibrationFile() const
+        {
+          return calibrationFile;
+        }
+
+        /**
+         * @return The checkpoint file to resume the run from, or empty to start it afresh.
+         */
+        std::string const & GetRestartFile() const
+        {
+          return restartFile;
+        }
+
         /**
          * @return Whether the user requested a debug mode.
          */
@@ -104,7 +130,10 @@ namespace hemelb
         std::string outputDir; //! local or full path to input file
         unsigned int images; //! images to produce
         int steeringSessionId; //! unique identifier for steering session
+        unsigned int threadCount; //! threads per process for the LB update
         bool debugMode; //! Use debugger
+        std::string calibrationFile; //! file to write calibrated site weights to
+        std::string restartFile; //! checkpoint file to resume from
         int argc; //! count of command line arguments, including program name
         const char * const * const argv; //! command line arguments
     };
@@ -95,6 +95,20 @@ namespace hemelb
       if (monitoringEl != io::xml::Element::Missing())
         DoIOForMonitoring(monitoringEl);
 
+      // Optional element <communications>
+      io::xml::Element communicationsEl = topNode.GetChildOrNull("communications");
+      if (communicationsEl != io::xml::Element::Missing())
+        DoIOForCommunications(communicationsEl);
+
+      // Optional element <decomposition>
+      io::xml::Element decompositionEl = topNode.GetChildOrNull("decomposition");
+      if (decompositionEl != io::xml::Element::Missing())
+        DoIOForDecomposition(decompositionEl);
+
+      // Optional element <checkpoint>
+      io::xml::Element checkpointEl = topNode.GetChildOrNull("checkpoint");
+      if (checkpointEl != io::xml::Element::Missing())
+        DoIOForCheckpoint(checkpointEl);
     }
 
     void SimConfig::DoIOForSimulation(const io::xml::Element simEl)
@@ -652,6 +666,36 @@ namespace hemelb
 
       monitoringConfig.doIncompressibilityCheck = (monEl.GetChildOrNull("incompressibility")
           != io::xml::Element::Missing());
+
+      // Optional element
+      // <stability_check_interval value="unsigned" units="lattice" />
+      io::xml::Element intervalEl = monEl.GetChildOrNull("stability_check_interval");
+      if (intervalEl != io::xml::Element::Missing())
+      {
+        GetDimensionalValue(intervalEl, "lattice", monitoringConfig.stabilityCheckInterval);
+        if (monitoringConfig.stabilityCheckInterval == 0)
+        {
+          throw Exception() << "Stability check interval must be at least one time step in "
+              << intervalEl.GetPath();
+        }
+      }
+
+      // Optional element
+      // <timeline start="unsigned" steps="unsigned" events="unsigned" />
+      io::xml::Element timelineEl = monEl.GetChildOrNull("timeline");
+      if (timelineEl != io::xml::Element::Missing())
+      {
+        monitoringConfig.doTimeline = true;
+        timelineEl.GetAttributeOrThrow("start", monitoringConfig.timelineFirstStep);
+        timelineEl.GetAttributeOrThrow("steps", monitoringConfig.timelineSteps);
+        timelineEl.GetAttributeOrNull("events", monitoringConfig.timelineEvents);
+        if (monitoringConfig.timelineFirstStep == 0 || monitoringConfig.timelineSteps == 0
+            || monitoringConfig.timelineEvents == 0)
+        {
+          throw Exception() << "Timeline must start at step one or later and record at least one step and event in "
+              << timelineEl.GetPath();
+        }
+      }
     }
 
     void SimConfig::DoIOForSteadyFlowConvergence(const io::xml::Element& convEl)
@@ -691,5 +735,120 @@ namespace hemelb
     {
       return &monitoringConfig;
     }
+
+    void SimConfig::DoIOForCommunications(const io::xml::Element& commsEl)
+    {
+      // Optional element
+      // <pointpoint value="string" exchanges="unsigned" />
+      // where the value is "auto" to tune the implementation, timing each over that many
+      // exchanges.
+      io::xml::Element pointPointEl = commsEl.GetChildOrNull("pointpoint");
+      if (pointPointEl != io::xml::Element::Missing())
+      {
+        communicationsConfig.pointPoint = pointPointEl.GetAttributeOrThrow("value");
+        pointPointEl.GetAttributeOrNull("exchanges", communicationsConfig.autoTuneExchanges);
+        if (communicationsConfig.autoTuneExchanges == 0)
+        {
+          throw Exception() << "Must tune over at least one exchange in " << pointPointEl.GetPath();
+        }
+      }
+
+      // Optional elements
+      // <gathers value="string" />
+      // <alltoall value="string" />
+      io::xml::Element gathersEl = commsEl.GetChildOrNull("gathers");
+      if (gathersEl != io::xml::Element::Missing())
+      {
+        communicationsConfig.gathers = gathersEl.GetAttributeOrThrow("value");
+      }
+      io::xml::Element allToAllEl = commsEl.GetChildOrNull("alltoall");
+      if (allToAllEl != io::xml::Element::Missing())
+      {
+        communicationsConfig.allToAll = allToAllEl.GetAttributeOrThrow("value");
+      }
+    }
+
+    const SimConfig::CommunicationsConfig* SimConfig::GetCommunicationsConfiguration() const
+    {
+      return &communicationsConfig;
+    }
+
+    void SimConfig::DoIOForDecomposition(const io::xml::Element& decompositionEl)
+    {
+      // Optional element
+      // <rebalance interval="unsigned" threshold="float" />
+      // to measure the load balance every interval time steps, and redecompose when the
+      // slowest rank's LB takes more than threshold times the mean. Only the distributions
+      // move with the sites, so this can't be used with colloids or with a kernel that keeps
+      // data for each site (the entropic and non-Newtonian ones).
+      io::xml::Element rebalanceEl = decompositionEl.GetChildOrNull("rebalance");
+      if (rebalanceEl != io::xml::Element::Missing())
+      {
+        decompositionConfig.doRebalance = true;
+        rebalanceEl.GetAttributeOrNull("interval", decompositionConfig.rebalanceInterval);
+        rebalanceEl.GetAttributeOrNull("threshold", decompositionConfig.rebalanceThreshold);
+        if (decompositionConfig.rebalanceInterval == 0)
+        {
+          throw Exception() << "Must rebalance over at least one time step in " << rebalanceEl.GetPath();
+        }
+      }
+
+      // Optional element
+      // <weights path="file" />
+      // to weight the sites of each collision type as in the file (e.g. one written by
+      // calibrating with -calibrate), rather than with the built-in weights.
+      io::xml::Element weightsEl = decompositionEl.GetChildOrNull("weights");
+      if (weightsEl != io::xml::Element::Missing())
+      {
+        decompositionConfig.siteWeightsPath =
+            util::NormalizePathRelativeToPath(weightsEl.GetAttributeOrThrow("path"), xmlFilePath);
+      }
+
+      // Optional element
+      // <partitioner value="string" />
+      // where the value is "parmetis" (the default) to partition the graph of sites with
+      // ParMETIS, or "hilbert" to cut the Hilbert curve through them, which is much quicker on
+      // many ranks.
+      io::xml::Element partitionerEl = decompositionEl.GetChildOrNull("partitioner");
+      if (partitionerEl != io::xml::Element::Missing())
+      {
+        decompositionConfig.partitioner = partitionerEl.GetAttributeOrThrow("value");
+        if (decompositionConfig.partitioner != "parmetis" && decompositionConfig.partitioner != "hilbert")
+        {
+          throw Exception() << "Unknown partitioner '" << decompositionConfig.partitioner << "' in "
+              << partitionerEl.GetPath();
+        }
+      }
+
+      // Optional element
+      // <cache directory="path" />
+      // to keep the decomposition in a file in the directory, named for the geometry, the
+      // number of ranks and the settings above, and to reuse it in later runs that match.
+      io::xml::Element cacheEl = decompositionEl.GetChildOrNull("cache");
+      if (cacheEl != io::xml::Element::Missing())
+      {
+        decompositionConfig.cacheDirectory =
+            util::NormalizePathRelativeToPath(cacheEl.GetAttributeOrThrow("directory"), xmlFilePath);
+      }
+    }
+
+    const SimConfig::DecompositionConfig* SimConfig::GetDecompositionConfiguration() const
+    {
+      return &decompositionConfig;
+    }
+
+    void SimConfig::DoIOForCheckpoint(const io::xml::Element& checkpointEl)
+    {
+      // <checkpoint interval="unsigned" />
+      // to write the state of the run to the output directory every interval time steps, and
+      // when the run is sent SIGTERM. Without the interval, or with 0, only on SIGTERM.
+      checkpointConfig.doCheckpoint = true;
+      checkpointEl.GetAttributeOrNull("interval", checkpointConfig.interval);
+    }
+
+    const SimConfig::CheckpointConfig* SimConfig::GetCheckpointConfiguration() const
+    {
+      return &checkpointConfig;
+    }
   }
 }
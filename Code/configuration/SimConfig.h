@@ -42,7 +42,8 @@ namespace hemelb
         {
             MonitoringConfig() :
                 doConvergenceCheck(false), convergenceRelativeTolerance(0), convergenceTerminate(false),
-                    doIncompressibilityCheck(false)
+                    doIncompressibilityCheck(false), stabilityCheckInterval(1), doTimeline(false),
+                    timelineFirstStep(1), timelineSteps(1), timelineEvents(65536)
             {
             }
             bool doConvergenceCheck; ///< Whether to turn on the convergence check or not
@@ -51,6 +52,56 @@ namespace hemelb
             double convergenceRelativeTolerance; ///< Convergence check relative tolerance
             bool convergenceTerminate; ///< Whether to terminate a converged run or not
             bool doIncompressibilityCheck; ///< Whether to turn on the IncompressibilityChecker or not
+            unsigned long stabilityCheckInterval; ///< Minimum number of time steps between stability and convergence checks
+            bool doTimeline; ///< Whether to write a timeline of the actions called in each time step
+            unsigned long timelineFirstStep; ///< First time step to put in the timeline
+            unsigned long timelineSteps; ///< Number of time steps to put in the timeline
+            unsigned long timelineEvents; ///< Maximum number of actions each rank keeps for the timeline
+        };
+
+        /**
+         * Bundles together the choice of communication implementations
+         */
+        struct CommunicationsConfig
+        {
+            CommunicationsConfig() :
+                autoTuneExchanges(10)
+            {
+            }
+            std::string pointPoint; ///< Point-to-point implementation, "auto" to tune it, or empty for the build's default
+            std::string gathers; ///< Gathers implementation, or empty for the build's default
+            std::string allToAll; ///< All-to-all implementation, or empty for the build's default
+            unsigned autoTuneExchanges; ///< Number of exchanges to time each point-to-point implementation over when tuning
+        };
+
+        /**
+         * Bundles together the settings for decomposing the domain between ranks
+         */
+        struct DecompositionConfig
+        {
+            DecompositionConfig() :
+                doRebalance(false), rebalanceInterval(1000), rebalanceThreshold(1.1), partitioner("parmetis")
+            {
+            }
+            bool doRebalance; ///< Whether to measure the load balance during the run, and redecompose if it is poor
+            unsigned long rebalanceInterval; ///< Number of time steps between measurements of the load balance
+            double rebalanceThreshold; ///< Ratio of the slowest rank's LB time to the mean above which to redecompose
+            std::string siteWeightsPath; ///< File of the weights of each collision type, or empty for the built-in ones
+            std::string partitioner; ///< How to split the sites between the ranks: "parmetis" or "hilbert"
+            std::string cacheDirectory; ///< Directory to keep decompositions in for later runs, or empty not to
+        };
+
+        /**
+         * Bundles together the settings for checkpointing the run
+         */
+        struct CheckpointConfig
+        {
+            CheckpointConfig() :
+                doCheckpoint(false), interval(0)
+            {
+            }
+            bool doCheckpoint; ///< Whether to checkpoint the run
+            unsigned long interval; ///< Number of time steps between checkpoints, or 0 only to checkpoint on SIGTERM
         };
 
         static SimConfig* New(const std::string& path);
@@ -165,6 +216,24 @@ namespace hemelb
          */
         const MonitoringConfig* GetMonitoringConfiguration() const;
 
+        /**
+         * Return the choice of communication implementations
+         * @return communications configuration
+         */
+        const CommunicationsConfig* GetCommunicationsConfiguration() const;
+
+        /**
+         * Return the settings for decomposing the domain
+         * @return decomposition configuration
+         */
+        const DecompositionConfig* GetDecompositionConfiguration() const;
+
+        /**
+         * Return the settings for checkpointing the run
+         * @return checkpoint configuration
+         */
+        const CheckpointConfig* GetCheckpointConfiguration() const;
+
       protected:
         /**
          * Create the unit converter - virtual so that mocks can override it.
@@ -267,6 +336,27 @@ namespace hemelb
          */
         void DoIOForConvergenceCriterion(const io::xml::Element& criterionEl);
 
+        /**
+         * Reads the choice of communication implementations from XML file
+         *
+         * @param commsEl in memory representation of the <communications> XML element
+         */
+        void DoIOForCommunications(const io::xml::Element& commsEl);
+
+        /**
+         * Reads the settings for decomposing the domain from XML file
+         *
+         * @param decompositionEl in memory representation of the <decomposition> XML element
+         */
+        void DoIOForDecomposition(const io::xml::Element& decompositionEl);
+
+        /**
+         * Reads the settings for checkpointing the run from XML file
+         *
+         * @param checkpointEl in memory representation of the <checkpoint> XML element
+         */
+        void DoIOForCheckpoint(const io::xml::Element& checkpointEl);
+
         const std::string& xmlFilePath;
         io::xml::Document* rawXmlDoc;
         std::string dataFilePath;
@@ -287,6 +377,9 @@ namespace hemelb
         bool hasColloidSection;
         PhysicalPressure initialPressure_mmHg; ///< Pressure used to initialise the domain
         MonitoringConfig monitoringConfig; ///< Configuration of various checks/tests
+        CommunicationsConfig communicationsConfig; ///< Choice of communication implementations
+        DecompositionConfig decompositionConfig; ///< Settings for decomposing the domain
+        CheckpointConfig checkpointConfig; ///< Settings for checkpointing the run
 
       protected:
         // These have to contain pointers because there are multiple derived types that might be
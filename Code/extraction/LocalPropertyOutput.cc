@@ -25,38 +25,7 @@ namespace hemelb
       // already exists.
       outputFile = net::MpiFile::Open(comms, outputSpec->filename,
                                       MPI_MODE_WRONLY | MPI_MODE_CREATE | MPI_MODE_EXCL);
-      // Count sites on this task
-      uint64_t siteCount = 0;
-      dataSource.Reset();
-      while (dataSource.ReadNext())
-      {
-        if (outputSpec->geometry->Include(dataSource, dataSource.GetPosition()))
-        {
-          ++siteCount;
-        }
-      }
-
-      // Calculate how long local writes need to be.
-
-      // First get the length per-site
-      // Always have 3 uint32's for the position of a site
-      writeLength = 3 * 4;
-
-      // Then get add each field's length
-      for (unsigned outputNumber = 0; outputNumber < outputSpec->fields.size(); ++outputNumber)
-      {
-        writeLength += sizeof(WrittenDataType)
-            * GetFieldLength(outputSpec->fields[outputNumber].type);
-      }
-
-      //  Now multiply by local site count
-      writeLength *= siteCount;
-
-      // The IO proc also writes the iteration number
-      if (comms.OnIORank())
-      {
-        writeLength += 8;
-      }
+      uint64_t siteCount = CalculateWriteLength();
 
       //! @TODO: These two MPI calls can be replaced with one
 
@@ -128,11 +97,68 @@ namespace hemelb
         outputFile.WriteAt(0, headerBuffer);
       }
 
+      ChainOffsets(totalHeaderLength);
+    }
+
+    void LocalPropertyOutput::Rebuild()
+    {
+      CalculateWriteLength();
+      allCoresWriteLength = comms.AllReduce(writeLength, MPI_SUM);
+
+      // The IO proc writes every iteration, so its offset is where the next iteration starts.
+      uint64_t nextIterationOffset = localDataOffsetIntoFile;
+      comms.Broadcast(nextIterationOffset, comms.GetIORank());
+      ChainOffsets(nextIterationOffset);
+    }
+
+    uint64_t LocalPropertyOutput::CalculateWriteLength()
+    {
+      // Count sites on this task
+      uint64_t siteCount = 0;
+      dataSource.Reset();
+      while (dataSource.ReadNext())
+      {
+        if (outputSpec->geometry->Include(dataSource, dataSource.GetPosition()))
+        {
+          ++siteCount;
+        }
+      }
+
+      // Calculate how long local writes need to be.
+
+      // First get the length per-site
+      // Always have 3 uint32's for the position of a site
+      writeLength = 3 * 4;
+
+      // Then get add each field's length
+      for (unsigned outputNumber = 0; outputNumber < outputSpec->fields.size(); ++outputNumber)
+      {
+        writeLength += sizeof(WrittenDataType)
+            * GetFieldLength(outputSpec->fields[outputNumber].type);
+      }
+
+      //  Now multiply by local site count
+      writeLength *= siteCount;
+
+      // The IO proc also writes the iteration number
+      if (comms.OnIORank())
+      {
+        writeLength += 8;
+      }
+
+      // Create the buffer that we'll write each iteration's data into.
+      buffer.resize(writeLength);
+
+      return siteCount;
+    }
+
+    void LocalPropertyOutput::ChainOffsets(uint64_t ioRankOffset)
+    {
       // Calculate where each core should start writing
       if (comms.OnIORank())
       {
         // For core 0 this is easy: it passes the value for core 1 to the core.
-        localDataOffsetIntoFile = totalHeaderLength;
+        localDataOffsetIntoFile = ioRankOffset;
 
         if (comms.Size() > 1)
         {
@@ -150,9 +176,6 @@ namespace hemelb
           comms.Send(localDataOffsetIntoFile+writeLength, comms.Rank() + 1, 1);
         }
       }
-
-      // Create the buffer that we'll write each iteration's data into.
-      buffer.resize(writeLength);
     }
 
     LocalPropertyOutput::~LocalPropertyOutput()
@@ -58,7 +58,27 @@ namespace hemelb
          */
         void Write(unsigned long timestepNumber);
 
+        /**
+         * Work out this core's part of each iteration's write again, after the sites have been
+         * redistributed between cores. Collective. The file and its header are unchanged, as
+         * the total number of sites is the same, but the sites come in a different order.
+         */
+        void Rebuild();
+
       private:
+        /**
+         * Count the sites to be written from this core, and set the write length and the
+         * buffer size from them.
+         * @return The number of sites
+         */
+        uint64_t CalculateWriteLength();
+
+        /**
+         * Pass the offsets into the file from core to core, each starting where the last ends.
+         * @param ioRankOffset Where the IO rank's write starts
+         */
+        void ChainOffsets(uint64_t ioRankOffset);
+
         /**
          * Returns the number of floats written for the field.
          * @param field
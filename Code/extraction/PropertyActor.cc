@@ -89,5 +89,10 @@ namespace hemelb
       timers[reporting::Timers::extractionWriting].Stop();
     }
 
+    void PropertyActor::Rebuild()
+    {
+      propertyWriter->Rebuild();
+    }
+
   }
 }
@@ -46,6 +46,12 @@ namespace hemelb
          */
         void EndIteration();
 
+        /**
+         * Prepare the property output again after the sites have been redistributed between
+         * cores. Collective.
+         */
+        void Rebuild();
+
       private:
         const lb::SimulationState& simulationState;
         PropertyWriter* propertyWriter;
@@ -39,6 +39,12 @@ namespace hemelb
          */
         void Write(unsigned long iterationNumber) const;
 
+        /**
+         * Sets up each of the outputs again after the sites have been redistributed between
+         * cores. Collective.
+         */
+        void Rebuild();
+
         /**
          * Returns a vector of all the LocalPropertyOutputs.
          * @return
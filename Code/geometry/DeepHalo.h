@@ -0,0 +1,118 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_DEEPHALO_H
+#define HEMELB_GEOMETRY_DEEPHALO_H
+
+#include <set>
+#include <vector>
+#include "units.h"
+#include "constants.h"
+#include "geometry/Geometry.h"
+#include "lb/lattices/LatticeInfo.h"
+#include "util/Vector3D.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    /**
+     * Helpers for the deep halo.
+     *
+     * When built with HEMELB_HALO_DEPTH greater than one, each rank keeps a copy of every fluid
+     * site on other ranks that is within that many lattice links of its own sites, and updates
+     * those copies itself. Rather than exchanging the distributions that cross the rank boundary
+     * on every step, ranks then only need to refresh the copies from their owners once every
+     * HEMELB_HALO_DEPTH steps, as each step only spoils the outermost layer of the halo that is
+     * still up to date.
+     */
+    namespace halo
+    {
+      /**
+       * The number of layers of sites in the halo.
+       */
+      const unsigned DEPTH = HEMELB_HALO_DEPTH;
+
+      /**
+       * Get the number of blocks around each block with sites on a rank that must be read in,
+       * for that rank to have every site in a halo of the given depth.
+       * @param haloDepth
+       * @param blockSize
+       * @return
+       */
+      inline site_t GetBlockHaloWidth(const site_t haloDepth, const site_t blockSize)
+      {
+        return 1 + (haloDepth - 1) / blockSize;
+      }
+
+      /**
+       * Find the fluid sites on other ranks within the given number of links of the sites on
+       * this rank, layer by layer: the sites in layer n are n links away from the nearest site on
+       * this rank. Within each layer, the sites are in the order they were found.
+       * @param geometry The geometry as read, including the sites on other ranks near this one.
+       * @param latticeInfo
+       * @param localRank
+       * @param edgeSites The coordinates of the sites on this rank with a neighbour on another.
+       * @param haloDepth
+       * @return The coordinates of the sites in each layer, from the innermost outwards.
+       */
+      inline std::vector<std::vector<util::Vector3D<site_t> > > FindHaloLayers(const Geometry& geometry,
+                                                                               const lb::lattices::LatticeInfo& latticeInfo,
+                                                                               const proc_t localRank,
+                                                                               const std::vector<util::Vector3D<site_t> >& edgeSites,
+                                                                               const unsigned haloDepth)
+      {
+        const util::Vector3D<site_t> sites = geometry.GetBlockDimensions() * geometry.GetBlockSize();
+        std::set<site_t> sitesSeen;
+        std::vector<std::vector<util::Vector3D<site_t> > > layers(haloDepth);
+
+        std::vector<util::Vector3D<site_t> > frontier = edgeSites;
+        for (unsigned layer = 0; layer < haloDepth; layer++)
+        {
+          for (std::vector<util::Vector3D<site_t> >::const_iterator it = frontier.begin(); it != frontier.end(); ++it)
+          {
+            for (Direction direction = 1; direction < latticeInfo.GetNumVectors(); direction++)
+            {
+              const util::Vector3D<site_t> neighbour = *it + util::Vector3D<site_t>(latticeInfo.GetVector(direction));
+              if (neighbour.x < 0 || neighbour.y < 0 || neighbour.z < 0 || neighbour.x >= sites.x
+                  || neighbour.y >= sites.y || neighbour.z >= sites.z)
+              {
+                continue;
+              }
+
+              // Blocks that weren't read in have no sites, and count as solid.
+              const util::Vector3D<site_t> block = neighbour / geometry.GetBlockSize();
+              const util::Vector3D<site_t> site = neighbour % geometry.GetBlockSize();
+              const BlockReadResult& blockReadIn = geometry.Blocks[geometry.GetBlockIdFromBlockCoordinates(block.x,
+                                                                                                            block.y,
+                                                                                                            block.z)];
+              if (blockReadIn.Sites.size() == 0)
+              {
+                continue;
+              }
+
+              const proc_t neighbourProc =
+                  blockReadIn.Sites[geometry.GetSiteIdFromSiteCoordinates(site.x, site.y, site.z)].targetProcessor;
+              if (neighbourProc == SITE_OR_BLOCK_SOLID || neighbourProc == localRank)
+              {
+                continue;
+              }
+
+              if (sitesSeen.insert( (neighbour.x * sites.y + neighbour.y) * sites.z + neighbour.z).second)
+              {
+                layers[layer].push_back(neighbour);
+              }
+            }
+          }
+          frontier = layers[layer];
+        }
+
+        return layers;
+      }
+    }
+  }
+}
+
+#endif /* HEMELB_GEOMETRY_DEEPHALO_H */
@@ -0,0 +1,157 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_DENSEBLOCKS_H
+#define HEMELB_GEOMETRY_DENSEBLOCKS_H
+
+#include <algorithm>
+#include <map>
+#include <vector>
+#include "units.h"
+#include "util/Vector3D.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    /**
+     * Helpers for the dense-block fast path.
+     *
+     * A dense block is one whose every site is a mid-domain bulk fluid site on this rank. When
+     * built with HEMELB_USE_DENSE_BLOCKS, LatticeData numbers the sites of each dense block
+     * contiguously, in the order of their site ids within the block, at the start of the site
+     * array. The neighbours of a site away from the faces of such a block are then at a fixed
+     * offset in that numbering, so they have no entries in the neighbour index table, and
+     * SimpleCollideAndStream streams them in runs along the z axis of the block without looking
+     * anything up. Sites on the faces of the block, which act as its halo, keep their entries
+     * and stream through the table as usual.
+     */
+    namespace denseblocks
+    {
+      /**
+       * Move the sites of blocks that lie entirely in one collision-type range to the front of
+       * the order in which the range is numbered. These are grouped by block, in increasing
+       * block id, and within each block by site id. The other sites keep their relative order.
+       * @param order The order in which to number the sites, as indices into the range.
+       * @param blockNumbers The block of each site in the range.
+       * @param siteNumbers The index of each site within its block.
+       * @param sitesPerBlock The number of sites in a whole block.
+       * @return The number of sites in dense blocks.
+       */
+      inline site_t OrderDenseBlockSitesFirst(std::vector<site_t>& order,
+                                              const std::vector<site_t>& blockNumbers,
+                                              const std::vector<site_t>& siteNumbers,
+                                              const site_t sitesPerBlock)
+      {
+        std::map<site_t, site_t> sitesInBlock;
+        for (size_t indexInType = 0; indexInType < blockNumbers.size(); ++indexInType)
+        {
+          ++sitesInBlock[blockNumbers[indexInType]];
+        }
+
+        std::vector<site_t> denseOrder, sparseOrder;
+        for (std::vector<site_t>::const_iterator it = order.begin(); it != order.end(); ++it)
+        {
+          if (sitesInBlock[blockNumbers[*it]] == sitesPerBlock)
+          {
+            denseOrder.push_back(*it);
+          }
+          else
+          {
+            sparseOrder.push_back(*it);
+          }
+        }
+
+        std::sort(denseOrder.begin(), denseOrder.end(), [&blockNumbers, &siteNumbers](site_t a, site_t b)
+        {
+          return blockNumbers[a] < blockNumbers[b]
+              || (blockNumbers[a] == blockNumbers[b] && siteNumbers[a] < siteNumbers[b]);
+        });
+
+        order = denseOrder;
+        order.insert(order.end(), sparseOrder.begin(), sparseOrder.end());
+        return denseOrder.size();
+      }
+
+      /**
+       * True if none of the lattice neighbours of the site with the given id lie outside its
+       * block.
+       * @param localSiteId
+       * @param blockSize
+       * @return
+       */
+      inline bool IsInteriorSite(site_t localSiteId, const site_t blockSize)
+      {
+        const site_t z = localSiteId % blockSize;
+        localSiteId /= blockSize;
+        const site_t y = localSiteId % blockSize;
+        const site_t x = localSiteId / blockSize;
+
+        return x > 0 && x < blockSize - 1 && y > 0 && y < blockSize - 1 && z > 0 && z < blockSize - 1;
+      }
+
+      /**
+       * True if the sites of the row along z that starts with the given site id are interior
+       * sites, apart from the first and last.
+       * @param rowStartSiteId
+       * @param blockSize
+       * @return
+       */
+      inline bool IsInteriorRow(const site_t rowStartSiteId, const site_t blockSize)
+      {
+        return IsInteriorSite(rowStartSiteId + 1, blockSize);
+      }
+
+      /**
+       * Number the rows of the neighbour index table for the sites of a dense block, which only
+       * the sites that aren't interior sites have.
+       * @param blockSize
+       * @param tableRows Set to the row of each site id within the block, relative to the
+       * block's first row, or -1 for interior sites.
+       * @return The number of rows each dense block has.
+       */
+      inline site_t NumberTableRows(const site_t blockSize, std::vector<site_t>& tableRows)
+      {
+        site_t rowCount = 0;
+        tableRows.resize(blockSize * blockSize * blockSize);
+        for (site_t localSiteId = 0; localSiteId < (site_t) tableRows.size(); ++localSiteId)
+        {
+          tableRows[localSiteId] = IsInteriorSite(localSiteId, blockSize) ?
+            -1 :
+            rowCount++;
+        }
+        return rowCount;
+      }
+
+      /**
+       * Get the difference between the index of a site in a dense block and that of its
+       * neighbour along the given lattice vector.
+       * @param vector
+       * @param blockSize
+       * @return
+       */
+      inline site_t GetNeighbourOffset(const util::Vector3D<int>& vector, const site_t blockSize)
+      {
+        return (vector.x * blockSize + vector.y) * blockSize + vector.z;
+      }
+
+      /**
+       * Get the difference between the index of a site in a dense block and that of its
+       * neighbour in the given direction.
+       * @param direction
+       * @param blockSize
+       * @return
+       */
+      template<typename LatticeType>
+      inline site_t GetNeighbourOffset(const Direction direction, const site_t blockSize)
+      {
+        return (LatticeType::CX[direction] * blockSize + LatticeType::CY[direction]) * blockSize
+            + LatticeType::CZ[direction];
+      }
+    }
+  }
+}
+
+#endif /* HEMELB_GEOMETRY_DENSEBLOCKS_H */
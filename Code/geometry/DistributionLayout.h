@@ -0,0 +1,134 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_DISTRIBUTIONLAYOUT_H
+#define HEMELB_GEOMETRY_DISTRIBUTIONLAYOUT_H
+
+#include "units.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    /**
+     * Memory layouts for the per-site part of the distribution arrays held by LatticeData.
+     *
+     * Each layout maps (site, direction) to an index into the distribution array, given the
+     * number of lattice vectors and the number of sites the array was allocated for. The names
+     * of the classes must correspond to options given for the CMake HEMELB_DISTRIBUTION_LAYOUT
+     * parameter.
+     *
+     * Whatever the layout, the 'rubbish site' and the buffer of distributions shared with
+     * neighbouring ranks follow on from the per-site part of the array, as before.
+     */
+    namespace layouts
+    {
+      /**
+       * Array of structures: the NUMVECTORS distributions of each site are contiguous. This is
+       * the original HemeLB layout.
+       */
+      class AOS
+      {
+        public:
+          /**
+           * True if the distributions of a single site are contiguous in memory, so that a
+           * pointer to the first one can be handed out.
+           */
+          static const bool SITE_CONTIGUOUS = true;
+
+          /**
+           * The number of sites to allocate storage for, given the number of fluid sites.
+           */
+          static site_t GetAllocatedSiteCount(const site_t siteCount)
+          {
+            return siteCount;
+          }
+
+          /**
+           * True if, in each direction, the distributions of count sites from the given site
+           * are contiguous in memory, so that they can be loaded or stored together.
+           */
+          static bool AreSitesContiguous(const site_t site, const site_t count)
+          {
+            return count == 1;
+          }
+
+          static site_t GetIndex(const site_t site,
+                                 const Direction direction,
+                                 const unsigned numVectors,
+                                 const site_t allocatedSiteCount)
+          {
+            return site * numVectors + direction;
+          }
+      };
+
+      /**
+       * Structure of arrays: one array per lattice direction, each holding that direction's
+       * distribution for every site.
+       */
+      class SOA
+      {
+        public:
+          static const bool SITE_CONTIGUOUS = false;
+
+          static site_t GetAllocatedSiteCount(const site_t siteCount)
+          {
+            return siteCount;
+          }
+
+          static bool AreSitesContiguous(const site_t site, const site_t count)
+          {
+            return true;
+          }
+
+          static site_t GetIndex(const site_t site,
+                                 const Direction direction,
+                                 const unsigned numVectors,
+                                 const site_t allocatedSiteCount)
+          {
+            return direction * allocatedSiteCount + site;
+          }
+      };
+
+      /**
+       * Array of structures of arrays: sites are grouped into blocks of HEMELB_AOSOA_BLOCK_SIZE,
+       * and within a block each direction's distributions are contiguous. The site count is
+       * padded up to a whole number of blocks.
+       */
+      class AOSOA
+      {
+        public:
+          static const bool SITE_CONTIGUOUS = false;
+
+          static const site_t BLOCK_SIZE = HEMELB_AOSOA_BLOCK_SIZE;
+
+          static site_t GetAllocatedSiteCount(const site_t siteCount)
+          {
+            return ( (siteCount + BLOCK_SIZE - 1) / BLOCK_SIZE) * BLOCK_SIZE;
+          }
+
+          static bool AreSitesContiguous(const site_t site, const site_t count)
+          {
+            return site % BLOCK_SIZE + count <= BLOCK_SIZE;
+          }
+
+          static site_t GetIndex(const site_t site,
+                                 const Direction direction,
+                                 const unsigned numVectors,
+                                 const site_t allocatedSiteCount)
+          {
+            return (site / BLOCK_SIZE) * BLOCK_SIZE * numVectors + direction * BLOCK_SIZE + site % BLOCK_SIZE;
+          }
+      };
+    }
+
+    /**
+     * The layout selected through the build system.
+     */
+    typedef layouts::HEMELB_DISTRIBUTION_LAYOUT DistributionLayout;
+  }
+}
+
+#endif /* HEMELB_GEOMETRY_DISTRIBUTIONLAYOUT_H */
@@ -0,0 +1,116 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_DISTRIBUTIONSTORAGE_H
+#define HEMELB_GEOMETRY_DISTRIBUTIONSTORAGE_H
+
+#include "units.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    /**
+     * Precisions for storing the distribution arrays held by LatticeData.
+     *
+     * Each storage gives the type of the array elements, and converts between a distribution
+     * and its stored value given the lattice weight of its direction. Everything outside
+     * the arrays, including all moments and collisions, is still done in distribn_t. The names
+     * of the classes must correspond to options given for the CMake
+     * HEMELB_DISTRIBUTION_PRECISION parameter.
+     *
+     * Lattice weights are symmetric under inversion of the direction, so a distribution may be
+     * encoded with the weight of either the direction it travels in or its inverse.
+     */
+    namespace storages
+    {
+      /**
+       * The density about which MIXED storage stores deviations. This is the same as
+       * lb::REFERENCE_DENSITY.
+       */
+      const distribn_t STORAGE_REFERENCE_DENSITY = 1.0;
+
+      /**
+       * Full precision: the distributions themselves, as distribn_t.
+       */
+      class DOUBLE
+      {
+        public:
+          typedef distribn_t Type;
+
+          /**
+           * True if the stored value is the distribution itself, so that the arrays can be
+           * used directly as distribn_t.
+           */
+          static const bool EXACT = true;
+
+          static Type Encode(const distribn_t value, const distribn_t weight)
+          {
+            return value;
+          }
+
+          static distribn_t Decode(const Type stored, const distribn_t weight)
+          {
+            return stored;
+          }
+      };
+
+      /**
+       * Single precision: the distributions rounded to float. This halves the memory and halo
+       * message sizes, at the cost of about seven significant figures in each distribution.
+       */
+      class SINGLE
+      {
+        public:
+          typedef float Type;
+
+          static const bool EXACT = false;
+
+          static Type Encode(const distribn_t value, const distribn_t weight)
+          {
+            return Type(value);
+          }
+
+          static distribn_t Decode(const Type stored, const distribn_t weight)
+          {
+            return distribn_t(stored);
+          }
+      };
+
+      /**
+       * Mixed precision: the deviation of each distribution from its equilibrium value at rest
+       * at the reference density, f_i - w_i * rho_0, as a float. The deviations are small
+       * compared with the distributions, so far less precision is lost than with SINGLE for
+       * the same memory.
+       */
+      class MIXED
+      {
+        public:
+          typedef float Type;
+
+          static const bool EXACT = false;
+
+          static Type Encode(const distribn_t value, const distribn_t weight)
+          {
+            return Type(value - weight * STORAGE_REFERENCE_DENSITY);
+          }
+
+          static distribn_t Decode(const Type stored, const distribn_t weight)
+          {
+            return distribn_t(stored) + weight * STORAGE_REFERENCE_DENSITY;
+          }
+      };
+    }
+
+    typedef storages::HEMELB_DISTRIBUTION_PRECISION DistributionStorage;
+
+    /**
+     * The type of the elements of the distribution arrays.
+     */
+    typedef DistributionStorage::Type distribn_storage_t;
+  }
+}
+
+#endif /* HEMELB_GEOMETRY_DISTRIBUTIONSTORAGE_H */
@@ -16,6 +16,7 @@
 #include "geometry/decomposition/BasicDecomposition.h"
 #include "geometry/decomposition/OptimisedDecomposition.h"
 #include "geometry/GeometryReader.h"
+#include "geometry/DeepHalo.h"
 #include "lb/lattices/D3Q27.h"
 #include "net/net.h"
 #include "net/IOCommunicator.h"
@@ -30,7 +31,8 @@ namespace hemelb
     GeometryReader::GeometryReader(const bool reserveSteeringCore,
                                    const lb::lattices::LatticeInfo& latticeInfo,
                                    reporting::Timers &atimings, const net::IOCommunicator& ioComm) :
-      latticeInfo(latticeInfo), hemeLbComms(ioComm), timings(atimings)
+      latticeInfo(latticeInfo), hemeLbComms(ioComm), partitioner(decomposition::PARMETIS_PARTITIONER),
+          timings(atimings)
     {
       // This rank should participate in the domain decomposition if
       //  - there's no steering core (then all ranks are involved)
@@ -61,6 +63,26 @@ namespace hemelb
     {
     }
 
+    void GeometryReader::SetBlockCostFactors(const std::vector<float>& factors)
+    {
+      blockCostFactors = factors;
+    }
+
+    void GeometryReader::SetSiteWeights(const decomposition::SiteWeights& weights)
+    {
+      siteWeights = weights;
+    }
+
+    void GeometryReader::SetPartitioner(decomposition::Partitioner partitionerToUse)
+    {
+      partitioner = partitionerToUse;
+    }
+
+    void GeometryReader::SetDecompositionCache(const std::string& directory)
+    {
+      decompositionCacheDirectory = directory;
+    }
+
     Geometry GeometryReader::LoadAndDecompose(const std::string& dataFilePath)
     {
       log::Logger::Log<log::Debug, log::OnePerCore>("Starting file read timer");
@@ -101,6 +123,21 @@ namespace hemelb
       // Close the file - only the ranks participating in the topology need to read it again.
       file.Close();
 
+      // Rebalancing takes the sites' costs into account, so there's no sense caching it.
+      decomposition::DecompositionCache cache(computeComms);
+      const bool useCache = participateInTopology && !decompositionCacheDirectory.empty()
+          && blockCostFactors.empty();
+      if (useCache)
+      {
+        cache.Identify(decompositionCacheDirectory, dataFilePath, HashDecompositionSettings());
+        if (ReadCachedDecomposition(geometry, cache, dataFilePath, fileInfo))
+        {
+          HEMELB_MPI_CALL(MPI_Info_free, (&fileInfo));
+          timings[hemelb::reporting::Timers::fileRead].Stop();
+          return geometry;
+        }
+      }
+
       timings[hemelb::reporting::Timers::initialDecomposition].Start();
       log::Logger::Log<log::Debug, log::OnePerCore>("Beginning initial decomposition");
       principalProcForEachBlock.resize(geometry.GetBlockCount());
@@ -164,6 +201,12 @@ namespace hemelb
           ValidateGeometry(geometry);
         }
         file.Close();
+
+        if (useCache)
+        {
+          cache.Write(geometry, fluidSitesOnEachBlock, ConvertTopologyRankToGlobalRank(computeComms.Rank()));
+          log::Logger::Log<log::Info, log::Singleton>("Cached the decomposition in %s", cache.GetPath().c_str());
+        }
       }
 
       // Finish up - close the file, set the timings, deallocate memory.
@@ -174,6 +217,57 @@ namespace hemelb
       return geometry;
     }
 
+    bool GeometryReader::ReadCachedDecomposition(Geometry& geometry, decomposition::DecompositionCache& cache,
+                                                 const std::string& dataFilePath, MPI_Info fileInfo)
+    {
+      site_t fluidSiteCount = 0;
+      for (site_t block = 0; block < geometry.GetBlockCount(); ++block)
+      {
+        fluidSiteCount += fluidSitesOnEachBlock[block];
+      }
+
+      std::vector<site_t> localBlocks;
+      if (!cache.Open(geometry.GetBlockCount(), fluidSiteCount, localBlocks))
+      {
+        return false;
+      }
+      log::Logger::Log<log::Info, log::Singleton>("Reusing the decomposition cached in %s", cache.GetPath().c_str());
+
+      // Read in the blocks with sites on this rank, and the halo around them, as after the
+      // initial decomposition, then give their sites the cached ranks.
+      principalProcForEachBlock.assign(geometry.GetBlockCount(), -1);
+      for (std::vector<site_t>::const_iterator block = localBlocks.begin(); block != localBlocks.end(); ++block)
+      {
+        principalProcForEachBlock[*block] = computeComms.Rank();
+      }
+
+      file = net::MpiFile::Open(computeComms, dataFilePath, MPI_MODE_RDONLY, fileInfo);
+      ReadInBlocksWithHalo(geometry, principalProcForEachBlock, computeComms.Rank());
+      file.Close();
+
+      cache.ReadSiteRanks(geometry, fluidSitesOnEachBlock);
+
+      if (ShouldValidate())
+      {
+        ValidateGeometry(geometry);
+      }
+      return true;
+    }
+
+    uint64_t GeometryReader::HashDecompositionSettings() const
+    {
+      std::vector<int64_t> settings;
+      settings.push_back(hemeLbComms.Size());
+      settings.push_back(computeComms.Size());
+      settings.push_back(latticeInfo.GetNumVectors());
+      settings.push_back(partitioner);
+      for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; ++collisionType)
+      {
+        settings.push_back(siteWeights[collisionType]);
+      }
+      return decomposition::DecompositionCache::Hash(&settings.front(), settings.size() * sizeof(int64_t));
+    }
+
     std::vector<char> GeometryReader::ReadOnAllTasks(unsigned nBytes)
     {
       std::vector<char> buffer(nBytes);
@@ -715,6 +809,9 @@ namespace hemelb
     {
       std::vector<bool> shouldReadBlock(geometry.GetBlockCount(), false);
 
+      // With a deep halo, the sites in it can be more than one block away.
+      const site_t haloWidth = halo::GetBlockHaloWidth(halo::DEPTH, geometry.GetBlockSize());
+
       // Read a block in if it has fluid sites and is to live on the current processor. Also read
       // in any neighbours with fluid sites.
       for (site_t blockI = 0; blockI < geometry.GetBlockDimensions().x; ++blockI)
@@ -731,14 +828,14 @@ namespace hemelb
             }
 
             // Read in all neighbouring blocks.
-            for (site_t neighI = util::NumericalFunctions::max<site_t>(0, blockI - 1); (neighI
-                <= (blockI + 1)) && (neighI < geometry.GetBlockDimensions().x); ++neighI)
+            for (site_t neighI = util::NumericalFunctions::max<site_t>(0, blockI - haloWidth); (neighI
+                <= (blockI + haloWidth)) && (neighI < geometry.GetBlockDimensions().x); ++neighI)
             {
-              for (site_t neighJ = util::NumericalFunctions::max<site_t>(0, blockJ - 1); (neighJ
-                  <= (blockJ + 1)) && (neighJ < geometry.GetBlockDimensions().y); ++neighJ)
+              for (site_t neighJ = util::NumericalFunctions::max<site_t>(0, blockJ - haloWidth); (neighJ
+                  <= (blockJ + haloWidth)) && (neighJ < geometry.GetBlockDimensions().y); ++neighJ)
               {
-                for (site_t neighK = util::NumericalFunctions::max<site_t>(0, blockK - 1); (neighK
-                    <= (blockK + 1)) && (neighK < geometry.GetBlockDimensions().z); ++neighK)
+                for (site_t neighK = util::NumericalFunctions::max<site_t>(0, blockK - haloWidth); (neighK
+                    <= (blockK + haloWidth)) && (neighK < geometry.GetBlockDimensions().z); ++neighK)
                 {
                   site_t lNeighId = geometry.GetBlockIdFromBlockCoordinates(neighI, neighJ, neighK);
 
@@ -761,7 +858,10 @@ namespace hemelb
                                                       geometry,
                                                       latticeInfo,
                                                       procForEachBlock,
-                                                      fluidSitesOnEachBlock);
+                                                      fluidSitesOnEachBlock,
+                                                      partitioner,
+                                                      siteWeights,
+                                                      blockCostFactors);
 
       timings[hemelb::reporting::Timers::reRead].Start();
       log::Logger::Log<log::Debug, log::OnePerCore>("Rereading blocks");
@@ -20,6 +20,9 @@
 #include "units.h"
 #include "geometry/Geometry.h"
 #include "geometry/needs/Needs.h"
+#include "geometry/decomposition/SiteWeights.h"
+#include "geometry/decomposition/Partitioner.h"
+#include "geometry/decomposition/DecompositionCache.h"
 
 #include "net/MpiFile.h"
 
@@ -39,6 +42,35 @@ namespace hemelb
 
         Geometry LoadAndDecompose(const std::string& dataFilePath);
 
+        /**
+         * Have the optimised decomposition scale the weight of the sites on each block by the
+         * given factor, e.g. as measured on an earlier decomposition.
+         * @param factors The factor for each block, the same on every rank
+         */
+        void SetBlockCostFactors(const std::vector<float>& factors);
+
+        /**
+         * Have the optimised decomposition use the given weights for the sites of each
+         * collision type, rather than the built-in ones.
+         * @param weights
+         */
+        void SetSiteWeights(const decomposition::SiteWeights& weights);
+
+        /**
+         * Have the optimised decomposition split the sites between the ranks this way, rather
+         * than with ParMETIS.
+         * @param partitioner
+         */
+        void SetPartitioner(decomposition::Partitioner partitioner);
+
+        /**
+         * Keep the decomposition in a file in the given directory, named for the geometry and
+         * settings, and reuse it rather than decomposing again if it's already there. Not
+         * done when block cost factors are set, as when rebalancing.
+         * @param directory
+         */
+        void SetDecompositionCache(const std::string& directory);
+
       private:
         /**
          * Read from the file into a buffer. We read this on a single core then broadcast it.
@@ -130,6 +162,24 @@ namespace hemelb
 
         void ValidateGeometry(const Geometry& geometry);
 
+        /**
+         * Read this rank's blocks and their sites' ranks from the decomposition cache, if the
+         * decomposition is there.
+         * @param geometry
+         * @param cache
+         * @param dataFilePath
+         * @param fileInfo
+         * @return Whether it was
+         */
+        bool ReadCachedDecomposition(Geometry& geometry, decomposition::DecompositionCache& cache,
+                                     const std::string& dataFilePath, MPI_Info fileInfo);
+
+        /**
+         * A hash of everything besides the geometry that the decomposition depends on.
+         * @return
+         */
+        uint64_t HashDecompositionSettings() const;
+
         /**
          * Get the length of the header section, given the number of blocks.
          *
@@ -180,6 +230,14 @@ namespace hemelb
         std::vector<unsigned int> bytesPerUncompressedBlock;
         //! The processor assigned to each block.
         std::vector<proc_t> principalProcForEachBlock;
+        //! The factor to scale the weights of the sites on each block by, or empty not to.
+        std::vector<float> blockCostFactors;
+        //! The weight of a site of each collision type.
+        decomposition::SiteWeights siteWeights;
+        //! How the optimised decomposition splits the sites between the ranks.
+        decomposition::Partitioner partitioner;
+        //! The directory to cache the decomposition in, or empty not to.
+        std::string decompositionCacheDirectory;
 
         //! Timings object for recording the time taken for each step of the domain decomposition.
         hemelb::reporting::Timers &timings;
@@ -4,10 +4,12 @@
 // file AUTHORS. This software is provided under the terms of the
 // license in the file LICENSE.
 
+#include <algorithm>
 #include <map>
 #include <limits>
 
 #include "debug/Debugger.h"
+#include "Exception.h"
 #include "log/Logger.h"
 #include "net/IOCommunicator.h"
 #include "geometry/BlockTraverser.h"
@@ -19,8 +21,37 @@ namespace hemelb
 {
   namespace geometry
   {
+    namespace
+    {
+      /**
+       * Get the index of the collision type of a site, which orders the site ranges of each
+       * rank.
+       */
+      int GetCollisionTypeIndex(const SiteData& siteData)
+      {
+        switch (siteData.GetCollisionType())
+        {
+          case FLUID:
+            return 0;
+          case WALL:
+            return 1;
+          case INLET:
+            return 2;
+          case OUTLET:
+            return 3;
+          case (INLET | WALL):
+            return 4;
+          case (OUTLET | WALL):
+            return 5;
+        }
+        return -1;
+      }
+    }
+
     LatticeData::LatticeData(const lb::lattices::LatticeInfo& latticeInfo, const net::IOCommunicator& comms_) :
-        latticeInfo(latticeInfo), neighbouringData(new neighbouring::NeighbouringLatticeData(latticeInfo)), comms(comms_)
+        latticeInfo(latticeInfo), denseBlockSiteCount(0), haloSiteCount(0),
+            haloProcCollisions(halo::DEPTH * COLLISION_TYPES, 0), oddStep(false), stepsSinceHaloExchange(0),
+            neighbouringData(new neighbouring::NeighbouringLatticeData(latticeInfo)), comms(comms_)
     {
     }
 
@@ -30,7 +61,48 @@ namespace hemelb
     }
 
     LatticeData::LatticeData(const lb::lattices::LatticeInfo& latticeInfo, const Geometry& readResult, const net::IOCommunicator& comms_) :
-        latticeInfo(latticeInfo), neighbouringData(new neighbouring::NeighbouringLatticeData(latticeInfo)), comms(comms_)
+        latticeInfo(latticeInfo), denseBlockSiteCount(0), haloSiteCount(0),
+            haloProcCollisions(halo::DEPTH * COLLISION_TYPES, 0), oddStep(false), stepsSinceHaloExchange(0),
+            neighbouringData(new neighbouring::NeighbouringLatticeData(latticeInfo)), comms(comms_)
+    {
+      Build(readResult);
+    }
+
+    void LatticeData::Rebuild(const Geometry& readResult)
+    {
+      // Put back everything that the constructor starts from, or that building adds to rather
+      // than overwrites.
+      neighbouringProcs.clear();
+      denseBlockSiteCount = 0;
+      haloSiteCount = 0;
+      haloProcCollisions.assign(halo::DEPTH * COLLISION_TYPES, 0);
+      oddStep = false;
+      stepsSinceHaloExchange = 0;
+      blocks.clear();
+      distanceToWall.clear();
+      globalSiteCoords.clear();
+      wallNormalAtSite.clear();
+      siteData.clear();
+      linksByType.clear();
+      wallLinksBegin.clear();
+      ioletLinksBegin.clear();
+      wallLinksEnd.clear();
+      neighbourIndices.clear();
+      streamingIndicesForReceivedDistributions.clear();
+      haloSiteRanks.clear();
+      haloSiteIndices.clear();
+      haloSendBuffer.clear();
+      haloReceiveBuffer.clear();
+      oldDistributions.clear();
+      newDistributions.clear();
+
+      delete neighbouringData;
+      neighbouringData = new neighbouring::NeighbouringLatticeData(latticeInfo);
+
+      Build(readResult);
+    }
+
+    void LatticeData::Build(const Geometry& readResult)
     {
       SetBasicDetails(readResult.GetBlockDimensions(),
                       readResult.GetBlockSize());
@@ -55,6 +127,36 @@ namespace hemelb
       InitialiseNeighbourLookups();
     }
 
+    void LatticeData::GetLocalDistributions(std::vector<distribn_t>& distributions) const
+    {
+      const Direction numVectors = latticeInfo.GetNumVectors();
+      distributions.resize(localFluidSites * numVectors);
+      for (site_t siteIndex = 0; siteIndex < localFluidSites; siteIndex++)
+      {
+        for (Direction direction = 0; direction < numVectors; direction++)
+        {
+          distributions[siteIndex * numVectors + direction] = GetFOldValue(GetFOldIndex(siteIndex, direction),
+                                                                           direction);
+        }
+      }
+    }
+
+    void LatticeData::SetLocalDistributions(const std::vector<distribn_t>& distributions)
+    {
+      oddStep = false;
+      const Direction numVectors = latticeInfo.GetNumVectors();
+      for (site_t siteIndex = 0; siteIndex < localFluidSites; siteIndex++)
+      {
+        for (Direction direction = 0; direction < numVectors; direction++)
+        {
+          const site_t index = GetDistributionIndex(siteIndex, direction);
+          *GetFNew(index) = DistributionStorage::Encode(distributions[siteIndex * numVectors + direction],
+                                                        latticeInfo.GetWeight(direction));
+          *GetFOld(index) = *GetFNew(index);
+        }
+      }
+    }
+
     void LatticeData::SetBasicDetails(util::Vector3D<site_t> blocksIn,
                                       site_t blockSizeIn)
     {
@@ -81,6 +183,7 @@ namespace hemelb
       std::vector<util::Vector3D<float> > midDomainWallNormals[COLLISION_TYPES];
       std::vector<float> domainEdgeWallDistance[COLLISION_TYPES];
       std::vector<float> midDomainWallDistance[COLLISION_TYPES];
+      std::vector<util::Vector3D<site_t> > edgeSites;
 
       proc_t localRank = comms.Rank();
       // Iterate over all blocks in site units
@@ -157,6 +260,11 @@ namespace hemelb
               continue;
             }
             isMidDomainSite = false;
+            // With a deep halo, the neighbour is a halo site, streamed to like any other.
+            if (halo::DEPTH > 1)
+            {
+              continue;
+            }
             totalSharedFs++;
 
             // The first time, net_neigh_procs = 0, so
@@ -206,28 +314,7 @@ namespace hemelb
           // Set the collision type data. map_block site data is renumbered according to
           // fluid site numbers within a particular collision type.
           SiteData siteData(blockReadIn.Sites[localSiteId]);
-          int l = -1;
-          switch (siteData.GetCollisionType())
-          {
-            case FLUID:
-              l = 0;
-              break;
-            case WALL:
-              l = 1;
-              break;
-            case INLET:
-              l = 2;
-              break;
-            case OUTLET:
-              l = 3;
-              break;
-            case (INLET | WALL):
-              l = 4;
-              break;
-            case (OUTLET | WALL):
-              l = 5;
-              break;
-          }
+          int l = GetCollisionTypeIndex(siteData);
 
           const util::Vector3D<float>& normal = blockReadIn.Sites[localSiteId].wallNormalAvailable ?
             blockReadIn.Sites[localSiteId].wallNormal :
@@ -246,6 +333,11 @@ namespace hemelb
           }
           else
           {
+            if (halo::DEPTH > 1)
+            {
+              edgeSites.push_back(blockTraverser.GetCurrentLocation() * readResult.GetBlockSize()
+                  + siteTraverser.GetCurrentLocation());
+            }
             domainEdgeBlockNumber[l].push_back(blockId);
             domainEdgeSiteNumber[l].push_back(localSiteId);
             domainEdgeSiteData[l].push_back(siteData);
@@ -270,6 +362,193 @@ namespace hemelb
                            domainEdgeSiteData,
                            domainEdgeWallNormals,
                            domainEdgeWallDistance);
+
+      if (halo::DEPTH > 1)
+      {
+        ProcessHaloSites(readResult, edgeSites);
+      }
+    }
+
+    void LatticeData::ProcessHaloSites(const Geometry& readResult,
+                                       const std::vector<util::Vector3D<site_t> >& edgeSites)
+    {
+      const std::vector<std::vector<util::Vector3D<site_t> > > layers =
+          halo::FindHaloLayers(readResult, latticeInfo, comms.Rank(), edgeSites, halo::DEPTH);
+
+      // The halo sites follow the local ones, layer by layer and then, as for the local sites,
+      // by collision type, so that each step can update just the layers that are up to date.
+      for (unsigned layer = 1; layer <= halo::DEPTH; layer++)
+      {
+        std::vector<site_t> blockNumbers[COLLISION_TYPES];
+        std::vector<site_t> siteNumbers[COLLISION_TYPES];
+        for (std::vector<util::Vector3D<site_t> >::const_iterator it = layers[layer - 1].begin();
+            it != layers[layer - 1].end(); ++it)
+        {
+          util::Vector3D<site_t> blockCoords, siteCoords;
+          GetBlockAndLocalSiteCoords(*it, blockCoords, siteCoords);
+          const site_t blockId = GetBlockIdFromBlockCoords(blockCoords);
+          const site_t siteId = GetLocalSiteIdFromLocalSiteCoords(siteCoords);
+          const int collisionType = GetCollisionTypeIndex(SiteData(readResult.Blocks[blockId].Sites[siteId]));
+          blockNumbers[collisionType].push_back(blockId);
+          siteNumbers[collisionType].push_back(siteId);
+        }
+
+        for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; collisionType++)
+        {
+          haloProcCollisions[ (layer - 1) * COLLISION_TYPES + collisionType] = blockNumbers[collisionType].size();
+          const std::vector<site_t> order = GetSiteOrder(blockNumbers[collisionType], siteNumbers[collisionType]);
+          for (std::vector<site_t>::const_iterator indexInType = order.begin(); indexInType != order.end();
+              ++indexInType)
+          {
+            const site_t blockId = blockNumbers[collisionType][*indexInType];
+            const site_t siteId = siteNumbers[collisionType][*indexInType];
+            const GeometrySite& site = readResult.Blocks[blockId].Sites[siteId];
+
+            siteData.push_back(SiteData(site));
+            wallNormalAtSite.push_back(site.wallNormalAvailable ?
+              site.wallNormal :
+              util::Vector3D<float>(NO_VALUE));
+            for (Direction direction = 1; direction < latticeInfo.GetNumVectors(); direction++)
+            {
+              distanceToWall.push_back(site.links[direction - 1].distanceToIntersection);
+            }
+            const util::Vector3D<site_t> globalCoords = GetGlobalCoords(blockId, GetSiteCoordsFromSiteId(siteId));
+            globalSiteCoords.push_back(globalCoords);
+            haloSiteIndices[GetGlobalNoncontiguousSiteIdFromGlobalCoords(globalCoords)] = localFluidSites
+                + haloSiteCount;
+            haloSiteRanks.push_back(site.targetProcessor);
+            haloSiteCount++;
+          }
+        }
+      }
+
+      // Every rank that owns a halo site is a neighbour. As each site is in the halo of the
+      // other's just when the other is in its, this is the same set of ranks that have halo
+      // sites on this one.
+      neighbouringProcs.clear();
+      std::map<proc_t, size_t> neighbourIds;
+      for (std::vector<proc_t>::const_iterator rank = haloSiteRanks.begin(); rank != haloSiteRanks.end(); ++rank)
+      {
+        if (neighbourIds.find(*rank) == neighbourIds.end())
+        {
+          neighbourIds[*rank] = neighbouringProcs.size();
+          NeighbouringProcessor newNeighbour;
+          newNeighbour.Rank = *rank;
+          neighbouringProcs.push_back(newNeighbour);
+        }
+        ++neighbouringProcs[neighbourIds[*rank]].ReceivedHaloSiteCount;
+      }
+
+      InitialiseLinkTypes();
+      AllocateDistributions();
+    }
+
+    void LatticeData::AllocateDistributions()
+    {
+      allocatedFluidSites = DistributionLayout::GetAllocatedSiteCount(localFluidSites + haloSiteCount);
+#ifdef HEMELB_USE_AA_STREAMING
+      // A single array, with the shared distributions followed by separate buffers for
+      // those received in the even and the odd steps.
+      oldDistributions.resize(GetRubbishDistributionIndex() + 1 + 3 * totalSharedFs);
+#elif defined(HEMELB_USE_SHARED_WINDOWS)
+      // Put the arrays in windows shared with the other processes on this node, so that
+      // neighbours here can read the distributions streamed to them straight out of them.
+      nodeComms = comms.SplitShared();
+      const DistributionArray::allocator_type allocator(nodeComms);
+      oldDistributions = DistributionArray(GetRubbishDistributionIndex() + 1 + totalSharedFs,
+                                           distribn_storage_t(),
+                                           allocator);
+      newDistributions = DistributionArray(GetRubbishDistributionIndex() + 1 + totalSharedFs,
+                                           distribn_storage_t(),
+                                           allocator);
+#else
+      oldDistributions.resize(GetRubbishDistributionIndex() + 1 + totalSharedFs);
+      newDistributions.resize(GetRubbishDistributionIndex() + 1 + totalSharedFs);
+#endif
+    }
+
+    std::vector<site_t> LatticeData::GetSiteOrder(const std::vector<site_t>& blockNumbers,
+                                                  const std::vector<site_t>& siteNumbers) const
+    {
+      std::vector<site_t> order(blockNumbers.size());
+      for (site_t indexInType = 0; indexInType < (site_t) order.size(); indexInType++)
+      {
+        order[indexInType] = indexInType;
+      }
+
+      if (SiteOrdering::REORDER)
+      {
+        std::vector<uint64_t> keys(order.size());
+        for (site_t indexInType = 0; indexInType < (site_t) order.size(); indexInType++)
+        {
+          keys[indexInType] =
+              SiteOrdering::GetKey(GetGlobalCoords(blockNumbers[indexInType],
+                                                   GetSiteCoordsFromSiteId(siteNumbers[indexInType])));
+        }
+
+        // The neighbour and receive lookups are built afterwards from the numbering this gives,
+        // so they follow the new order automatically.
+        std::stable_sort(order.begin(), order.end(), [&keys](site_t a, site_t b)
+        {
+          return keys[a] < keys[b];
+        });
+      }
+
+      return order;
+    }
+
+    void LatticeData::InitialiseLinkTypes()
+    {
+      linksByType.resize( (localFluidSites + haloSiteCount) * latticeInfo.GetNumVectors());
+      wallLinksBegin.resize(localFluidSites + haloSiteCount);
+      ioletLinksBegin.resize(localFluidSites + haloSiteCount);
+      wallLinksEnd.resize(localFluidSites + haloSiteCount);
+      for (site_t siteIndex = 0; siteIndex < localFluidSites + haloSiteCount; siteIndex++)
+      {
+        SetLinkTypes(siteIndex);
+      }
+    }
+
+    void LatticeData::SetLinkTypes(site_t siteIndex)
+    {
+      const SiteData& data = siteData[siteIndex];
+      uint8_t* links = &linksByType[siteIndex * latticeInfo.GetNumVectors()];
+      unsigned linkCount = 0;
+
+      for (Direction direction = 0; direction < latticeInfo.GetNumVectors(); direction++)
+      {
+        if (!data.HasWall(direction) && !data.HasIolet(direction))
+        {
+          links[linkCount++] = direction;
+        }
+      }
+      wallLinksBegin[siteIndex] = linkCount;
+
+      for (Direction direction = 0; direction < latticeInfo.GetNumVectors(); direction++)
+      {
+        if (data.HasWall(direction) && !data.HasIolet(direction))
+        {
+          links[linkCount++] = direction;
+        }
+      }
+      ioletLinksBegin[siteIndex] = linkCount;
+
+      for (Direction direction = 0; direction < latticeInfo.GetNumVectors(); direction++)
+      {
+        if (data.HasWall(direction) && data.HasIolet(direction))
+        {
+          links[linkCount++] = direction;
+        }
+      }
+      wallLinksEnd[siteIndex] = linkCount;
+
+      for (Direction direction = 0; direction < latticeInfo.GetNumVectors(); direction++)
+      {
+        if (!data.HasWall(direction) && data.HasIolet(direction))
+        {
+          links[linkCount++] = direction;
+        }
+      }
     }
 
     void LatticeData::CollectFluidSiteDistribution()
@@ -342,19 +621,45 @@ namespace hemelb
       {
         // Pointing to a few things, but not setting any variables.
         // FirstSharedF points to start of shared_fs.
-        neighbouringProcs[neighbourId].FirstSharedDistribution = GetLocalFluidSiteCount() * latticeInfo.GetNumVectors()
-            + 1 + totalSharedDistributionsSoFar;
+        neighbouringProcs[neighbourId].FirstSharedDistribution = GetRubbishDistributionIndex() + 1
+            + totalSharedDistributionsSoFar;
         totalSharedDistributionsSoFar += neighbouringProcs[neighbourId].SharedDistributionCount;
       }
       InitialiseNeighbourLookup(sharedDistributionLocationForEachProc);
-      InitialisePointToPointComms(sharedDistributionLocationForEachProc);
-      InitialiseReceiveLookup(sharedDistributionLocationForEachProc);
+      if (halo::DEPTH > 1)
+      {
+        InitialiseHaloExchange();
+      }
+      else
+      {
+        InitialisePointToPointComms(sharedDistributionLocationForEachProc);
+        InitialiseReceiveLookup(sharedDistributionLocationForEachProc);
+#ifdef HEMELB_USE_SHARED_WINDOWS
+        InitialiseSharedWindowExchange();
+#endif
+      }
     }
 
     void LatticeData::InitialiseNeighbourLookup(std::vector<std::vector<site_t> >& sharedFLocationForEachProc)
     {
       const proc_t localRank = comms.Rank();
-      neighbourIndices.resize(latticeInfo.GetNumVectors() * localFluidSites);
+
+      // Every index streamed to must be representable in the lookup tables.
+      if (oldDistributions.size() - 1 > (size_t) std::numeric_limits<streaming_index_t>::max())
+      {
+        throw Exception() << "Rank " << localRank << " holds " << oldDistributions.size()
+            << " distributions, too many to index with " << sizeof(streaming_index_t) * 8
+            << "-bit streaming indices";
+      }
+
+      // The interior sites of dense blocks have no rows in the table, as their neighbours are
+      // at fixed offsets.
+      denseBlockTableRowCount = denseblocks::NumberTableRows(blockSize, denseBlockTableRows);
+      const site_t tableRows = (denseBlockSiteCount / sitesPerBlockVolumeUnit) * denseBlockTableRowCount
+          + allocatedFluidSites - denseBlockSiteCount;
+
+      // Any padding sites the layout needs stream to the rubbish site.
+      neighbourIndices.resize(latticeInfo.GetNumVectors() * tableRows, GetRubbishDistributionIndex());
       for (BlockTraverser blockTraverser(*this); blockTraverser.CurrentLocationValid(); blockTraverser.TraverseOne())
       {
         const Block& map_block_p = blockTraverser.GetCurrentBlockData();
@@ -373,7 +678,7 @@ namespace hemelb
           site_t localIndex = map_block_p.GetLocalContiguousIndexForSite(siteTraverser.GetCurrentIndex());
           // Set neighbour location for the distribution component at the centre of
           // this site.
-          SetNeighbourLocation(localIndex, 0, localIndex * latticeInfo.GetNumVectors() + 0);
+          SetNeighbourLocation(localIndex, 0, GetDistributionIndex(localIndex, 0));
           for (Direction direction = 1; direction < latticeInfo.GetNumVectors(); direction++)
           {
             util::Vector3D<site_t> currentLocationCoords = blockTraverser.GetCurrentLocation() * blockSize
@@ -384,7 +689,7 @@ namespace hemelb
             if (!IsValidLatticeSite(neighbourCoords))
             {
               // Set the neighbour location to the rubbish site.
-              SetNeighbourLocation(localIndex, direction, GetLocalFluidSiteCount() * latticeInfo.GetNumVectors());
+              SetNeighbourLocation(localIndex, direction, GetRubbishDistributionIndex());
               continue;
             }
             // Get the id of the processor which the neighbouring site lies on.
@@ -392,7 +697,7 @@ namespace hemelb
             if (proc_id_p == SITE_OR_BLOCK_SOLID)
             {
               // initialize f_id to the rubbish site.
-              SetNeighbourLocation(localIndex, direction, GetLocalFluidSiteCount() * latticeInfo.GetNumVectors());
+              SetNeighbourLocation(localIndex, direction, GetRubbishDistributionIndex());
               continue;
             }
             else
@@ -406,9 +711,20 @@ namespace hemelb
             {
               // Pointer to the neighbour.
               site_t contigSiteId = GetContiguousSiteId(neighbourCoords);
-              SetNeighbourLocation(localIndex, direction, contigSiteId * latticeInfo.GetNumVectors() + direction);
+              SetNeighbourLocation(localIndex, direction, GetDistributionIndex(contigSiteId, direction));
               continue;
             }
+            else if (halo::DEPTH > 1)
+            {
+              // With a deep halo, every fluid neighbour on another rank is a halo site.
+              site_t haloSiteId;
+              if (!GetHaloSiteIndex(neighbourCoords, haloSiteId))
+              {
+                throw Exception() << "Rank " << localRank << " has no halo site for the neighbour at "
+                    << neighbourCoords << " of local site " << localIndex;
+              }
+              SetNeighbourLocation(localIndex, direction, GetDistributionIndex(haloSiteId, direction));
+            }
             else
             {
               // This stores some coordinates.  We
@@ -429,6 +745,37 @@ namespace hemelb
 
       }
 
+      // The halo sites stream to the local and other halo sites around them. What they would
+      // stream out of the halo is thrown away, which is why the outermost layer that is up to
+      // date goes stale on each step.
+      for (site_t haloSiteId = localFluidSites; haloSiteId < localFluidSites + haloSiteCount; haloSiteId++)
+      {
+        SetNeighbourLocation(haloSiteId, 0, GetDistributionIndex(haloSiteId, 0));
+        for (Direction direction = 1; direction < latticeInfo.GetNumVectors(); direction++)
+        {
+          const util::Vector3D<site_t> neighbourCoords = globalSiteCoords[haloSiteId]
+              + util::Vector3D<site_t>(latticeInfo.GetVector(direction));
+          site_t neighbourId;
+          if (!IsValidLatticeSite(neighbourCoords))
+          {
+            SetNeighbourLocation(haloSiteId, direction, GetRubbishDistributionIndex());
+          }
+          else if (GetProcIdFromGlobalCoords(neighbourCoords) == localRank)
+          {
+            SetNeighbourLocation(haloSiteId,
+                                 direction,
+                                 GetDistributionIndex(GetContiguousSiteId(neighbourCoords), direction));
+          }
+          else if (GetHaloSiteIndex(neighbourCoords, neighbourId))
+          {
+            SetNeighbourLocation(haloSiteId, direction, GetDistributionIndex(neighbourId, direction));
+          }
+          else
+          {
+            SetNeighbourLocation(haloSiteId, direction, GetRubbishDistributionIndex());
+          }
+        }
+      }
     }
 
     void LatticeData::InitialisePointToPointComms(std::vector<std::vector<site_t> >& sharedFLocationForEachProc)
@@ -467,7 +814,7 @@ namespace hemelb
     {
       proc_t localRank = comms.Rank();
       streamingIndicesForReceivedDistributions.resize(totalSharedFs);
-      site_t f_count = GetLocalFluidSiteCount() * latticeInfo.GetNumVectors();
+      site_t f_count = GetRubbishDistributionIndex();
       site_t sharedSitesSeen = 0;
       for (size_t neighbourId = 0; neighbourId < neighbouringProcs.size(); neighbourId++)
       {
@@ -497,8 +844,8 @@ namespace hemelb
           SetNeighbourLocation(contigSiteId, (unsigned int) ( (l)), ++f_count);
           // Set the place where we put the received distribution functions, which is
           // f_new[number of fluid site that sends, inverse direction].
-          streamingIndicesForReceivedDistributions[sharedSitesSeen] = contigSiteId * latticeInfo.GetNumVectors()
-              + latticeInfo.GetInverseIndex(l);
+          streamingIndicesForReceivedDistributions[sharedSitesSeen] =
+              (streaming_index_t) GetDistributionIndex(contigSiteId, latticeInfo.GetInverseIndex(l));
           ++sharedSitesSeen;
         }
 
@@ -506,6 +853,127 @@ namespace hemelb
 
     }
 
+    void LatticeData::InitialiseSharedWindowExchange()
+    {
+#ifdef HEMELB_USE_SHARED_WINDOWS
+      const std::vector<int> ranksOnNode = nodeComms.AllGather(comms.Rank());
+      std::map<proc_t, int> nodeRanks;
+      for (size_t nodeRank = 0; nodeRank < ranksOnNode.size(); nodeRank++)
+      {
+        nodeRanks[ranksOnNode[nodeRank]] = (int) nodeRank;
+      }
+
+      // Each neighbour on this node tells this one where, in its arrays, it puts the
+      // distributions it streams here.
+      std::vector<site_t> neighbourOffsets(neighbouringProcs.size(), 0);
+      neighbourNodeRanks.assign(neighbouringProcs.size(), -1);
+      net::Net tempNet(comms);
+      for (size_t neighbourId = 0; neighbourId < neighbouringProcs.size(); neighbourId++)
+      {
+        std::map<proc_t, int>::const_iterator nodeRank = nodeRanks.find(neighbouringProcs[neighbourId].Rank);
+        if (nodeRank == nodeRanks.end())
+        {
+          continue;
+        }
+        neighbourNodeRanks[neighbourId] = nodeRank->second;
+        tempNet.RequestSendR(neighbouringProcs[neighbourId].FirstSharedDistribution, neighbouringProcs[neighbourId].Rank);
+        tempNet.RequestReceiveR(neighbourOffsets[neighbourId], neighbouringProcs[neighbourId].Rank);
+      }
+      tempNet.Dispatch();
+
+      neighbourSegmentsOfOld.assign(neighbouringProcs.size(), NULL);
+      neighbourSegmentsOfNew.assign(neighbouringProcs.size(), NULL);
+      for (size_t neighbourId = 0; neighbourId < neighbouringProcs.size(); neighbourId++)
+      {
+        if (neighbourNodeRanks[neighbourId] >= 0)
+        {
+          neighbourSegmentsOfOld[neighbourId] = DistributionArray::allocator_type::GetSegment(&oldDistributions[0],
+                                                                                              neighbourNodeRanks[neighbourId])
+              + neighbourOffsets[neighbourId];
+          neighbourSegmentsOfNew[neighbourId] = DistributionArray::allocator_type::GetSegment(&newDistributions[0],
+                                                                                              neighbourNodeRanks[neighbourId])
+              + neighbourOffsets[neighbourId];
+        }
+      }
+      sendTokens.assign(neighbouringProcs.size(), 0);
+      receiveTokens.assign(neighbouringProcs.size(), 0);
+#endif
+    }
+
+    void LatticeData::InitialiseHaloExchange()
+    {
+      // Group the halo sites by the neighbour that owns them.
+      site_t haloSitesSoFar = 0;
+      std::map<proc_t, size_t> neighbourIds;
+      for (size_t neighbourId = 0; neighbourId < neighbouringProcs.size(); neighbourId++)
+      {
+        neighbouringProcs[neighbourId].FirstReceivedHaloSite = haloSitesSoFar;
+        haloSitesSoFar += neighbouringProcs[neighbourId].ReceivedHaloSiteCount;
+        neighbourIds[neighbouringProcs[neighbourId].Rank] = neighbourId;
+      }
+
+      haloSitesToReceive.clear();
+      haloSitesToReceive.resize(haloSiteCount);
+      std::vector<std::vector<site_t> > locationsToReceive(neighbouringProcs.size());
+      for (site_t haloSiteId = localFluidSites; haloSiteId < localFluidSites + haloSiteCount; haloSiteId++)
+      {
+        const size_t neighbourId = neighbourIds[haloSiteRanks[haloSiteId - localFluidSites]];
+        std::vector<site_t>& locations = locationsToReceive[neighbourId];
+        haloSitesToReceive[neighbouringProcs[neighbourId].FirstReceivedHaloSite + locations.size() / 3] = haloSiteId;
+        locations.push_back(globalSiteCoords[haloSiteId].x);
+        locations.push_back(globalSiteCoords[haloSiteId].y);
+        locations.push_back(globalSiteCoords[haloSiteId].z);
+      }
+
+      // Tell each neighbour which of its sites are in the halo here, and find out which sites
+      // here are in its halo. Neither side knows in advance how many sites the other needs.
+      net::Net tempNet(comms);
+      for (std::vector<NeighbouringProcessor>::iterator it = neighbouringProcs.begin(); it != neighbouringProcs.end();
+          ++it)
+      {
+        tempNet.RequestSendR(it->ReceivedHaloSiteCount, it->Rank);
+        tempNet.RequestReceiveR(it->SentHaloSiteCount, it->Rank);
+      }
+      tempNet.Dispatch();
+
+      std::vector<std::vector<site_t> > locationsToSend(neighbouringProcs.size());
+      for (size_t neighbourId = 0; neighbourId < neighbouringProcs.size(); neighbourId++)
+      {
+        locationsToSend[neighbourId].resize(3 * neighbouringProcs[neighbourId].SentHaloSiteCount);
+        tempNet.RequestSendV(locationsToReceive[neighbourId], neighbouringProcs[neighbourId].Rank);
+        tempNet.RequestReceiveV(locationsToSend[neighbourId], neighbouringProcs[neighbourId].Rank);
+      }
+      tempNet.Dispatch();
+
+      haloSitesToSend.clear();
+      for (size_t neighbourId = 0; neighbourId < neighbouringProcs.size(); neighbourId++)
+      {
+        neighbouringProcs[neighbourId].FirstSentHaloSite = haloSitesToSend.size();
+        for (site_t sentSite = 0; sentSite < neighbouringProcs[neighbourId].SentHaloSiteCount; sentSite++)
+        {
+          const site_t* location = &locationsToSend[neighbourId][3 * sentSite];
+          haloSitesToSend.push_back(GetContiguousSiteId(util::Vector3D<site_t>(location[0],
+                                                                               location[1],
+                                                                               location[2])));
+        }
+      }
+
+      haloSendBuffer.resize(haloSitesToSend.size() * latticeInfo.GetNumVectors());
+      haloReceiveBuffer.resize(haloSitesToReceive.size() * latticeInfo.GetNumVectors());
+    }
+
+    bool LatticeData::GetHaloSiteIndex(const util::Vector3D<site_t>& globalLocation, site_t& siteIndex) const
+    {
+      std::map<site_t, site_t>::const_iterator it =
+          haloSiteIndices.find(GetGlobalNoncontiguousSiteIdFromGlobalCoords(globalLocation));
+      if (it == haloSiteIndices.end())
+      {
+        return false;
+      }
+      siteIndex = it->second;
+      return true;
+    }
+
     proc_t LatticeData::GetProcIdFromGlobalCoords(const util::Vector3D<site_t>& globalSiteCoords) const
     {
       // Block identifiers (i, j, k) of the site (site_i, site_j, site_k)
@@ -655,29 +1123,141 @@ namespace hemelb
 
     void LatticeData::SendAndReceive(hemelb::net::Net* net)
     {
+      if (halo::DEPTH > 1)
+      {
+        // With a deep halo, nothing crosses between ranks while streaming. Instead, every
+        // halo::DEPTH steps, the halo is brought up to date with the distributions its sites
+        // start the step with on their own ranks.
+        if (stepsSinceHaloExchange != 0)
+        {
+          return;
+        }
+        const Direction numVectors = latticeInfo.GetNumVectors();
+        for (size_t sentSite = 0; sentSite < haloSitesToSend.size(); sentSite++)
+        {
+          for (Direction direction = 0; direction < numVectors; direction++)
+          {
+            haloSendBuffer[sentSite * numVectors + direction] =
+                *GetFOld(GetDistributionIndex(haloSitesToSend[sentSite], direction));
+          }
+        }
+        for (std::vector<NeighbouringProcessor>::const_iterator it = neighbouringProcs.begin();
+            it != neighbouringProcs.end(); ++it)
+        {
+          net->RequestReceive<distribn_storage_t>(&haloReceiveBuffer[it->FirstReceivedHaloSite * numVectors],
+                                                  (int) (it->ReceivedHaloSiteCount * numVectors),
+                                                  it->Rank);
+          net->RequestSend<distribn_storage_t>(&haloSendBuffer[it->FirstSentHaloSite * numVectors],
+                                               (int) (it->SentHaloSiteCount * numVectors),
+                                               it->Rank);
+        }
+        return;
+      }
+
+#ifdef HEMELB_USE_AA_STREAMING
+      // With AA-pattern streaming, receive into the buffer for this step of the pair. The
+      // even step's buffer is still being read when the odd step's receives are posted.
+      const site_t receiveOffset = (oddStep ? 2 : 1) * totalSharedFs;
+#else
+      const site_t receiveOffset = 0;
+#endif
       for (std::vector<NeighbouringProcessor>::const_iterator it = neighbouringProcs.begin();
           it != neighbouringProcs.end(); ++it)
       {
+#ifdef HEMELB_USE_SHARED_WINDOWS
+        // Neighbours on this node read the distributions straight out of the other's fNew,
+        // so only need telling when they're ready. The token is sent after the writes are
+        // published (PublishStreamedDistributions) and the reader syncs again on receiving
+        // it (CopyReceived).
+        const size_t neighbourId = it - neighbouringProcs.begin();
+        if (neighbourNodeRanks[neighbourId] >= 0)
+        {
+          net->RequestReceive<char>(&receiveTokens[neighbourId], 1, (*it).Rank);
+          net->RequestSend<char>(&sendTokens[neighbourId], 1, (*it).Rank);
+          continue;
+        }
+#endif
         // Request the receive into the appropriate bit of FOld.
-        net->RequestReceive<distribn_t>(GetFOld( (*it).FirstSharedDistribution),
-                                        (int) ( ( (*it).SharedDistributionCount)),
-                                        (*it).Rank);
+        net->RequestReceive<distribn_storage_t>(GetFOld( (*it).FirstSharedDistribution + receiveOffset),
+                                                (int) ( ( (*it).SharedDistributionCount)),
+                                                (*it).Rank);
         // Request the send from the right bit of FNew.
-        net->RequestSend<distribn_t>(GetFNew( (*it).FirstSharedDistribution),
-                                     (int) ( ( (*it).SharedDistributionCount)),
-                                     (*it).Rank);
+        net->RequestSend<distribn_storage_t>(GetFNew( (*it).FirstSharedDistribution),
+                                             (int) ( ( (*it).SharedDistributionCount)),
+                                             (*it).Rank);
 
       }
     }
 
+    void LatticeData::PublishStreamedDistributions()
+    {
+#ifdef HEMELB_USE_SHARED_WINDOWS
+      if (!neighbouringProcs.empty())
+      {
+        HEMELB_MPI_CALL(MPI_Win_sync, (DistributionArray::allocator_type::GetWindow(&newDistributions[0])));
+      }
+#endif
+    }
+
     void LatticeData::CopyReceived()
     {
+      if (halo::DEPTH > 1)
+      {
+        // Overwrite the halo with the distributions received from the owners of its sites.
+        if (stepsSinceHaloExchange != 0)
+        {
+          return;
+        }
+        const Direction numVectors = latticeInfo.GetNumVectors();
+        for (size_t receivedSite = 0; receivedSite < haloSitesToReceive.size(); receivedSite++)
+        {
+          for (Direction direction = 0; direction < numVectors; direction++)
+          {
+            *GetFOld(GetDistributionIndex(haloSitesToReceive[receivedSite], direction)) =
+                haloReceiveBuffer[receivedSite * numVectors + direction];
+          }
+        }
+        return;
+      }
+
       // Copy the distribution functions received from the neighbouring
       // processors into the destination buffer "f_new".
+#ifdef HEMELB_USE_AA_STREAMING
+      // Distributions received in the even step of an AA-pattern pair are read straight from
+      // the receive buffer during the odd step (see GetFOldIndex).
+      if (!oddStep)
+      {
+        return;
+      }
+      const site_t receiveOffset = 2 * totalSharedFs;
+#else
+      const site_t receiveOffset = 0;
+#endif
+#ifdef HEMELB_USE_SHARED_WINDOWS
+      // Make the neighbours' writes to their fNew, published before they sent their tokens,
+      // visible before reading them.
+      if (!neighbouringProcs.empty())
+      {
+        HEMELB_MPI_CALL(MPI_Win_sync, (DistributionArray::allocator_type::GetWindow(&newDistributions[0])));
+      }
+      site_t sharedDistributionsSeen = 0;
+      for (size_t neighbourId = 0; neighbourId < neighbouringProcs.size(); neighbourId++)
+      {
+        const distribn_storage_t* received = neighbourNodeRanks[neighbourId] >= 0 ?
+          neighbourSegmentsOfNew[neighbourId] :
+          GetFOld(neighbouringProcs[neighbourId].FirstSharedDistribution);
+        for (site_t i = 0; i < neighbouringProcs[neighbourId].SharedDistributionCount; i++)
+        {
+          *GetFNew(streamingIndicesForReceivedDistributions[sharedDistributionsSeen + i]) = received[i];
+        }
+        sharedDistributionsSeen += neighbouringProcs[neighbourId].SharedDistributionCount;
+      }
+      return;
+#endif
       for (site_t i = 0; i < totalSharedFs; i++)
       {
         *GetFNew(streamingIndicesForReceivedDistributions[i]) = *GetFOld(neighbouringProcs[0].FirstSharedDistribution
-            + i);
+            + receiveOffset + i);
       }
     }
 
@@ -707,5 +1287,16 @@ namespace hemelb
       return comms.Rank();
     }
 
+    std::vector<proc_t> LatticeData::GetNeighbouringRanks() const
+    {
+      std::vector<proc_t> ranks;
+      for (std::vector<NeighbouringProcessor>::const_iterator it = neighbouringProcs.begin();
+          it != neighbouringProcs.end(); ++it)
+      {
+        ranks.push_back(it->Rank);
+      }
+      return ranks;
+    }
+
   }
 }
@@ -8,17 +8,24 @@
 #define HEMELB_GEOMETRY_LATTICEDATA_H
 
 #include <cstdio>
+#include <map>
 #include <vector>
 
 #include "net/net.h"
 #include "constants.h"
 #include "configuration/SimConfig.h"
 #include "geometry/Block.h"
+#include "geometry/DeepHalo.h"
+#include "geometry/DenseBlocks.h"
+#include "geometry/DistributionLayout.h"
+#include "geometry/DistributionStorage.h"
 #include "geometry/GeometryReader.h"
 #include "geometry/NeighbouringProcessor.h"
 #include "geometry/Site.h"
 #include "geometry/neighbouring/NeighbouringSite.h"
 #include "geometry/SiteData.h"
+#include "geometry/SiteOrdering.h"
+#include "net/SharedWindowAllocator.h"
 #include "reporting/Reportable.h"
 #include "reporting/Timers.h"
 #include "util/Vector3D.h"
@@ -33,6 +40,18 @@ namespace hemelb
 
   namespace geometry
   {
+    /**
+     * The type of the entries of the tables of indices that LatticeData streams to. These are
+     * re-read on every step, so building with HEMELB_USE_32BIT_STREAMING_INDICES halves their
+     * memory and bandwidth, as long as the distribution array of each rank has fewer than
+     * 2^32 entries.
+     */
+#ifdef HEMELB_USE_32BIT_STREAMING_INDICES
+    typedef uint32_t streaming_index_t;
+#else
+    typedef site_t streaming_index_t;
+#endif
+
     class LatticeData : public reporting::Reportable
     {
       public:
@@ -44,14 +63,72 @@ namespace hemelb
         virtual ~LatticeData();
 
         /**
-         * Swap the fOld and fNew arrays around.
+         * Discard the current decomposition and set up the lattice again from the sites of a
+         * new one, as the constructor does. The distributions are left zeroed, and laid out as
+         * at the start of an even step, for the caller to fill in. Collective.
+         * @param readResult
+         */
+        void Rebuild(const Geometry& readResult);
+
+        /**
+         * True if the distributions of the local sites are the whole state of the lattice, as
+         * they are at the end of a time step after which the deep halo is due to be exchanged
+         * and, with AA-pattern streaming, the step pair is complete. Only then can the lattice
+         * be rebuilt without losing anything.
+         * @return
+         */
+        inline bool IsRebuildable() const
+        {
+          return !oddStep && stepsSinceHaloExchange == 0;
+        }
+
+        /**
+         * Get the distributions of the local fluid sites at the start of this time step.
+         * @param distributions Set to the value in each direction of each site in turn
+         */
+        void GetLocalDistributions(std::vector<distribn_t>& distributions) const;
+
+        /**
+         * Set the distributions of the local fluid sites, as got by GetLocalDistributions, laid
+         * out as at the start of an even step. The halo is left for the next exchange to fill.
+         * @param distributions
+         */
+        void SetLocalDistributions(const std::vector<distribn_t>& distributions);
+
+        /**
+         * Swap the fOld and fNew arrays around. With AA-pattern streaming there is only one
+         * array, so this just moves on to the other half of the even/odd step pair.
          */
         inline void SwapOldAndNew()
         {
+#ifdef HEMELB_USE_AA_STREAMING
+          oddStep = !oddStep;
+#else
           oldDistributions.swap(newDistributions);
+          neighbourSegmentsOfOld.swap(neighbourSegmentsOfNew);
+#endif
+          stepsSinceHaloExchange = (stepsSinceHaloExchange + 1) % halo::DEPTH;
+        }
+
+        /**
+         * True if the current time step is the odd one of an AA-pattern pair. Always false
+         * with the usual two-array streaming.
+         * @return
+         */
+        inline bool IsOddStep() const
+        {
+          return oddStep;
         }
 
         void SendAndReceive(net::Net* net);
+
+        /**
+         * Make the distributions just streamed to neighbours on this node visible to them, if
+         * the distribution arrays are shared. Must come after streaming the domain-edge sites
+         * and before the sends requested by SendAndReceive tell the neighbours they're ready.
+         */
+        void PublishStreamedDistributions();
+
         void CopyReceived();
 
         /**
@@ -143,13 +220,146 @@ namespace hemelb
         bool IsValidLatticeSite(const util::Vector3D<site_t>& siteCoords) const;
 
         /**
-         * Get a pointer into the fNew array at the given index
+         * Get the index into the distribution arrays of the given site's distribution in the
+         * given direction. This depends on the DistributionLayout chosen at build time.
+         * @param siteIndex
+         * @param direction
+         * @return
+         */
+        template<typename LatticeType>
+        inline site_t GetDistributionIndex(site_t siteIndex, Direction direction) const
+        {
+          return DistributionLayout::GetIndex(siteIndex, direction, LatticeType::NUMVECTORS, allocatedFluidSites);
+        }
+
+        /**
+         * Non-templated version of GetDistributionIndex, for when you haven't got a lattice type handy
+         * @param siteIndex
+         * @param direction
+         * @return
+         */
+        inline site_t GetDistributionIndex(site_t siteIndex, Direction direction) const
+        {
+          return DistributionLayout::GetIndex(siteIndex, direction, latticeInfo.GetNumVectors(), allocatedFluidSites);
+        }
+
+        /**
+         * Get the index of the 'rubbish site', the single extra position in the distribution
+         * arrays, after all the local sites, that distributions streaming out of the
+         * geometry are sent to.
+         * @return
+         */
+        inline site_t GetRubbishDistributionIndex() const
+        {
+          return allocatedFluidSites * latticeInfo.GetNumVectors();
+        }
+
+        /**
+         * True if the distributions of each site are contiguous and stored as distribn_t, so
+         * that Site::GetFOld can hand out a pointer straight into the fOld array.
+         */
+#ifdef HEMELB_USE_AA_STREAMING
+        static const bool SITE_CONTIGUOUS_DISTRIBUTIONS = false;
+#else
+        static const bool SITE_CONTIGUOUS_DISTRIBUTIONS = DistributionLayout::SITE_CONTIGUOUS
+            && DistributionStorage::EXACT;
+#endif
+
+        /**
+         * Get the index in the fOld array of the given site's distribution in the given
+         * direction at the start of this time step.
+         *
+         * With AA-pattern streaming the odd step of each pair reads each distribution from where
+         * the upstream site left it at the end of the even step: from that site's slot for the
+         * inverse direction, from the site's own slot if the upstream site isn't fluid, or from
+         * the copy received during the even step if the upstream site is on another rank.
+         * @param siteIndex
+         * @param direction
+         * @return
+         */
+        template<typename LatticeType>
+        inline site_t GetFOldIndex(site_t siteIndex, Direction direction) const
+        {
+#ifdef HEMELB_USE_AA_STREAMING
+          if (oddStep)
+          {
+            return GetOddStepFOldIndex(siteIndex,
+                                       direction,
+                                       GetNeighbourIndex<LatticeType>(siteIndex,
+                                                                      LatticeType::INVERSEDIRECTIONS[direction]));
+          }
+#endif
+          return GetDistributionIndex<LatticeType>(siteIndex, direction);
+        }
+
+        /**
+         * Non-templated version of GetFOldIndex, for when you haven't got a lattice type handy
+         * @param siteIndex
+         * @param direction
+         * @return
+         */
+        inline site_t GetFOldIndex(site_t siteIndex, Direction direction) const
+        {
+#ifdef HEMELB_USE_AA_STREAMING
+          if (oddStep)
+          {
+            return GetOddStepFOldIndex(siteIndex,
+                                       direction,
+                                       GetNeighbourIndex(siteIndex, latticeInfo.GetInverseIndex(direction)));
+          }
+#endif
+          return GetDistributionIndex(siteIndex, direction);
+        }
+
+        /**
+         * Get a pointer into the fNew array at the given index. With AA-pattern streaming,
+         * fNew and fOld are the same array.
          * @param distributionIndex
          * @return
          */
-        inline distribn_t* GetFNew(site_t distributionIndex)
+        inline distribn_storage_t* GetFNew(site_t distributionIndex)
         {
+#ifdef HEMELB_USE_AA_STREAMING
+          return &oldDistributions[distributionIndex];
+#else
           return &newDistributions[distributionIndex];
+#endif
+        }
+
+        /**
+         * Get a pointer to the fOld values, in the given direction, of count sites from
+         * siteIndex, if they lie one after the other and are stored as distribn_t. Otherwise
+         * returns NULL, and they must be read one at a time through GetFOldIndex.
+         * @param siteIndex
+         * @param count
+         * @param direction
+         * @return
+         */
+        template<typename LatticeType>
+        inline const distribn_t* GetContiguousFOld(site_t siteIndex, site_t count, Direction direction) const
+        {
+#ifdef HEMELB_USE_AA_STREAMING
+          if (oddStep)
+          {
+            return NULL;
+          }
+#endif
+          if (!DistributionLayout::AreSitesContiguous(siteIndex, count))
+          {
+            return NULL;
+          }
+          return AsExactDistributions(GetFOld(GetDistributionIndex<LatticeType>(siteIndex, direction)));
+        }
+
+        /**
+         * Get a pointer into the fNew array at the given index, if the distributions are stored
+         * as distribn_t. Otherwise returns NULL, and they must be written through SetFNewValue.
+         * @param distributionIndex
+         * @return
+         */
+        inline distribn_t* GetExactFNew(site_t distributionIndex)
+        {
+          return AsExactDistributions(GetFNew(distributionIndex));
         }
 
         /**
@@ -158,9 +368,121 @@ namespace hemelb
          * @param distributionIndex
          * @return
          */
-        inline const distribn_t* GetFNew(site_t siteNumber) const
+        inline const distribn_storage_t* GetFNew(site_t siteNumber) const
         {
+#ifdef HEMELB_USE_AA_STREAMING
+          return &oldDistributions[siteNumber];
+#else
           return &newDistributions[siteNumber];
+#endif
+        }
+
+        /**
+         * Get the value of the distribution at the given index in the fNew array.
+         * @param distributionIndex
+         * @param direction The direction of the distribution in that slot, or its inverse.
+         * @return
+         */
+        template<typename LatticeType>
+        inline distribn_t GetFNewValue(site_t distributionIndex, Direction direction) const
+        {
+          return DistributionStorage::Decode(*GetFNew(distributionIndex), LatticeType::EQMWEIGHTS[direction]);
+        }
+
+        /**
+         * Set the value of the distribution at the given index in the fNew array.
+         * @param distributionIndex
+         * @param direction The direction of the distribution in that slot, or its inverse.
+         * @param value
+         */
+        template<typename LatticeType>
+        inline void SetFNewValue(site_t distributionIndex, Direction direction, distribn_t value)
+        {
+          *GetFNew(distributionIndex) = DistributionStorage::Encode(value, LatticeType::EQMWEIGHTS[direction]);
+        }
+
+        /**
+         * Get the value of the distribution at the given index in the fOld array.
+         * @param distributionIndex
+         * @param direction The direction of the distribution in that slot, or its inverse.
+         * @return
+         */
+        template<typename LatticeType>
+        inline distribn_t GetFOldValue(site_t distributionIndex, Direction direction) const
+        {
+          return DistributionStorage::Decode(*GetFOld(distributionIndex), LatticeType::EQMWEIGHTS[direction]);
+        }
+
+        /**
+         * Non-templated version of GetFOldValue, for when you haven't got a lattice type handy
+         * @param distributionIndex
+         * @param direction
+         * @return
+         */
+        inline distribn_t GetFOldValue(site_t distributionIndex, Direction direction) const
+        {
+          return DistributionStorage::Decode(*GetFOld(distributionIndex), latticeInfo.GetWeight(direction));
+        }
+
+        /**
+         * Get the number of sites, at the start of the site array, that belong to dense blocks.
+         * Always zero unless built with HEMELB_USE_DENSE_BLOCKS.
+         * @return
+         */
+        inline site_t GetDenseBlockSiteCount() const
+        {
+          return denseBlockSiteCount;
+        }
+
+        /**
+         * True if the site is in a dense block and none of its neighbours lie outside that
+         * block, so that it has no entries in the neighbour index table and
+         * GetDenseBlockStreamedIndex can be used in place of GetStreamedIndex.
+         * @param siteIndex
+         * @return
+         */
+        inline bool IsDenseBlockInteriorSite(site_t siteIndex) const
+        {
+#ifdef HEMELB_USE_DENSE_BLOCKS
+          return siteIndex < denseBlockSiteCount
+              && denseblocks::IsInteriorSite(siteIndex % sitesPerBlockVolumeUnit, blockSize);
+#else
+          return false;
+#endif
+        }
+
+        /**
+         * True if the sites of the row along z of a dense block that starts at the given site
+         * index are interior sites, apart from the first and last.
+         * @param rowStartIndex
+         * @return
+         */
+        inline bool IsDenseBlockInteriorRow(site_t rowStartIndex) const
+        {
+          return denseblocks::IsInteriorRow(rowStartIndex % sitesPerBlockVolumeUnit, blockSize);
+        }
+
+        /**
+         * As GetStreamedIndex, but for a site for which IsDenseBlockInteriorSite is true. This
+         * works out the index from the site's position in its block, rather than reading it
+         * from the neighbour index table.
+         * @param siteIndex
+         * @param direction
+         * @return
+         */
+        template<typename LatticeType>
+        inline site_t GetDenseBlockStreamedIndex(site_t siteIndex, Direction direction) const
+        {
+#ifdef HEMELB_USE_AA_STREAMING
+          if (!oddStep)
+          {
+            return GetDistributionIndex<LatticeType>(siteIndex, LatticeType::INVERSEDIRECTIONS[direction]);
+          }
+#endif
+          return GetDistributionIndex<LatticeType>(siteIndex
+                                                       + denseblocks::GetNeighbourOffset<LatticeType>(direction,
+                                                                                                      blockSize),
+                                                   direction);
         }
 
         proc_t GetProcIdFromGlobalCoords(const util::Vector3D<site_t>& globalSiteCoords) const;
@@ -205,6 +527,41 @@ namespace hemelb
           return localFluidSites;
         }
 
+        /**
+         * Get the number of sites in the deep halo, numbered after the local fluid sites. Always
+         * zero unless built with HEMELB_HALO_DEPTH greater than one.
+         * @return
+         */
+        inline site_t GetHaloSiteCount() const
+        {
+          return haloSiteCount;
+        }
+
+        /**
+         * Number of sites of the given collision type in the given layer of the halo. The halo
+         * sites are ordered by layer, from the innermost (layer 1) outwards, and within each
+         * layer by collision type.
+         * @param layer
+         * @param collisionType
+         * @return
+         */
+        inline site_t GetHaloCollisionCount(unsigned layer, unsigned collisionType) const
+        {
+          return haloProcCollisions[ (layer - 1) * COLLISION_TYPES + collisionType];
+        }
+
+        /**
+         * Get the number of layers of the halo whose distributions are up to date at the start
+         * of this step, and so need to be updated during it. This is the whole halo on the step
+         * its distributions are received from their owners, and one layer fewer on each step
+         * after that.
+         * @return
+         */
+        inline unsigned GetUpToDateHaloDepth() const
+        {
+          return haloSiteCount == 0 ? 0 : halo::DEPTH - stepsSinceHaloExchange;
+        }
+
         site_t GetContiguousSiteId(util::Vector3D<site_t> location) const;
 
         /**
@@ -331,6 +688,12 @@ namespace hemelb
         neighbouring::NeighbouringLatticeData const &GetNeighbouringData() const;
 
         int GetLocalRank() const;
+
+        /**
+         * Get the ranks this one exchanges distributions with, in the order of
+         * neighbouringProcs.
+         */
+        std::vector<proc_t> GetNeighbouringRanks() const;
       protected:
         /**
          * The protected default constructor does nothing. It exists to allow derivation from this
@@ -339,6 +702,12 @@ namespace hemelb
          */
         LatticeData(const lb::lattices::LatticeInfo& latticeInfo, const net::IOCommunicator& comms);
 
+        /**
+         * Set up the lattice from the sites read, for the constructor and Rebuild.
+         * @param readResult
+         */
+        void Build(const Geometry& readResult);
+
         void SetBasicDetails(util::Vector3D<site_t> blocks,
                              site_t blockSize);
 
@@ -363,11 +732,27 @@ namespace hemelb
           }
           // Data about local sites.
           localFluidSites = 0;
-          // Data about contiguous local sites. First midDomain stuff, then domainEdge.
+          // Data about contiguous local sites. First midDomain stuff, then domainEdge. Within
+          // each collision type the sites are numbered in the order given by SiteOrdering.
+          denseBlockSiteCount = 0;
           for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; collisionType++)
           {
-            for (unsigned indexInType = 0; indexInType < midDomainProcCollisions[collisionType]; indexInType++)
+            std::vector<site_t> order = GetSiteOrder(midDomainBlockNumbers[collisionType],
+                                                     midDomainSiteNumbers[collisionType]);
+#ifdef HEMELB_USE_DENSE_BLOCKS
+            // The bulk fluid sites come first of all, so the dense blocks among them start
+            // the site array.
+            if (collisionType == 0)
             {
+              denseBlockSiteCount = denseblocks::OrderDenseBlockSitesFirst(order,
+                                                                           midDomainBlockNumbers[collisionType],
+                                                                           midDomainSiteNumbers[collisionType],
+                                                                           sitesPerBlockVolumeUnit);
+            }
+#endif
+            for (unsigned orderIndex = 0; orderIndex < midDomainProcCollisions[collisionType]; orderIndex++)
+            {
+              const site_t indexInType = order[orderIndex];
               siteData.push_back(midDomainSiteData[collisionType][indexInType]);
               wallNormalAtSite.push_back(midDomainWallNormals[collisionType][indexInType]);
               for (Direction direction = 1; direction < latticeInfo.GetNumVectors(); direction++)
@@ -386,8 +771,11 @@ namespace hemelb
 
           for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; collisionType++)
           {
-            for (unsigned indexInType = 0; indexInType < domainEdgeProcCollisions[collisionType]; indexInType++)
+            const std::vector<site_t> order = GetSiteOrder(domainEdgeBlockNumbers[collisionType],
+                                                           domainEdgeSiteNumbers[collisionType]);
+            for (unsigned orderIndex = 0; orderIndex < domainEdgeProcCollisions[collisionType]; orderIndex++)
             {
+              const site_t indexInType = order[orderIndex];
               siteData.push_back(domainEdgeSiteData[collisionType][indexInType]);
               wallNormalAtSite.push_back(domainEdgeWallNormals[collisionType][indexInType]);
               for (Direction direction = 1; direction < latticeInfo.GetNumVectors(); direction++)
@@ -404,17 +792,67 @@ namespace hemelb
 
           }
 
-          oldDistributions.resize(localFluidSites * latticeInfo.GetNumVectors() + 1 + totalSharedFs);
-          newDistributions.resize(localFluidSites * latticeInfo.GetNumVectors() + 1 + totalSharedFs);
+          InitialiseLinkTypes();
+          AllocateDistributions();
         }
+
+        /**
+         * Append the halo sites to the site data, after the local fluid sites, and build the
+         * lists of the ranks that own them. Only used with a deep halo.
+         * @param readResult
+         * @param edgeSites The coordinates of the local sites with a neighbour on another rank.
+         */
+        void ProcessHaloSites(const Geometry& readResult, const std::vector<util::Vector3D<site_t> >& edgeSites);
+
+        /**
+         * Size the distribution arrays for the local and halo sites.
+         */
+        void AllocateDistributions();
+
+        /**
+         * Get the order in which to number the sites of one collision-type range, as indices
+         * into the range, sorted by the key SiteOrdering gives their global coordinates.
+         * @param blockNumbers The block of each site in the range.
+         * @param siteNumbers The index of each site within its block.
+         * @return
+         */
+        std::vector<site_t> GetSiteOrder(const std::vector<site_t>& blockNumbers,
+                                         const std::vector<site_t>& siteNumbers) const;
+
         void CollectFluidSiteDistribution();
         void CollectGlobalSiteExtrema();
 
+        /**
+         * Sort the links of every site by type, for GetLinksByType.
+         */
+        void InitialiseLinkTypes();
+
+        /**
+         * Sort the links of one site by type from its SiteData. This must be redone whenever
+         * that SiteData changes.
+         * @param siteIndex
+         */
+        void SetLinkTypes(site_t siteIndex);
+
         void InitialiseNeighbourLookups();
 
         void InitialiseNeighbourLookup(std::vector<std::vector<site_t> >& sharedFLocationForEachProc);
         void InitialisePointToPointComms(std::vector<std::vector<site_t> >& sharedFLocationForEachProc);
         void InitialiseReceiveLookup(std::vector<std::vector<site_t> >& sharedFLocationForEachProc);
+        void InitialiseHaloExchange();
+        /**
+         * Find which neighbouring processors share this node, and so the distribution arrays,
+         * and where in their arrays they put the distributions streamed to this one.
+         */
+        void InitialiseSharedWindowExchange();
+
+        /**
+         * Get the index of the halo site at the given global coordinates.
+         * @param globalLocation
+         * @param siteIndex (out) The index of the site, numbered after the local fluid sites.
+         * @return true if the site is in the halo, false otherwise
+         */
+        bool GetHaloSiteIndex(const util::Vector3D<site_t>& globalLocation, site_t& siteIndex) const;
 
         sitedata_t GetSiteData(site_t iSiteI, site_t iSiteJ, site_t iSiteK) const;
 
@@ -429,7 +867,102 @@ namespace hemelb
                                          const unsigned int direction,
                                          const site_t distributionIndex)
         {
-          neighbourIndices[siteIndex * latticeInfo.GetNumVectors() + direction] = distributionIndex;
+          // The interior sites of dense blocks stream to a fixed offset, so aren't in the table.
+          if (!IsDenseBlockInteriorSite(siteIndex))
+          {
+            neighbourIndices[GetNeighbourTableIndex(siteIndex, direction)] = (streaming_index_t) distributionIndex;
+          }
+        }
+
+        /**
+         * Get the index in neighbourIndices of the given site's entry for the given direction.
+         * The interior sites of dense blocks have no entries; the sites after the dense blocks
+         * have rows after those of the dense blocks' other sites, in order.
+         * @param siteIndex
+         * @param direction
+         * @return
+         */
+        template<typename LatticeType>
+        inline site_t GetNeighbourTableIndex(site_t siteIndex, Direction direction) const
+        {
+#ifdef HEMELB_USE_DENSE_BLOCKS
+          return GetNeighbourTableRow(siteIndex) * LatticeType::NUMVECTORS + direction;
+#else
+          return GetDistributionIndex<LatticeType>(siteIndex, direction);
+#endif
+        }
+
+        /**
+         * Non-templated version of GetNeighbourTableIndex, for when you haven't got a lattice
+         * type handy
+         * @param siteIndex
+         * @param direction
+         * @return
+         */
+        inline site_t GetNeighbourTableIndex(site_t siteIndex, Direction direction) const
+        {
+#ifdef HEMELB_USE_DENSE_BLOCKS
+          return GetNeighbourTableRow(siteIndex) * latticeInfo.GetNumVectors() + direction;
+#else
+          return GetDistributionIndex(siteIndex, direction);
+#endif
+        }
+
+        /**
+         * Get the row of neighbourIndices for a site that isn't an interior site of a dense
+         * block.
+         * @param siteIndex
+         * @return
+         */
+        inline site_t GetNeighbourTableRow(site_t siteIndex) const
+        {
+          if (siteIndex < denseBlockSiteCount)
+          {
+            return (siteIndex / sitesPerBlockVolumeUnit) * denseBlockTableRowCount
+                + denseBlockTableRows[siteIndex % sitesPerBlockVolumeUnit];
+          }
+          return (denseBlockSiteCount / sitesPerBlockVolumeUnit) * denseBlockTableRowCount + siteIndex
+              - denseBlockSiteCount;
+        }
+
+        /**
+         * Get the index in the distribution arrays that the given site streams to in the
+         * given direction, from the neighbour index table, or for the interior sites of dense
+         * blocks, from the fixed offset of the neighbour.
+         * @param siteIndex
+         * @param direction
+         * @return
+         */
+        template<typename LatticeType>
+        inline site_t GetNeighbourIndex(site_t siteIndex, Direction direction) const
+        {
+          if (IsDenseBlockInteriorSite(siteIndex))
+          {
+            return GetDistributionIndex<LatticeType>(siteIndex
+                                                         + denseblocks::GetNeighbourOffset<LatticeType>(direction,
+                                                                                                        blockSize),
+                                                     direction);
+          }
+          return neighbourIndices[GetNeighbourTableIndex<LatticeType>(siteIndex, direction)];
+        }
+
+        /**
+         * Non-templated version of GetNeighbourIndex, for when you haven't got a lattice type
+         * handy
+         * @param siteIndex
+         * @param direction
+         * @return
+         */
+        inline site_t GetNeighbourIndex(site_t siteIndex, Direction direction) const
+        {
+          if (IsDenseBlockInteriorSite(siteIndex))
+          {
+            return GetDistributionIndex(siteIndex
+                                            + denseblocks::GetNeighbourOffset(latticeInfo.GetVector(direction),
+                                                                              blockSize),
+                                        direction);
+          }
+          return neighbourIndices[GetNeighbourTableIndex(siteIndex, direction)];
         }
 
         void GetBlockIJK(site_t block, util::Vector3D<site_t>& blockCoords) const;
@@ -458,7 +991,7 @@ namespace hemelb
          * @return
          */
         // Method should remain protected, intent is to access this information via Site
-        distribn_t* GetFOld(site_t distributionIndex)
+        distribn_storage_t* GetFOld(site_t distributionIndex)
         {
           return &oldDistributions[distributionIndex];
         }
@@ -471,11 +1004,37 @@ namespace hemelb
          * @return
          */
         // Method should remain protected, intent is to access this information via Site
-        const distribn_t* GetFOld(site_t distributionIndex) const
+        const distribn_storage_t* GetFOld(site_t distributionIndex) const
         {
           return &oldDistributions[distributionIndex];
         }
 
+        /**
+         * Helpers for GetContiguousFOld and GetExactFNew: pass through pointers to distribn_t,
+         * and give NULL for any other storage type.
+         */
+        static distribn_t* AsExactDistributions(distribn_t* distributions)
+        {
+          return distributions;
+        }
+
+        static const distribn_t* AsExactDistributions(const distribn_t* distributions)
+        {
+          return distributions;
+        }
+
+        template<typename StorageType>
+        static distribn_t* AsExactDistributions(StorageType* distributions)
+        {
+          return NULL;
+        }
+
+        template<typename StorageType>
+        static const distribn_t* AsExactDistributions(const StorageType* distributions)
+        {
+          return NULL;
+        }
+
         /*
          * This returns the index of the distribution to stream to.
          *
@@ -486,7 +1045,74 @@ namespace hemelb
         template<typename LatticeType>
         site_t GetStreamedIndex(site_t iSiteIndex, unsigned int iDirectionIndex) const
         {
-          return neighbourIndices[iSiteIndex * LatticeType::NUMVECTORS + iDirectionIndex];
+#ifdef HEMELB_USE_AA_STREAMING
+          // In the even step of an AA-pattern pair, distributions that stay on this rank are
+          // written back to the streaming site, in the slot for the inverse direction.
+          const site_t streamedIndex = GetNeighbourIndex<LatticeType>(iSiteIndex, iDirectionIndex);
+          if (oddStep || streamedIndex >= GetRubbishDistributionIndex())
+          {
+            return streamedIndex;
+          }
+          return GetDistributionIndex<LatticeType>(iSiteIndex, LatticeType::INVERSEDIRECTIONS[iDirectionIndex]);
+#else
+          return GetNeighbourIndex<LatticeType>(iSiteIndex, iDirectionIndex);
+#endif
+        }
+
+        /**
+         * Helper for GetFOldIndex, given the index upstreamIndex that the site streams to in
+         * the inverse of the requested direction.
+         * @param siteIndex
+         * @param direction
+         * @param upstreamIndex
+         * @return
+         */
+        inline site_t GetOddStepFOldIndex(site_t siteIndex, Direction direction, site_t upstreamIndex) const
+        {
+          if (upstreamIndex == GetRubbishDistributionIndex())
+          {
+            return GetDistributionIndex(siteIndex, direction);
+          }
+          if (upstreamIndex > GetRubbishDistributionIndex())
+          {
+            return upstreamIndex + totalSharedFs;
+          }
+          return upstreamIndex;
+        }
+
+        /**
+         * Get the directions of the links of the given site, sorted by type: first those to
+         * other fluid sites, then those that hit only a wall, then those that hit both a wall
+         * and an iolet, and then those that hit only an iolet. So the links that hit a wall run
+         * from GetWallLinksBegin to GetWallLinksEnd, and those that hit an iolet from
+         * GetIoletLinksBegin to the end. This lets the streamers handle each type of link in
+         * its own loop, rather than testing every link of every site on every step, while
+         * still choosing which type wins for links that are both.
+         * @param siteIndex
+         * @return
+         */
+        // Method should remain protected, intent is to access this information via Site
+        inline const uint8_t* GetLinksByType(site_t siteIndex) const
+        {
+          return &linksByType[siteIndex * latticeInfo.GetNumVectors()];
+        }
+
+        // Method should remain protected, intent is to access this information via Site
+        inline Direction GetWallLinksBegin(site_t siteIndex) const
+        {
+          return wallLinksBegin[siteIndex];
+        }
+
+        // Method should remain protected, intent is to access this information via Site
+        inline Direction GetIoletLinksBegin(site_t siteIndex) const
+        {
+          return ioletLinksBegin[siteIndex];
+        }
+
+        // Method should remain protected, intent is to access this information via Site
+        inline Direction GetWallLinksEnd(site_t siteIndex) const
+        {
+          return wallLinksEnd[siteIndex];
         }
 
         /**
@@ -560,19 +1186,48 @@ namespace hemelb
         site_t midDomainProcCollisions[COLLISION_TYPES]; //! Number of fluid sites with all fluid neighbours on this rank, for each collision type.
         site_t domainEdgeProcCollisions[COLLISION_TYPES]; //! Number of fluid sites with at least one fluid neighbour on another rank, for each collision type.
         site_t localFluidSites; //! The number of local fluid sites.
-        std::vector<distribn_t> oldDistributions; //! The distribution values for the previous time step.
-        std::vector<distribn_t> newDistributions; //! The distribution values for the next time step.
+        site_t denseBlockSiteCount; //! The number of sites in dense blocks, numbered block by block at the start of the site array.
+        site_t haloSiteCount; //! The number of sites in the deep halo, numbered after the local fluid sites.
+        std::vector<site_t> haloProcCollisions; //! Number of halo sites of each collision type, for each layer of the halo.
+        site_t allocatedFluidSites; //! The number of sites the distribution arrays hold, including any padding required by the layout.
+#ifdef HEMELB_USE_SHARED_WINDOWS
+        typedef std::vector<distribn_storage_t, net::SharedWindowAllocator<distribn_storage_t> > DistributionArray;
+#else
+        typedef std::vector<distribn_storage_t> DistributionArray;
+#endif
+        DistributionArray oldDistributions; //! The distribution values for the previous time step, as stored by DistributionStorage.
+        DistributionArray newDistributions; //! The distribution values for the next time step. Unused with AA-pattern streaming.
+        net::MpiCommunicator nodeComms; //! The processes on this node, with which the distribution arrays are shared if built to.
+        std::vector<int> neighbourNodeRanks; //! The rank in nodeComms of each neighbouring processor, or -1 if it is on another node.
+        std::vector<distribn_storage_t*> neighbourSegmentsOfOld; //! Where in its fOld each neighbour on this node put the distributions it streamed to this one.
+        std::vector<distribn_storage_t*> neighbourSegmentsOfNew; //! Where in its fNew each neighbour on this node puts the distributions it streams to this one.
+        std::vector<char> sendTokens; //! Sent to each neighbour on this node once the distributions streamed to it are ready.
+        std::vector<char> receiveTokens; //! Received from each neighbour on this node once the distributions it streamed here are ready.
+        bool oddStep; //! Whether this is the odd step of an AA-pattern pair.
+        unsigned stepsSinceHaloExchange; //! The number of steps since the deep halo was last received from its owners.
         std::vector<Block> blocks; //! Data where local fluid sites are stored contiguously.
 
         std::vector<distribn_t> distanceToWall; //! Hold the distance to the wall for each fluid site.
         std::vector<util::Vector3D<site_t> > globalSiteCoords; //! Hold the global site coordinates for each contiguous site.
         std::vector<util::Vector3D<distribn_t> > wallNormalAtSite; //! Holds the wall normal near the fluid site, where appropriate
         std::vector<SiteData> siteData; //! Holds the SiteData for each site.
+        std::vector<uint8_t> linksByType; //! The link directions of each site, sorted into bulk, wall, wall-iolet and iolet links.
+        std::vector<uint8_t> wallLinksBegin; //! The position in linksByType of the first wall link of each site.
+        std::vector<uint8_t> ioletLinksBegin; //! The position in linksByType of the first iolet link of each site.
+        std::vector<uint8_t> wallLinksEnd; //! The position in linksByType after the last wall link of each site.
         std::vector<site_t> fluidSitesOnEachProcessor; //! Array containing numbers of fluid sites on each processor.
         site_t totalFluidSites; //! The total number of fluid sites in the geometry.
         util::Vector3D<site_t> globalSiteMins, globalSiteMaxes; //! The minimal and maximal coordinates of any fluid sites.
-        std::vector<site_t> neighbourIndices; //! Data about neighbouring fluid sites.
-        std::vector<site_t> streamingIndicesForReceivedDistributions; //! The indices to stream to for distributions received from other processors.
+        std::vector<streaming_index_t> neighbourIndices; //! Data about neighbouring fluid sites.
+        std::vector<site_t> denseBlockTableRows; //! The row of neighbourIndices of each site id of a dense block, relative to the block's first, or -1 for interior sites.
+        site_t denseBlockTableRowCount; //! The number of rows of neighbourIndices each dense block has.
+        std::vector<streaming_index_t> streamingIndicesForReceivedDistributions; //! The indices to stream to for distributions received from other processors.
+        std::vector<proc_t> haloSiteRanks; //! The rank that owns each halo site.
+        std::map<site_t, site_t> haloSiteIndices; //! The index of each halo site, by its global non-contiguous id.
+        std::vector<site_t> haloSitesToSend; //! The local sites sent at each halo exchange, grouped by neighbouring processor.
+        std::vector<site_t> haloSitesToReceive; //! The halo sites received at each halo exchange, grouped by neighbouring processor.
+        std::vector<distribn_storage_t> haloSendBuffer; //! The distributions of the sites sent at the current halo exchange.
+        std::vector<distribn_storage_t> haloReceiveBuffer; //! The distributions of the sites received at the current halo exchange.
         neighbouring::NeighbouringLatticeData *neighbouringData;
         const net::IOCommunicator& comms;
     };
@@ -20,6 +20,12 @@ namespace hemelb
     struct NeighbouringProcessor
     {
       public:
+        NeighbouringProcessor() :
+            Rank(0), SharedDistributionCount(0), FirstSharedDistribution(0), SentHaloSiteCount(0),
+                FirstSentHaloSite(0), ReceivedHaloSiteCount(0), FirstReceivedHaloSite(0)
+        {
+        }
+
         //! Rank of the neighbouring processor.
         proc_t Rank;
 
@@ -31,6 +37,20 @@ namespace hemelb
         //! Index on this processor of the first distribution shared between this
         //! neighbour and the current processor.
         site_t FirstSharedDistribution;
+
+        //! With a deep halo, the number of sites on the current processor in the halo of this
+        //! neighbour, whose distributions are sent to it at each halo exchange.
+        site_t SentHaloSiteCount;
+
+        //! Index of the first of those sites in the list of sites sent at each halo exchange.
+        site_t FirstSentHaloSite;
+
+        //! With a deep halo, the number of sites of this neighbour in the halo of the current
+        //! processor, whose distributions are received from it at each halo exchange.
+        site_t ReceivedHaloSiteCount;
+
+        //! Index of the first of those sites in the list of sites received at each halo exchange.
+        site_t FirstReceivedHaloSite;
     };
   }
 }
@@ -60,6 +60,33 @@ namespace hemelb
           return GetSiteData().HasIolet(direction);
         }
 
+        /**
+         * Get the directions of this site's links sorted by type: bulk links, then links that
+         * hit only a wall from GetWallLinksBegin(), then links that hit a wall and an iolet
+         * from GetIoletLinksBegin() to GetWallLinksEnd(), then links that hit only an iolet.
+         *
+         * @return
+         */
+        inline const uint8_t* GetLinksByType() const
+        {
+          return latticeData.GetLinksByType(index);
+        }
+
+        inline Direction GetWallLinksBegin() const
+        {
+          return latticeData.GetWallLinksBegin(index);
+        }
+
+        inline Direction GetIoletLinksBegin() const
+        {
+          return latticeData.GetIoletLinksBegin(index);
+        }
+
+        inline Direction GetWallLinksEnd() const
+        {
+          return latticeData.GetWallLinksEnd(index);
+        }
+
         template<typename LatticeType>
         inline distribn_t GetWallDistance(Direction direction) const
         {
@@ -103,9 +130,30 @@ namespace hemelb
           return latticeData.template GetStreamedIndex<LatticeType>(index, direction);
         }
 
+        /**
+         * This returns the index into the distribution arrays of this site's distribution in
+         * the given direction.
+         *
+         * @param direction
+         * @return
+         */
+        template<typename LatticeType>
+        inline site_t GetDistributionIndex(Direction direction) const
+        {
+          return latticeData.template GetDistributionIndex<LatticeType>(index, direction);
+        }
+
+        /**
+         * Get a pointer to this site's fOld distributions. This requires the data source to
+         * store each site's distributions contiguously; use LoadFOld where that may not be so.
+         *
+         * @return
+         */
         template<typename LatticeType>
         inline const distribn_t* GetFOld() const
         {
+          static_assert(DataSource::SITE_CONTIGUOUS_DISTRIBUTIONS,
+                        "GetFOld needs each site's distributions to be contiguous; use LoadFOld");
           return latticeData.GetFOld(index * LatticeType::NUMVECTORS);
         }
 
@@ -115,6 +163,27 @@ namespace hemelb
           return latticeData.GetFOld(index * numvectors);
         }
 
+        // Non-templated, single direction version of GetFOld, which works for any distribution
+        // layout and precision
+        inline distribn_t GetFOldInDirection(Direction direction) const
+        {
+          return latticeData.GetFOldValue(latticeData.GetFOldIndex(index, direction), direction);
+        }
+
+        /**
+         * Get a pointer to this site's fOld distributions, whatever the distribution layout and
+         * streaming pattern. If they aren't contiguous they are first gathered into buffer, which must have room
+         * for NUMVECTORS values, and a pointer to buffer is returned.
+         *
+         * @param buffer
+         * @return
+         */
+        template<typename LatticeType>
+        inline const distribn_t* LoadFOld(distribn_t* buffer) const
+        {
+          return LoadFOld<LatticeType>(buffer, Contiguity<DataSource::SITE_CONTIGUOUS_DISTRIBUTIONS>());
+        }
+
         inline const SiteData& GetSiteData() const
         {
           return latticeData.GetSiteData(index);
@@ -133,6 +202,36 @@ namespace hemelb
       protected:
         site_t index;
         DataSource & latticeData;
+
+      private:
+        /**
+         * Tag to pick the version of LoadFOld for the data source, so that the pointer into
+         * the data source is only taken where it holds each site's distributions as contiguous
+         * distribn_t.
+         */
+        template<bool tContiguous>
+        struct Contiguity
+        {
+        };
+
+        template<typename LatticeType>
+        inline const distribn_t* LoadFOld(distribn_t* buffer, Contiguity<true>) const
+        {
+          return latticeData.GetFOld(index * LatticeType::NUMVECTORS);
+        }
+
+        template<typename LatticeType>
+        inline const distribn_t* LoadFOld(distribn_t* buffer, Contiguity<false>) const
+        {
+          for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+          {
+            buffer[direction] =
+                latticeData.template GetFOldValue<LatticeType>(latticeData.template GetFOldIndex<LatticeType>(index,
+                                                                                                              direction),
+                                                               direction);
+          }
+          return buffer;
+        }
     };
   }
 }
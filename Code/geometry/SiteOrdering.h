@@ -0,0 +1,143 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_SITEORDERING_H
+#define HEMELB_GEOMETRY_SITEORDERING_H
+
+#include <stdint.h>
+#include "units.h"
+#include "util/Vector3D.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    /**
+     * Orderings for numbering the local fluid sites within each collision-type range of
+     * LatticeData.
+     *
+     * Each ordering gives a key for a site from its global coordinates; sites are numbered in
+     * increasing order of key within each mid-domain and domain-edge range, so sites close in
+     * space get close indices and streaming touches fewer cache lines. The names of the classes
+     * must correspond to options given for the CMake HEMELB_SITE_ORDERING parameter.
+     */
+    namespace orderings
+    {
+      /**
+       * The number of bits of each coordinate used to make a key. Three of these must fit in
+       * 64 bits.
+       */
+      const unsigned SITE_ORDERING_BITS = 21;
+
+      /**
+       * Number the sites in the order they are read, block by block. This is the original
+       * HemeLB ordering.
+       */
+      class NONE
+      {
+        public:
+          /**
+           * True if the sites need to be sorted by key at all.
+           */
+          static const bool REORDER = false;
+
+          static uint64_t GetKey(const util::Vector3D<site_t>& globalCoords)
+          {
+            return 0;
+          }
+      };
+
+      /**
+       * Number the sites along the Morton (Z-order) curve, by interleaving the bits of their
+       * coordinates.
+       */
+      class MORTON
+      {
+        public:
+          static const bool REORDER = true;
+
+          static uint64_t GetKey(const util::Vector3D<site_t>& globalCoords)
+          {
+            uint64_t key = 0;
+            for (int bit = SITE_ORDERING_BITS - 1; bit >= 0; --bit)
+            {
+              key = (key << 3) | ( ( ((uint64_t) globalCoords.x >> bit) & 1) << 2)
+                  | ( ( ((uint64_t) globalCoords.y >> bit) & 1) << 1)
+                  | ( ((uint64_t) globalCoords.z >> bit) & 1);
+            }
+            return key;
+          }
+      };
+
+      /**
+       * Number the sites along the Hilbert curve. Unlike the Morton curve, successive sites on
+       * the Hilbert curve are always neighbours, at the cost of a slightly more expensive key.
+       *
+       * The key is found with Skilling's algorithm ("Programming the Hilbert curve", AIP Conf.
+       * Proc. 707, 2004), which transforms the coordinates so that interleaving their bits
+       * gives the distance along the curve.
+       */
+      class HILBERT
+      {
+        public:
+          static const bool REORDER = true;
+
+          static uint64_t GetKey(const util::Vector3D<site_t>& globalCoords)
+          {
+            uint64_t axes[3] = { (uint64_t) globalCoords.x, (uint64_t) globalCoords.y,
+                                 (uint64_t) globalCoords.z };
+            const uint64_t highestBit = (uint64_t) 1 << (SITE_ORDERING_BITS - 1);
+
+            // Inverse undo.
+            for (uint64_t q = highestBit; q > 1; q >>= 1)
+            {
+              const uint64_t p = q - 1;
+              for (unsigned axis = 0; axis < 3; ++axis)
+              {
+                if (axes[axis] & q)
+                {
+                  axes[0] ^= p;
+                }
+                else
+                {
+                  const uint64_t t = (axes[0] ^ axes[axis]) & p;
+                  axes[0] ^= t;
+                  axes[axis] ^= t;
+                }
+              }
+            }
+
+            // Gray encode.
+            axes[1] ^= axes[0];
+            axes[2] ^= axes[1];
+            uint64_t t = 0;
+            for (uint64_t q = highestBit; q > 1; q >>= 1)
+            {
+              if (axes[2] & q)
+              {
+                t ^= q - 1;
+              }
+            }
+            for (unsigned axis = 0; axis < 3; ++axis)
+            {
+              axes[axis] ^= t;
+            }
+
+            uint64_t key = 0;
+            for (int bit = SITE_ORDERING_BITS - 1; bit >= 0; --bit)
+            {
+              key = (key << 3) | ( ( (axes[0] >> bit) & 1) << 2) | ( ( (axes[1] >> bit) & 1) << 1)
+                  | ( (axes[2] >> bit) & 1);
+            }
+            return key;
+          }
+      };
+    }
+
+    typedef orderings::HEMELB_SITE_ORDERING SiteOrdering;
+  }
+}
+
+#endif /* HEMELB_GEOMETRY_SITEORDERING_H */
@@ -0,0 +1,133 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <algorithm>
+#include "geometry/SiteRendezvous.h"
+#include "net/net.h"
+#include "Exception.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    SiteRendezvous::SiteRendezvous(const net::MpiCommunicator& comms, site_t idCount, unsigned valuesPerSite) :
+        comms(comms), valuesPerSite(valuesPerSite)
+    {
+      // Round up, so that every id has a home.
+      idsPerHome = (idCount + comms.Size() - 1) / comms.Size();
+      if (idsPerHome == 0)
+      {
+        idsPerHome = 1;
+      }
+    }
+
+    template<typename T>
+    void SiteRendezvous::Exchange(std::vector<std::vector<T> >& outgoing,
+                                  std::vector<std::vector<T> >& incoming) const
+    {
+      std::vector<int> outgoingCounts(comms.Size());
+      for (proc_t rank = 0; rank < comms.Size(); ++rank)
+      {
+        outgoingCounts[rank] = (int) outgoing[rank].size();
+      }
+      std::vector<int> incomingCounts = comms.AllToAll(outgoingCounts);
+
+      net::Net net(comms);
+      incoming.resize(comms.Size());
+      for (proc_t rank = 0; rank < comms.Size(); ++rank)
+      {
+        incoming[rank].resize(incomingCounts[rank]);
+        // Empty vectors have no first element to point at.
+        if (!incoming[rank].empty())
+        {
+          net.RequestReceiveV(incoming[rank], rank);
+        }
+        if (!outgoing[rank].empty())
+        {
+          net.RequestSendV(outgoing[rank], rank);
+        }
+      }
+      net.Dispatch();
+    }
+
+    void SiteRendezvous::Deposit(const std::vector<site_t>& ids, const std::vector<distribn_t>& values)
+    {
+      std::vector<std::vector<site_t> > outgoingIds(comms.Size());
+      std::vector<std::vector<distribn_t> > outgoingValues(comms.Size());
+      for (size_t site = 0; site < ids.size(); ++site)
+      {
+        const proc_t home = GetHome(ids[site]);
+        outgoingIds[home].push_back(ids[site]);
+        outgoingValues[home].insert(outgoingValues[home].end(),
+                                    values.begin() + site * valuesPerSite,
+                                    values.begin() + (site + 1) * valuesPerSite);
+      }
+
+      std::vector<std::vector<site_t> > incomingIds;
+      std::vector<std::vector<distribn_t> > incomingValues;
+      Exchange(outgoingIds, incomingIds);
+      Exchange(outgoingValues, incomingValues);
+
+      for (proc_t rank = 0; rank < comms.Size(); ++rank)
+      {
+        for (size_t site = 0; site < incomingIds[rank].size(); ++site)
+        {
+          storedIndices[incomingIds[rank][site]] = storedValues.size();
+          storedValues.insert(storedValues.end(),
+                              incomingValues[rank].begin() + site * valuesPerSite,
+                              incomingValues[rank].begin() + (site + 1) * valuesPerSite);
+        }
+      }
+    }
+
+    void SiteRendezvous::Collect(const std::vector<site_t>& ids, std::vector<distribn_t>& values) const
+    {
+      // Ask each home for its sites, remembering where each one goes in the answer.
+      std::vector<std::vector<site_t> > requestedIds(comms.Size());
+      std::vector<std::vector<size_t> > positions(comms.Size());
+      for (size_t site = 0; site < ids.size(); ++site)
+      {
+        const proc_t home = GetHome(ids[site]);
+        requestedIds[home].push_back(ids[site]);
+        positions[home].push_back(site);
+      }
+
+      std::vector<std::vector<site_t> > idsRequestedOfMe;
+      Exchange(requestedIds, idsRequestedOfMe);
+
+      std::vector<std::vector<distribn_t> > replies(comms.Size());
+      for (proc_t rank = 0; rank < comms.Size(); ++rank)
+      {
+        for (size_t site = 0; site < idsRequestedOfMe[rank].size(); ++site)
+        {
+          std::map<site_t, size_t>::const_iterator stored = storedIndices.find(idsRequestedOfMe[rank][site]);
+          if (stored == storedIndices.end())
+          {
+            throw Exception() << "Rank " << rank << " asked for site " << idsRequestedOfMe[rank][site]
+                << ", which was never deposited";
+          }
+          replies[rank].insert(replies[rank].end(),
+                               storedValues.begin() + stored->second,
+                               storedValues.begin() + stored->second + valuesPerSite);
+        }
+      }
+
+      std::vector<std::vector<distribn_t> > answers;
+      Exchange(replies, answers);
+
+      values.resize(ids.size() * valuesPerSite);
+      for (proc_t rank = 0; rank < comms.Size(); ++rank)
+      {
+        for (size_t site = 0; site < positions[rank].size(); ++site)
+        {
+          std::copy(answers[rank].begin() + site * valuesPerSite,
+                    answers[rank].begin() + (site + 1) * valuesPerSite,
+                    values.begin() + positions[rank][site] * valuesPerSite);
+        }
+      }
+    }
+  }
+}
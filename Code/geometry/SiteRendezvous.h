@@ -0,0 +1,82 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_SITERENDEZVOUS_H
+#define HEMELB_GEOMETRY_SITERENDEZVOUS_H
+
+#include <map>
+#include <vector>
+#include "net/MpiCommunicator.h"
+#include "units.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    /**
+     * Moves per-site values between two decompositions of the same sites, without any rank
+     * having to know both.
+     *
+     * Each site has a global id, and each id has a home rank fixed by the id alone: the ids are
+     * split into one contiguous range per rank. Ranks deposit the values of the sites they have
+     * now at the sites' homes, and then collect the values of the sites they will have from
+     * them, so each rank only ever holds the values it deposits and those it is home to.
+     */
+    class SiteRendezvous
+    {
+      public:
+        /**
+         * @param comms The ranks taking part
+         * @param idCount One more than the largest id
+         * @param valuesPerSite The number of values held for each site
+         */
+        SiteRendezvous(const net::MpiCommunicator& comms, site_t idCount, unsigned valuesPerSite);
+
+        /**
+         * Send the values of some sites to their homes. Collective.
+         * @param ids The id of each site
+         * @param values valuesPerSite values for each site, in the order of the ids
+         */
+        void Deposit(const std::vector<site_t>& ids, const std::vector<distribn_t>& values);
+
+        /**
+         * Fetch the values of some sites from their homes, where they must have been deposited.
+         * Collective.
+         * @param ids The id of each site
+         * @param values Set to valuesPerSite values for each site, in the order of the ids
+         */
+        void Collect(const std::vector<site_t>& ids, std::vector<distribn_t>& values) const;
+
+        /**
+         * @param id
+         * @return The rank that holds the values for the site with this id
+         */
+        proc_t GetHome(site_t id) const
+        {
+          return (proc_t) (id / idsPerHome);
+        }
+
+      private:
+        /**
+         * Exchange one vector with each rank, of a size the receiver doesn't yet know.
+         * @param outgoing What to send to each rank
+         * @param incoming Set to what each rank sent
+         */
+        template<typename T>
+        void Exchange(std::vector<std::vector<T> >& outgoing, std::vector<std::vector<T> >& incoming) const;
+
+        net::MpiCommunicator comms;
+        const unsigned valuesPerSite;
+        site_t idsPerHome;
+
+        //! The position in storedValues of the first value of each site this rank is home to.
+        std::map<site_t, size_t> storedIndices;
+        std::vector<distribn_t> storedValues;
+    };
+  }
+}
+
+#endif /* HEMELB_GEOMETRY_SITERENDEZVOUS_H */
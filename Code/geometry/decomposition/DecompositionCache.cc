@@ -0,0 +1,302 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <algorithm>
+#include <cstdio>
+#include <iomanip>
+#include <sstream>
+#include "geometry/decomposition/DecompositionCache.h"
+#include "log/Logger.h"
+#include "util/fileutils.h"
+#include "constants.h"
+#include "Exception.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    namespace decomposition
+    {
+      const uint64_t DecompositionCache::HASH_BASIS;
+      const int64_t DecompositionCache::MAGIC;
+      const int DecompositionCache::HEADER_LENGTH;
+
+      DecompositionCache::DecompositionCache(const net::MpiCommunicator& comms) :
+          comms(comms), key(0), blockListsLength(0)
+      {
+      }
+
+      uint64_t DecompositionCache::Hash(const void* data, size_t bytes, uint64_t hash)
+      {
+        const unsigned char* byte = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < bytes; ++i)
+        {
+          hash ^= byte[i];
+          hash *= 1099511628211ULL;
+        }
+        return hash;
+      }
+
+      uint64_t DecompositionCache::HashFile(const std::string& filePath) const
+      {
+        // Don't hold more than this much of the file at once.
+        const MPI_Offset maxReadLength = 1 << 24;
+
+        net::MpiFile input = net::MpiFile::Open(comms, filePath, MPI_MODE_RDONLY);
+        MPI_Offset size;
+        HEMELB_MPI_CALL(MPI_File_get_size, (input, &size));
+
+        // Hash an equal share of the file on each rank, then hash the hashes.
+        const MPI_Offset share = (size + comms.Size() - 1) / comms.Size();
+        const MPI_Offset begin = std::min(size, share * comms.Rank());
+        const MPI_Offset end = std::min(size, begin + share);
+
+        uint64_t hash = HASH_BASIS;
+        std::vector<char> buffer;
+        for (MPI_Offset position = begin; position < end; position += buffer.size())
+        {
+          buffer.resize(std::min(end - position, maxReadLength));
+          input.ReadAt(position, buffer);
+          hash = Hash(&buffer.front(), buffer.size(), hash);
+        }
+        input.Close();
+
+        const std::vector<uint64_t> hashes = comms.AllGather(hash);
+        return Hash(&hashes.front(), hashes.size() * sizeof(uint64_t), Hash(&size, sizeof(size)));
+      }
+
+      void DecompositionCache::Identify(const std::string& directory, const std::string& geometryPath,
+                                        uint64_t settingsHash)
+      {
+        key = Hash(&settingsHash, sizeof(settingsHash), HashFile(geometryPath));
+
+        std::ostringstream name;
+        name << directory << "/decomposition-" << std::hex << std::setw(16) << std::setfill('0') << key
+            << ".dat";
+        path = name.str();
+      }
+
+      MPI_Offset DecompositionCache::GetBlockOffsetsStart() const
+      {
+        return HEADER_LENGTH * sizeof(int64_t);
+      }
+
+      MPI_Offset DecompositionCache::GetBlockListsStart() const
+      {
+        return GetBlockOffsetsStart() + (comms.Size() + 1) * sizeof(int64_t);
+      }
+
+      MPI_Offset DecompositionCache::GetSiteRanksStart() const
+      {
+        return GetBlockListsStart() + blockListsLength * sizeof(int64_t);
+      }
+
+      bool DecompositionCache::Open(site_t blockCount, site_t fluidSiteCount, std::vector<site_t>& localBlocks)
+      {
+        // Look on one rank, so that they all agree.
+        int exists = comms.Rank() == 0 && util::file_exists(path.c_str());
+        comms.Broadcast(exists, 0);
+        if (!exists)
+        {
+          return false;
+        }
+
+        file = net::MpiFile::Open(comms, path, MPI_MODE_RDONLY);
+
+        std::vector<int64_t> header(HEADER_LENGTH);
+        if (comms.Rank() == 0)
+        {
+          file.ReadAt(0, header);
+        }
+        comms.Broadcast(header, 0);
+        if (header[0] != MAGIC || header[1] != (int64_t) key || header[2] != comms.Size()
+            || header[3] != blockCount || header[4] != fluidSiteCount)
+        {
+          log::Logger::Log<log::Warning, log::Singleton>("Ignoring %s, which doesn't match the decomposition",
+                                                         path.c_str());
+          file.Close();
+          return false;
+        }
+
+        // Where this rank's blocks are listed, and where the lists end.
+        std::vector<int64_t> offsets(2);
+        file.ReadAt(GetBlockOffsetsStart() + comms.Rank() * sizeof(int64_t), offsets);
+        std::vector<int64_t> end(1);
+        file.ReadAt(GetBlockOffsetsStart() + comms.Size() * sizeof(int64_t), end);
+        blockListsLength = end[0];
+
+        std::vector<int64_t> blocks(offsets[1] - offsets[0]);
+        if (!blocks.empty())
+        {
+          file.ReadAt(GetBlockListsStart() + offsets[0] * sizeof(int64_t), blocks);
+        }
+        localBlocks.assign(blocks.begin(), blocks.end());
+        return true;
+      }
+
+      void DecompositionCache::ReadSiteRanks(Geometry& geometry, const std::vector<site_t>& fluidSitesOnEachBlock)
+      {
+        // The index in the file of the first site on the current block.
+        site_t siteIndex = 0;
+        site_t block = 0;
+        while (block < geometry.GetBlockCount())
+        {
+          if (geometry.Blocks[block].Sites.empty())
+          {
+            siteIndex += fluidSitesOnEachBlock[block];
+            ++block;
+            continue;
+          }
+
+          // Read the ranks for this and any following blocks that were read in one go, as they
+          // are next to each other in the file.
+          site_t end = block;
+          site_t runSites = 0;
+          while (end < geometry.GetBlockCount()
+              && (fluidSitesOnEachBlock[end] == 0 || !geometry.Blocks[end].Sites.empty()))
+          {
+            runSites += fluidSitesOnEachBlock[end];
+            ++end;
+          }
+
+          std::vector<proc_t> ranks(runSites);
+          if (!ranks.empty())
+          {
+            file.ReadAt(GetSiteRanksStart() + siteIndex * sizeof(proc_t), ranks);
+          }
+
+          std::vector<proc_t>::const_iterator rank = ranks.begin();
+          for (; block < end; ++block)
+          {
+            std::vector<GeometrySite>& sites = geometry.Blocks[block].Sites;
+            for (site_t site = 0; site < (site_t) sites.size(); ++site)
+            {
+              if (sites[site].targetProcessor != SITE_OR_BLOCK_SOLID)
+              {
+                sites[site].targetProcessor = *rank++;
+              }
+            }
+          }
+          siteIndex += runSites;
+        }
+
+        file.Close();
+      }
+
+      void DecompositionCache::Write(const Geometry& geometry, const std::vector<site_t>& fluidSitesOnEachBlock,
+                                     proc_t localRank)
+      {
+        // Find the blocks with sites on this rank, and those whose first site is on this rank,
+        // whose sites' ranks this rank writes.
+        std::vector<int64_t> localBlocks;
+        std::vector<bool> writeBlock(geometry.GetBlockCount(), false);
+        for (site_t block = 0; block < geometry.GetBlockCount(); ++block)
+        {
+          const std::vector<GeometrySite>& sites = geometry.Blocks[block].Sites;
+          bool firstSite = true;
+          bool local = false;
+          for (site_t site = 0; site < (site_t) sites.size(); ++site)
+          {
+            if (sites[site].targetProcessor != SITE_OR_BLOCK_SOLID)
+            {
+              if (firstSite)
+              {
+                writeBlock[block] = sites[site].targetProcessor == localRank;
+                firstSite = false;
+              }
+              local = local || sites[site].targetProcessor == localRank;
+            }
+          }
+          if (local)
+          {
+            localBlocks.push_back(block);
+          }
+        }
+
+        const std::vector<int64_t> localBlockCounts = comms.AllGather((int64_t) localBlocks.size());
+        std::vector<int64_t> offsets(comms.Size() + 1, 0);
+        for (proc_t rank = 0; rank < comms.Size(); ++rank)
+        {
+          offsets[rank + 1] = offsets[rank] + localBlockCounts[rank];
+        }
+        blockListsLength = offsets.back();
+
+        site_t fluidSiteCount = 0;
+        for (site_t block = 0; block < geometry.GetBlockCount(); ++block)
+        {
+          fluidSiteCount += fluidSitesOnEachBlock[block];
+        }
+
+        // Write to another name first, so that a run stopped part way through can't leave a
+        // partial file to be read.
+        const std::string temporaryPath = path + ".tmp";
+        const std::string directory = path.substr(0, path.rfind('/'));
+        if (comms.Rank() == 0 && !util::DoesDirectoryExist(directory.c_str()))
+        {
+          std::string directoryToMake = directory;
+          util::MakeDirAllRXW(directoryToMake);
+        }
+        HEMELB_MPI_CALL(MPI_Barrier, (comms));
+
+        file = net::MpiFile::Open(comms, temporaryPath, MPI_MODE_WRONLY | MPI_MODE_CREATE);
+        HEMELB_MPI_CALL(MPI_File_set_size,
+                        (file, GetSiteRanksStart() + (MPI_Offset) (fluidSiteCount * sizeof(proc_t))));
+
+        if (comms.Rank() == 0)
+        {
+          std::vector<int64_t> header(HEADER_LENGTH);
+          header[0] = MAGIC;
+          header[1] = (int64_t) key;
+          header[2] = comms.Size();
+          header[3] = geometry.GetBlockCount();
+          header[4] = fluidSiteCount;
+          file.WriteAt(0, header);
+          file.WriteAt(GetBlockOffsetsStart(), offsets);
+        }
+        if (!localBlocks.empty())
+        {
+          file.WriteAt(GetBlockListsStart() + offsets[comms.Rank()] * sizeof(int64_t), localBlocks);
+        }
+
+        // Write the ranks for runs of blocks next to each other in the file in one go.
+        site_t siteIndex = 0;
+        site_t block = 0;
+        while (block < geometry.GetBlockCount())
+        {
+          if (!writeBlock[block])
+          {
+            siteIndex += fluidSitesOnEachBlock[block];
+            ++block;
+            continue;
+          }
+
+          std::vector<proc_t> ranks;
+          const site_t runStart = siteIndex;
+          while (block < geometry.GetBlockCount() && (fluidSitesOnEachBlock[block] == 0 || writeBlock[block]))
+          {
+            const std::vector<GeometrySite>& sites = geometry.Blocks[block].Sites;
+            for (site_t site = 0; site < (site_t) sites.size(); ++site)
+            {
+              if (sites[site].targetProcessor != SITE_OR_BLOCK_SOLID)
+              {
+                ranks.push_back(sites[site].targetProcessor);
+              }
+            }
+            siteIndex += fluidSitesOnEachBlock[block];
+            ++block;
+          }
+          file.WriteAt(GetSiteRanksStart() + runStart * sizeof(proc_t), ranks);
+        }
+        file.Close();
+
+        if (comms.Rank() == 0 && std::rename(temporaryPath.c_str(), path.c_str()) != 0)
+        {
+          throw Exception() << "Couldn't rename " << temporaryPath << " to " << path;
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,124 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_DECOMPOSITION_DECOMPOSITIONCACHE_H
+#define HEMELB_GEOMETRY_DECOMPOSITION_DECOMPOSITIONCACHE_H
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "geometry/Geometry.h"
+#include "net/MpiCommunicator.h"
+#include "net/MpiFile.h"
+#include "units.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    namespace decomposition
+    {
+      /**
+       * Keeps the result of decomposing a geometry in a file, so that later runs on the same
+       * geometry, with the same number of ranks and settings, can skip the decomposition.
+       *
+       * The file is named by a hash of the geometry file's contents and of the settings, and
+       * holds, after a short header,
+       *  - the offset of each rank's list of blocks in the lists below, and one past the end;
+       *  - the list of blocks on which each rank has sites;
+       *  - the rank of every fluid site in the geometry, block by block in the order of the
+       *    blocks, and in the order of the sites within each block.
+       * Every rank reads and writes only its own part of the file: the ranks of the sites on
+       * each block are written by the rank with the first of them.
+       */
+      class DecompositionCache
+      {
+        public:
+          /**
+           * @param comms The ranks taking part in the decomposition
+           */
+          DecompositionCache(const net::MpiCommunicator& comms);
+
+          /**
+           * Work out which file in a directory the decomposition of a geometry would be kept
+           * in. Reads the whole geometry file, a share on each rank. Collective.
+           * @param directory
+           * @param geometryPath The geometry file
+           * @param settingsHash A hash of everything else the decomposition depends on
+           */
+          void Identify(const std::string& directory, const std::string& geometryPath, uint64_t settingsHash);
+
+          const std::string& GetPath() const
+          {
+            return path;
+          }
+
+          /**
+           * Open the file, if there is one for this decomposition. Collective.
+           * @param blockCount The number of blocks in the geometry
+           * @param fluidSiteCount The number of fluid sites in the geometry
+           * @param localBlocks Set to the blocks on which this rank has sites
+           * @return Whether the file was there
+           */
+          bool Open(site_t blockCount, site_t fluidSiteCount, std::vector<site_t>& localBlocks);
+
+          /**
+           * Set the rank of every fluid site on every block read from the geometry, from the
+           * file, and close it. Collective.
+           * @param geometry
+           * @param fluidSitesOnEachBlock
+           */
+          void ReadSiteRanks(Geometry& geometry, const std::vector<site_t>& fluidSitesOnEachBlock);
+
+          /**
+           * Write the decomposition of the geometry, whose blocks must include all those with
+           * sites on this rank. Collective.
+           * @param geometry
+           * @param fluidSitesOnEachBlock
+           * @param localRank The rank the geometry gives the sites on this rank
+           */
+          void Write(const Geometry& geometry, const std::vector<site_t>& fluidSitesOnEachBlock, proc_t localRank);
+
+          /**
+           * Hash some bytes with 64-bit FNV-1a.
+           * @param data
+           * @param bytes
+           * @param hash The hash of the bytes before these, if any
+           * @return
+           */
+          static uint64_t Hash(const void* data, size_t bytes, uint64_t hash = HASH_BASIS);
+
+          static const uint64_t HASH_BASIS = 14695981039346656037ULL;
+
+        private:
+          /**
+           * The hash of the contents of a file. Collective.
+           * @param filePath
+           * @return
+           */
+          uint64_t HashFile(const std::string& filePath) const;
+
+          /**
+           * The position in the file of the first item of each section
+           */
+          MPI_Offset GetBlockOffsetsStart() const;
+          MPI_Offset GetBlockListsStart() const;
+          MPI_Offset GetSiteRanksStart() const;
+
+          static const int64_t MAGIC = 0x686c62646563ULL; //! "hlbdec"
+          static const int HEADER_LENGTH = 5;
+
+          net::MpiCommunicator comms;
+          net::MpiFile file;
+          std::string path;
+          uint64_t key;
+          int64_t blockListsLength; //! The total length of the lists of blocks, in the open file
+      };
+    }
+  }
+}
+
+#endif /* HEMELB_GEOMETRY_DECOMPOSITION_DECOMPOSITIONCACHE_H */
@@ -0,0 +1,110 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "geometry/decomposition/LoadBalancer.h"
+#include "constants.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    namespace decomposition
+    {
+      LoadBalancer::LoadBalancer(const net::MpiCommunicator& comms, const reporting::Timers& timers,
+                                 double threshold, const SiteWeights& siteWeights) :
+          comms(comms), timers(timers), threshold(threshold), siteWeights(siteWeights), localTime(0),
+              localWeight(0), globalTimePerWeight(0), imbalance(1)
+      {
+        Restart();
+      }
+
+      void LoadBalancer::Restart()
+      {
+        lastCalculationTime = timers[reporting::Timers::lb_calc].Get();
+      }
+
+      double LoadBalancer::GetLocalWeight(const LatticeData& latticeData) const
+      {
+        double weight = 0;
+        for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; ++collisionType)
+        {
+          weight += siteWeights[collisionType]
+              * (double) (latticeData.GetMidDomainCollisionCount(collisionType)
+                  + latticeData.GetDomainEdgeCollisionCount(collisionType));
+        }
+        return weight;
+      }
+
+      bool LoadBalancer::Measure(const LatticeData& latticeData)
+      {
+        const double now = timers[reporting::Timers::lb_calc].Get();
+        localTime = now - lastCalculationTime;
+        lastCalculationTime = now;
+        localWeight = GetLocalWeight(latticeData);
+
+        const double maxTime = comms.AllReduce(localTime, MPI_MAX);
+        const double totalTime = comms.AllReduce(localTime, MPI_SUM);
+        const double totalWeight = comms.AllReduce(localWeight, MPI_SUM);
+
+        globalTimePerWeight = totalWeight > 0 ?
+          totalTime / totalWeight :
+          0;
+        imbalance = totalTime > 0 ?
+          maxTime * comms.Size() / totalTime :
+          1;
+        return imbalance > threshold;
+      }
+
+      void LoadBalancer::CalculateBlockCostFactors(const LatticeData& latticeData,
+                                                   std::vector<float>& blockCostFactors) const
+      {
+        // How much dearer than average each unit of weight on this rank was.
+        const double localFactor = (localWeight > 0 && globalTimePerWeight > 0) ?
+          (localTime / localWeight) / globalTimePerWeight :
+          1;
+
+        // Blocks can be split between ranks, so take the weighted mean of the factors of the
+        // ranks with sites in each block.
+        std::vector<double> factorTimesWeight(latticeData.GetBlockCount(), 0);
+        std::vector<double> weight(latticeData.GetBlockCount(), 0);
+        site_t siteIndex = 0;
+        for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; ++collisionType)
+        {
+          for (site_t site = 0; site < latticeData.GetMidDomainCollisionCount(collisionType); ++site)
+          {
+            const site_t block =
+                latticeData.GetBlockIdFromBlockCoords(latticeData.GetSite(siteIndex++).GetGlobalSiteCoords()
+                    / latticeData.GetBlockSize());
+            factorTimesWeight[block] += localFactor * siteWeights[collisionType];
+            weight[block] += siteWeights[collisionType];
+          }
+        }
+        for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; ++collisionType)
+        {
+          for (site_t site = 0; site < latticeData.GetDomainEdgeCollisionCount(collisionType); ++site)
+          {
+            const site_t block =
+                latticeData.GetBlockIdFromBlockCoords(latticeData.GetSite(siteIndex++).GetGlobalSiteCoords()
+                    / latticeData.GetBlockSize());
+            factorTimesWeight[block] += localFactor * siteWeights[collisionType];
+            weight[block] += siteWeights[collisionType];
+          }
+        }
+
+        factorTimesWeight = comms.AllReduce(factorTimesWeight, MPI_SUM);
+        weight = comms.AllReduce(weight, MPI_SUM);
+
+        blockCostFactors.resize(latticeData.GetBlockCount());
+        for (site_t block = 0; block < latticeData.GetBlockCount(); ++block)
+        {
+          blockCostFactors[block] = weight[block] > 0 ?
+            (float) (factorTimesWeight[block] / weight[block]) :
+            1.0f;
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,96 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_DECOMPOSITION_LOADBALANCER_H
+#define HEMELB_GEOMETRY_DECOMPOSITION_LOADBALANCER_H
+
+#include <vector>
+#include "geometry/LatticeData.h"
+#include "geometry/decomposition/SiteWeights.h"
+#include "net/MpiCommunicator.h"
+#include "reporting/Timers.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    namespace decomposition
+    {
+      /**
+       * Watches how long each rank spends on lattice-Boltzmann calculation, to tell when the
+       * decomposition has become uneven enough to be worth redoing, and what each block of
+       * sites costs for the next one.
+       *
+       * The decomposition gives each site a fixed weight for its collision type. If a rank
+       * takes longer per unit of weight than the ranks do overall, its sites are taken to be
+       * that much dearer, whatever the cause (a slow node, or weights that don't suit the
+       * collision kernels or machine).
+       */
+      class LoadBalancer
+      {
+        public:
+          /**
+           * @param comms
+           * @param timers Timers whose lb_calc timer measures the calculation
+           * @param threshold The ratio of the slowest rank's time to the mean above which to
+           * rebalance
+           * @param siteWeights The weights the decomposition gives the sites
+           */
+          LoadBalancer(const net::MpiCommunicator& comms, const reporting::Timers& timers, double threshold,
+                       const SiteWeights& siteWeights);
+
+          /**
+           * Measure the calculation time on each rank since the last measurement. Collective.
+           * @param latticeData The lattice the time was spent on
+           * @return Whether the imbalance is over the threshold
+           */
+          bool Measure(const LatticeData& latticeData);
+
+          /**
+           * The ratio of the slowest rank's calculation time to the mean, at the last measurement
+           */
+          double GetImbalance() const
+          {
+            return imbalance;
+          }
+
+          /**
+           * Work out, from the last measurement, how much dearer each block's sites are than
+           * their weights suggest. Collective.
+           * @param latticeData The lattice measured
+           * @param blockCostFactors Set to the factor for each block, or 1 for blocks with no
+           * fluid sites
+           */
+          void CalculateBlockCostFactors(const LatticeData& latticeData, std::vector<float>& blockCostFactors) const;
+
+          /**
+           * Start measuring afresh, discarding the time since the last measurement, as after
+           * redecomposing.
+           */
+          void Restart();
+
+        private:
+          /**
+           * The total of the decomposition weights of this rank's sites
+           */
+          double GetLocalWeight(const LatticeData& latticeData) const;
+
+          net::MpiCommunicator comms;
+          const reporting::Timers& timers;
+          const double threshold;
+          const SiteWeights siteWeights;
+
+          double lastCalculationTime; //! lb_calc time at the last measurement
+          double localTime; //! This rank's calculation time over the last measurement
+          double localWeight; //! This rank's total weight at the last measurement
+          double globalTimePerWeight; //! Time per unit of weight over all ranks, likewise
+          double imbalance;
+      };
+    }
+  }
+}
+
+#endif /* HEMELB_GEOMETRY_DECOMPOSITION_LOADBALANCER_H */
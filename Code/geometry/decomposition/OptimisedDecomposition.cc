@@ -4,8 +4,9 @@
 // file AUTHORS. This software is provided under the terms of the
 // license in the file LICENSE.
 
+#include <algorithm>
 #include "geometry/decomposition/OptimisedDecomposition.h"
-#include "geometry/decomposition/DecompositionWeights.h"
+#include "geometry/SiteOrdering.h"
 #include "lb/lattices/D3Q27.h"
 #include "log/Logger.h"
 #include "net/net.h"
@@ -19,9 +20,11 @@ namespace hemelb
       OptimisedDecomposition::OptimisedDecomposition(
           reporting::Timers& timers, net::MpiCommunicator& comms, const Geometry& geometry,
           const lb::lattices::LatticeInfo& latticeInfo, const std::vector<proc_t>& procForEachBlock,
-          const std::vector<site_t>& fluidSitesOnEachBlock) :
+          const std::vector<site_t>& fluidSitesOnEachBlock, Partitioner partitioner,
+          const SiteWeights& siteWeights, const std::vector<float>& blockCostFactors) :
           timers(timers), comms(comms), geometry(geometry), latticeInfo(latticeInfo),
-              procForEachBlock(procForEachBlock), fluidSitesPerBlock(fluidSitesOnEachBlock)
+              procForEachBlock(procForEachBlock), fluidSitesPerBlock(fluidSitesOnEachBlock),
+              partitioner(partitioner), siteWeights(siteWeights), blockCostFactors(blockCostFactors)
       {
         timers[hemelb::reporting::Timers::InitialGeometryRead].Start(); //overall dbg timing
 
@@ -44,20 +47,23 @@ namespace hemelb
         // Populate the adjacency data arrays (for ParMetis) and validate if appropriate
         idx_t localVertexCount = vtxDistribn[comms.Rank() + 1] - vtxDistribn[comms.Rank()];
 
-        PopulateAdjacencyData(localVertexCount);
-
-        if (ShouldValidate())
+        if (partitioner == PARMETIS_PARTITIONER)
         {
-          ValidateAdjacencyData(localVertexCount);
-        }
+          PopulateAdjacencyData(localVertexCount);
+
+          if (ShouldValidate())
+          {
+            ValidateAdjacencyData(localVertexCount);
+          }
 
-        log::Logger::Log<log::Trace, log::OnePerCore>("Adj length %i", localAdjacencies.size());
+          log::Logger::Log<log::Trace, log::OnePerCore>("Adj length %i", localAdjacencies.size());
+        }
 
         timers[hemelb::reporting::Timers::InitialGeometryRead].Stop();
 
         // Call parmetis.
         timers[hemelb::reporting::Timers::parmetis].Start();
-        log::Logger::Log<log::Debug, log::OnePerCore>("Making the call to Parmetis");
+        log::Logger::Log<log::Debug, log::OnePerCore>("Partitioning the sites");
 
         bool do_decomposition = true;
 #ifdef HEMELB_NO_DECOMPOSITION
@@ -66,9 +72,16 @@ namespace hemelb
 
         if (do_decomposition)
         {
-          CallParmetis(localVertexCount);
+          if (partitioner == HILBERT_PARTITIONER)
+          {
+            PartitionAlongHilbertCurve(localVertexCount);
+          }
+          else
+          {
+            CallParmetis(localVertexCount);
+          }
           timers[hemelb::reporting::Timers::parmetis].Stop();
-          log::Logger::Log<log::Debug, log::OnePerCore>("Parmetis has finished.");
+          log::Logger::Log<log::Debug, log::OnePerCore>("Partitioning has finished.");
 
           // Convert the ParMetis results into a nice format.
           timers[hemelb::reporting::Timers::PopulateOptimisationMovesList].Start();
@@ -187,6 +200,113 @@ namespace hemelb
         }
       }
 
+      void OptimisedDecomposition::PartitionAlongHilbertCurve(idx_t localVertexCount)
+      {
+        PopulateVertexWeightData(localVertexCount);
+
+        // The local vertices are the fluid sites of this rank's blocks, in order of block id.
+        std::vector<site_t> fluidBlocks;
+        for (site_t block = 0; block < geometry.GetBlockCount(); ++block)
+        {
+          if (fluidSitesPerBlock[block] > 0)
+          {
+            fluidBlocks.push_back(block);
+          }
+        }
+
+        // Total the weight of each block, each on the rank that has it.
+        std::vector<int64_t> blockWeights(fluidBlocks.size(), 0);
+        idx_t vertex = 0;
+        for (size_t fluidBlock = 0; fluidBlock < fluidBlocks.size(); ++fluidBlock)
+        {
+          const site_t block = fluidBlocks[fluidBlock];
+          if (procForEachBlock[block] != comms.Rank())
+          {
+            continue;
+          }
+          for (site_t site = 0; site < fluidSitesPerBlock[block]; ++site)
+          {
+            blockWeights[fluidBlock] += vertexWeights[vertex++];
+          }
+        }
+        blockWeights = comms.AllReduce(blockWeights, MPI_SUM);
+
+        // Put the blocks in order along the curve through them, and find the weight before each.
+        std::vector<std::pair<uint64_t, size_t> > blocksAlongCurve(fluidBlocks.size());
+        for (size_t fluidBlock = 0; fluidBlock < fluidBlocks.size(); ++fluidBlock)
+        {
+          blocksAlongCurve[fluidBlock] =
+              std::make_pair(orderings::HILBERT::GetKey(geometry.GetBlockCoordinatesFromBlockId(fluidBlocks[fluidBlock])),
+                             fluidBlock);
+        }
+        std::sort(blocksAlongCurve.begin(), blocksAlongCurve.end());
+
+        std::vector<int64_t> weightBeforeBlock(fluidBlocks.size());
+        int64_t totalWeight = 0;
+        for (size_t position = 0; position < blocksAlongCurve.size(); ++position)
+        {
+          weightBeforeBlock[blocksAlongCurve[position].second] = totalWeight;
+          totalWeight += blockWeights[blocksAlongCurve[position].second];
+        }
+
+        // Put the sites of each local block in order along the curve through the sites, and cut
+        // them along with the rest of the curve.
+        partitionVector = std::vector<idx_t>(localVertexCount, comms.Rank());
+        std::vector<std::pair<uint64_t, idx_t> > sitesAlongCurve;
+        std::vector<int64_t> siteWeightsAlongCurve;
+        std::vector<proc_t> siteRanks;
+        vertex = 0;
+        for (size_t fluidBlock = 0; fluidBlock < fluidBlocks.size(); ++fluidBlock)
+        {
+          const site_t block = fluidBlocks[fluidBlock];
+          if (procForEachBlock[block] != comms.Rank())
+          {
+            continue;
+          }
+
+          sitesAlongCurve.clear();
+          for (site_t site = 0; site < fluidSitesPerBlock[block]; ++site, ++vertex)
+          {
+            const util::Vector3D<site_t> coords((site_t) vertexCoordinates[3 * vertex],
+                                                (site_t) vertexCoordinates[3 * vertex + 1],
+                                                (site_t) vertexCoordinates[3 * vertex + 2]);
+            sitesAlongCurve.push_back(std::make_pair(orderings::HILBERT::GetKey(coords), vertex));
+          }
+          std::sort(sitesAlongCurve.begin(), sitesAlongCurve.end());
+
+          siteWeightsAlongCurve.resize(sitesAlongCurve.size());
+          for (size_t position = 0; position < sitesAlongCurve.size(); ++position)
+          {
+            siteWeightsAlongCurve[position] = vertexWeights[sitesAlongCurve[position].second];
+          }
+          CutAlongCurve(siteWeightsAlongCurve, weightBeforeBlock[fluidBlock], totalWeight, comms.Size(), siteRanks);
+          for (size_t position = 0; position < sitesAlongCurve.size(); ++position)
+          {
+            partitionVector[sitesAlongCurve[position].second] = siteRanks[position];
+          }
+        }
+      }
+
+      void OptimisedDecomposition::CutAlongCurve(const std::vector<int64_t>& weights, int64_t weightBefore,
+                                                 int64_t totalWeight, proc_t rankCount, std::vector<proc_t>& ranks)
+      {
+        ranks.resize(weights.size());
+        for (size_t item = 0; item < weights.size(); ++item)
+        {
+          // Doubled, to keep to integers.
+          const int64_t doubleMiddle = 2 * weightBefore + weights[item];
+          ranks[item] = (proc_t) std::min((int64_t) rankCount - 1, doubleMiddle * rankCount / (2 * totalWeight));
+          weightBefore += weights[item];
+        }
+      }
+
+      int OptimisedDecomposition::ApplyCostFactor(int weight, float costFactor)
+      {
+        // Weights are integers, so scale them up before applying the cost factor, to keep some
+        // of its precision.
+        return std::max(1, (int) (weight * costFactor * COST_FACTOR_RESOLUTION + 0.5));
+      }
+
       void OptimisedDecomposition::PopulateVertexWeightData(idx_t localVertexCount)
       {
         // These counters will be used later on to count the number of each type of vertex site
@@ -245,36 +365,41 @@ namespace hemelb
                     switch (siteData.GetCollisionType())
                     {
                       case FLUID:
-                        localweight = hemelbSiteWeights[0];
+                        localweight = siteWeights[0];
                         ++FluidSiteCounter;
                         break;
 
                       case WALL:
-                        localweight = hemelbSiteWeights[1];
+                        localweight = siteWeights[1];
                         ++WallSiteCounter;
                         break;
 
                       case INLET:
-                        localweight = hemelbSiteWeights[2];
+                        localweight = siteWeights[2];
                         ++IOSiteCounter;
                         break;
 
                       case OUTLET:
-                        localweight = hemelbSiteWeights[3];
+                        localweight = siteWeights[3];
                         ++IOSiteCounter;
                         break;
 
                       case (INLET | WALL):
-                        localweight = hemelbSiteWeights[4];
+                        localweight = siteWeights[4];
                         ++WallIOSiteCounter;
                         break;
 
                       case (OUTLET | WALL):
-                        localweight = hemelbSiteWeights[5];
+                        localweight = siteWeights[5];
                         ++WallIOSiteCounter;
                         break;
                     }
 
+                    if (!blockCostFactors.empty())
+                    {
+                      localweight = ApplyCostFactor(localweight, blockCostFactors[blockNumber]);
+                    }
+
                     vertexWeights.push_back(localweight);
                     vertexCoordinates.push_back(blockXCoord + localSiteI);
                     vertexCoordinates.push_back(blockYCoord + localSiteJ);
@@ -291,9 +416,9 @@ namespace hemelb
           }
         }
 
-        int TotalCoreWeight = ( (FluidSiteCounter * hemelbSiteWeights[0])
-            + (WallSiteCounter * hemelbSiteWeights[1]) + (IOSiteCounter * hemelbSiteWeights[2])
-            + (WallIOSiteCounter * hemelbSiteWeights[4])) / hemelbSiteWeights[0];
+        int TotalCoreWeight = ( (FluidSiteCounter * siteWeights[0])
+            + (WallSiteCounter * siteWeights[1]) + (IOSiteCounter * siteWeights[2])
+            + (WallIOSiteCounter * siteWeights[4])) / siteWeights[0];
         int TotalSites = FluidSiteCounter + WallSiteCounter + WallIOSiteCounter;
 
         log::Logger::Log<log::Debug, log::OnePerCore>("There are %u Bulk Flow Sites, %u Wall Sites, %u IO Sites, %u WallIO Sites on core %u. Total: %u (Weighted %u Points)",
@@ -15,6 +15,8 @@
 #include "net/MpiCommunicator.h"
 #include "geometry/SiteData.h"
 #include "geometry/GeometryBlock.h"
+#include "geometry/decomposition/SiteWeights.h"
+#include "geometry/decomposition/Partitioner.h"
 
 namespace hemelb
 {
@@ -25,11 +27,21 @@ namespace hemelb
       class OptimisedDecomposition
       {
         public:
+          /**
+           * Optimise the decomposition.
+           *
+           * The cost of each site is its weight for its collision type. If blockCostFactors is
+           * not empty, the cost of each site is also scaled by the factor for its block, as
+           * measured while running on an earlier decomposition.
+           */
           OptimisedDecomposition(reporting::Timers& timers, net::MpiCommunicator& comms,
                                  const Geometry& geometry,
                                  const lb::lattices::LatticeInfo& latticeInfo,
                                  const std::vector<proc_t>& procForEachBlock,
-                                 const std::vector<site_t>& fluidSitesPerBlock);
+                                 const std::vector<site_t>& fluidSitesPerBlock,
+                                 Partitioner partitioner = PARMETIS_PARTITIONER,
+                                 const SiteWeights& siteWeights = SiteWeights(),
+                                 const std::vector<float>& blockCostFactors = std::vector<float>());
 
           /**
            * Returns a vector with the number of moves coming from each core
@@ -49,8 +61,34 @@ namespace hemelb
             return movesList;
           }
 
+          /**
+           * Get the weight of a site, given the weight for its collision type and the cost factor
+           * measured for its block.
+           * @param weight
+           * @param costFactor
+           * @return
+           */
+          static int ApplyCostFactor(int weight, float costFactor);
+
+          /**
+           * Cut the items along a curve into pieces of about equal weight, one for each rank:
+           * each item goes to the rank whose share of the total weight the middle of the item
+           * falls in. So the ranks never decrease along the curve, and the items may be cut a
+           * run at a time.
+           *
+           * @param weights [in] The weights of a run of items, in order along the curve
+           * @param weightBefore [in] The total weight of the items along the curve before the run
+           * @param totalWeight [in] The total weight of all of the items along the curve
+           * @param rankCount [in] The number of ranks to cut the curve between
+           * @param ranks [out] The rank for each item of the run
+           */
+          static void CutAlongCurve(const std::vector<int64_t>& weights, int64_t weightBefore,
+                                    int64_t totalWeight, proc_t rankCount, std::vector<proc_t>& ranks);
+
         private:
           typedef util::Vector3D<site_t> BlockLocation;
+          //! The amount by which to multiply the weights of the sites when scaling them by cost factors.
+          static const int COST_FACTOR_RESOLUTION = 16;
           /**
            * Populates the vector of vertex weights with different values for each local site type.
            * This allows ParMETIS to more efficiently decompose the system.
@@ -87,6 +125,20 @@ namespace hemelb
            */
           void CallParmetis(idx_t localVertexCount);
 
+          /**
+           * Fill in the partition vector by cutting the Hilbert curve through the sites into
+           * pieces of equal weight, one for each rank.
+           *
+           * The blocks are put in order along the curve through the blocks, which every rank can
+           * do with a weight for each block, and then each rank puts the sites of its own blocks
+           * in order along the curve through the sites. The sites of a block stay together, so
+           * this is the Hilbert curve through the sites exactly when the block size is a power of
+           * two, and close to it otherwise.
+           *
+           * @param localVertexCount [in] The number of local fluid sites
+           */
+          void PartitionAlongHilbertCurve(idx_t localVertexCount);
+
           /**
            * Populate the list of moves from each proc that we need locally, using the
            * partition vector.
@@ -211,6 +263,9 @@ namespace hemelb
           const lb::lattices::LatticeInfo& latticeInfo; //! The lattice info to optimise for.
           const std::vector<proc_t>& procForEachBlock; //! The processor assigned to each block at the moment
           const std::vector<site_t>& fluidSitesPerBlock; //! The number of fluid sites on each block.
+          const Partitioner partitioner; //! How to split the sites between the ranks.
+          const SiteWeights siteWeights; //! The weight of a site of each collision type.
+          const std::vector<float>& blockCostFactors; //! The factor to scale the weight of the sites on each block by, if not empty.
           std::vector<idx_t> vtxDistribn; //! The vertex distribution across participating cores.
           std::vector<idx_t> firstSiteIndexPerBlock; //! The global contiguous index of the first fluid site on each block.
           std::vector<idx_t> adjacenciesPerVertex; //! The number of adjacencies for each local fluid site
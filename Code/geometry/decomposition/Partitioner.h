@@ -0,0 +1,37 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_DECOMPOSITION_PARTITIONER_H
+#define HEMELB_GEOMETRY_DECOMPOSITION_PARTITIONER_H
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    namespace decomposition
+    {
+      /**
+       * The ways the optimised decomposition can split the fluid sites between the ranks.
+       */
+      enum Partitioner
+      {
+        /**
+         * Partition the graph of sites and their links with ParMETIS, which balances the weight
+         * and keeps the number of links cut between ranks low.
+         */
+        PARMETIS_PARTITIONER,
+        /**
+         * Cut the Hilbert curve through the sites into pieces of equal weight. No graph is
+         * built, and each rank only handles its own sites and a weight for each block, so this
+         * is much quicker than ParMETIS on many ranks, for a somewhat larger cut.
+         */
+        HILBERT_PARTITIONER
+      };
+    }
+  }
+}
+
+#endif /* HEMELB_GEOMETRY_DECOMPOSITION_PARTITIONER_H */
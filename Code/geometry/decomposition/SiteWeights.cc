@@ -0,0 +1,93 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <fstream>
+#include "geometry/decomposition/SiteWeights.h"
+#include "geometry/decomposition/DecompositionWeights.h"
+#include "Exception.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    namespace decomposition
+    {
+      SiteWeights::SiteWeights()
+      {
+        for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; ++collisionType)
+        {
+          weights[collisionType] = hemelbSiteWeights[collisionType];
+        }
+      }
+
+      const char* SiteWeights::GetCollisionTypeName(unsigned collisionType)
+      {
+        static const char* const names[COLLISION_TYPES] = { "bulk", "wall", "inlet", "outlet", "wallinlet",
+                                                            "walloutlet" };
+        return names[collisionType];
+      }
+
+      SiteWeights SiteWeights::Read(const std::string& path)
+      {
+        std::ifstream file(path.c_str());
+        if (!file)
+        {
+          throw Exception() << "Couldn't open site weights file '" << path << "'";
+        }
+
+        SiteWeights result;
+        bool read[COLLISION_TYPES] = { false };
+        std::string name;
+        int weight;
+        while (file >> name >> weight)
+        {
+          unsigned collisionType = 0;
+          while (collisionType < COLLISION_TYPES && name != GetCollisionTypeName(collisionType))
+          {
+            ++collisionType;
+          }
+          if (collisionType == COLLISION_TYPES)
+          {
+            throw Exception() << "Unknown collision type '" << name << "' in site weights file '" << path << "'";
+          }
+          if (weight < 1)
+          {
+            throw Exception() << "Weight for " << name << " sites in '" << path << "' must be at least 1";
+          }
+          result.weights[collisionType] = weight;
+          read[collisionType] = true;
+        }
+        if (!file.eof())
+        {
+          throw Exception() << "Couldn't parse site weights file '" << path << "'";
+        }
+
+        for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; ++collisionType)
+        {
+          if (!read[collisionType])
+          {
+            throw Exception() << "No weight for " << GetCollisionTypeName(collisionType)
+                << " sites in site weights file '" << path << "'";
+          }
+        }
+        return result;
+      }
+
+      void SiteWeights::Write(const std::string& path) const
+      {
+        std::ofstream file(path.c_str());
+        for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; ++collisionType)
+        {
+          file << GetCollisionTypeName(collisionType) << " " << weights[collisionType] << std::endl;
+        }
+        if (!file)
+        {
+          throw Exception() << "Couldn't write site weights file '" << path << "'";
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,77 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_GEOMETRY_DECOMPOSITION_SITEWEIGHTS_H
+#define HEMELB_GEOMETRY_DECOMPOSITION_SITEWEIGHTS_H
+
+#include <string>
+#include "constants.h"
+
+namespace hemelb
+{
+  namespace geometry
+  {
+    namespace decomposition
+    {
+      /**
+       * The relative cost of a site of each collision type, which the decomposition balances.
+       *
+       * By default these are the weights built in for the architecture and boundary conditions
+       * chosen at configure time, but they can be read from a file, such as one written by
+       * calibrating the collision kernels on the machine in question. The file has one line
+       * for each collision type, giving its name and then its weight:
+       *
+       *   bulk 4
+       *   wall 8
+       *   ...
+       *
+       * with the names given by GetCollisionTypeName.
+       */
+      class SiteWeights
+      {
+        public:
+          /**
+           * The built-in weights.
+           */
+          SiteWeights();
+
+          /**
+           * Read weights from a file.
+           * @param path
+           * @return The weights
+           */
+          static SiteWeights Read(const std::string& path);
+
+          /**
+           * Write the weights to a file that Read can read.
+           * @param path
+           */
+          void Write(const std::string& path) const;
+
+          /**
+           * @param collisionType
+           * @return The name of the collision type in weights files
+           */
+          static const char* GetCollisionTypeName(unsigned collisionType);
+
+          int operator[](unsigned collisionType) const
+          {
+            return weights[collisionType];
+          }
+
+          void Set(unsigned collisionType, int weight)
+          {
+            weights[collisionType] = weight;
+          }
+
+        private:
+          int weights[COLLISION_TYPES];
+      };
+    }
+  }
+}
+
+#endif /* HEMELB_GEOMETRY_DECOMPOSITION_SITEWEIGHTS_H */
@@ -108,16 +108,27 @@ namespace hemelb
         // on the sending and receiving procs.
         // But, the needsEachProcHasFromMe is always ordered,
         // by the same order, as the neededSites, so this should be OK.
+        const unsigned numVectors = localLatticeData.GetLatticeInfo().GetNumVectors();
         for (std::vector<site_t>::iterator localNeed = neededSites.begin();
             localNeed != neededSites.end(); localNeed++)
         {
           proc_t source = ProcForSite(*localNeed);
           NeighbouringSite site = neighbouringLatticeData.GetSite(*localNeed);
-          net.RequestReceive(site.GetFOld(localLatticeData.GetLatticeInfo().GetNumVectors()),
-                             localLatticeData.GetLatticeInfo().GetNumVectors(),
-                             source);
+          net.RequestReceive(site.GetFOld(numVectors), numVectors, source);
+
+        }
 
+        // Whatever the local distribution layout and precision, the distributions are sent
+        // from a buffer, as distribn_t, one site after another. The buffer is sized before any
+        // send is requested, so that it isn't reallocated under the requests.
+        site_t sendCount = 0;
+        for (proc_t other = 0; other < net.Size(); other++)
+        {
+          sendCount += needsEachProcHasFromMe[other].size();
         }
+        sendBuffer.resize(sendCount * numVectors);
+
+        site_t sendIndex = 0;
         for (proc_t other = 0; other < net.Size(); other++)
         {
           for (std::vector<site_t>::iterator needOnProcFromMe =
@@ -126,13 +137,14 @@ namespace hemelb
           {
             site_t localContiguousId =
                 localLatticeData.GetLocalContiguousIdFromGlobalNoncontiguousId(*needOnProcFromMe);
-            Site<LatticeData> site =
+            const Site<LatticeData> site =
                 const_cast<LatticeData&>(localLatticeData).GetSite(localContiguousId);
-            // have to cast away the const, because no respect for const-ness for sends in MPI
-            net.RequestSend(const_cast<distribn_t*>(site.GetFOld(localLatticeData.GetLatticeInfo().GetNumVectors())),
-                            localLatticeData.GetLatticeInfo().GetNumVectors(),
-                            other);
-
+            for (Direction direction = 0; direction < numVectors; direction++)
+            {
+              sendBuffer[sendIndex + direction] = site.GetFOldInDirection(direction);
+            }
+            net.RequestSend(&sendBuffer[sendIndex], numVectors, other);
+            sendIndex += numVectors;
           }
         }
       }
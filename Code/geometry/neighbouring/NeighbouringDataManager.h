@@ -57,6 +57,7 @@ namespace hemelb
 
           std::vector<site_t> neededSites;
           std::vector<std::vector<site_t> > needsEachProcHasFromMe;
+          std::vector<distribn_t> sendBuffer; //! The distributions of the sites other procs need from me, as sent.
 
           bool needsHaveBeenShared;
 
@@ -77,6 +77,32 @@ namespace hemelb
            */
           const distribn_t* GetFOld(site_t distributionIndex) const;
 
+          /**
+           * Neighbouring data always holds each site's distributions contiguously.
+           */
+          static const bool SITE_CONTIGUOUS_DISTRIBUTIONS = true;
+
+          template<typename LatticeType>
+          site_t GetDistributionIndex(site_t globalIndex, Direction direction) const
+          {
+            return globalIndex * LatticeType::NUMVECTORS + direction;
+          }
+
+          template<typename LatticeType>
+          site_t GetFOldIndex(site_t globalIndex, Direction direction) const
+          {
+            return GetDistributionIndex<LatticeType>(globalIndex, direction);
+          }
+
+          /**
+           * Neighbouring data is always held as distribn_t, so this is just the stored value.
+           */
+          template<typename LatticeType>
+          distribn_t GetFOldValue(site_t distributionIndex, Direction direction) const
+          {
+            return *GetFOld(distributionIndex);
+          }
+
           /*
            * This is not defined for Neighbouring Data.
            * Data streamed across boundaries is handled by the existing mechanism.
@@ -25,6 +25,8 @@ namespace hemelb
       imageDirectory = outputDir + "/Images/";
       dataPath = outputDir + "/Extracted/";
       colloidFile = outputDir + "/ColloidOutput.xdr";
+      timelineFile = outputDir + "/timeline.json";
+      checkpointFile = outputDir + "/checkpoint.dat";
 
       if (doIo)
       {
@@ -50,6 +52,14 @@ namespace hemelb
     {
       return colloidFile;
     }
+    const std::string & PathManager::GetTimelinePath() const
+    {
+      return timelineFile;
+    }
+    const std::string & PathManager::GetCheckpointPath() const
+    {
+      return checkpointFile;
+    }
     const std::string & PathManager::GetReportPath() const
     {
       return reportName;
@@ -50,6 +50,16 @@ namespace hemelb
          * @return
          */
         const std::string & GetColloidPath() const;
+        /**
+         * Path to where the timeline of the actions in each time step should be written.
+         * @return Reference to path to where the timeline should be written.
+         */
+        const std::string & GetTimelinePath() const;
+        /**
+         * Path to where checkpoints of the run should be written.
+         * @return Reference to path to where checkpoints should be written.
+         */
+        const std::string & GetCheckpointPath() const;
         /**
          * Path to where a run report file should be created.
          * @return Reference to path to where a run report file should be created.
@@ -84,6 +94,8 @@ namespace hemelb
         std::string inputFile;
         std::string imageDirectory;
         std::string colloidFile;
+        std::string timelineFile;
+        std::string checkpointFile;
         std::string configLeafName;
         std::string reportName;
         std::string dataPath;
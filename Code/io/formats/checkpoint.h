@@ -0,0 +1,63 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_IO_FORMATS_CHECKPOINT_H
+#define HEMELB_IO_FORMATS_CHECKPOINT_H
+
+#include "io/formats/formats.h"
+
+namespace hemelb
+{
+  namespace io
+  {
+    namespace formats
+    {
+      namespace checkpoint
+      {
+        /* The format comprises a header and then a body. Unlike the other formats, it is
+         * written in the machine's native representation, since it is only for restarting the
+         * same build.
+         *
+         * Header is made up of (hex file position, type, description)
+         * 00   uint64     HemeLB magic number (see formats.h)
+         * 08   uint64     Checkpoint magic number (see below)
+         * 10   uint64     Version number
+         * 18   uint64     Number of distributions per site
+         * 20   uint64     The last time step completed
+         * 28   uint64     Number of ranks that wrote the file, for information
+         * 30   uint64     Number of fluid sites
+         * 38   uint64     Number of colloid particles
+         * Header length = 64 bytes
+         *
+         * The body has the distributions of each fluid site as doubles, in the order of the
+         * fluid sites in the geometry file, i.e. block by block and then site by site within
+         * each block, so that it doesn't depend on the decomposition. The particles follow, in
+         * no particular order, in the representation of their MPI datatype.
+         */
+
+        enum
+        {
+          /* Identify checkpoint files
+           * ASCII for 'chk', then EOF
+           * Combined magic number is
+           * hex    68 6c 62 21 63 68 6b 04
+           * ascii:  h  l  b  !  c  h  k EOF
+           */
+          MagicNumber = 0x63686b04
+        };
+        enum
+        {
+          VersionNumber = 2
+        };
+        enum
+        {
+          HeaderLength = 64
+        };
+      }
+    }
+  }
+}
+#endif // HEMELB_IO_FORMATS_CHECKPOINT_H
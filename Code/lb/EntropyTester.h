@@ -65,7 +65,8 @@ namespace hemelb
               {
                 const geometry::Site<const geometry::LatticeData> site = mLatDat->GetSite(i);
 
-                HFunction<LatticeType> HFunc(site.GetFOld<LatticeType>(), NULL);
+                distribn_t fOldBuffer[LatticeType::NUMVECTORS];
+                HFunction<LatticeType> HFunc(site.LoadFOld<LatticeType>(fOldBuffer), NULL);
                 dHMax = util::NumericalFunctions::max(dHMax, HFunc.eval() - mHPreCollision[i]);
               }
             }
@@ -81,7 +82,8 @@ namespace hemelb
               {
                 const geometry::Site<const geometry::LatticeData> site = mLatDat->GetSite(i);
 
-                HFunction<LatticeType> HFunc(site.GetFOld<LatticeType>(), NULL);
+                distribn_t fOldBuffer[LatticeType::NUMVECTORS];
+                HFunction<LatticeType> HFunc(site.LoadFOld<LatticeType>(fOldBuffer), NULL);
                 dHMax = util::NumericalFunctions::max(dHMax, HFunc.eval() - mHPreCollision[i]);
               }
             }
@@ -137,7 +139,8 @@ namespace hemelb
               for (site_t i = offset; i < offset + mLatDat->GetMidDomainCollisionCount(collision_type); i++)
               {
                 const geometry::Site<const geometry::LatticeData> site = mLatDat->GetSite(i);
-                HFunction<LatticeType> HFunc(site.GetFOld<LatticeType>(), NULL);
+                distribn_t fOldBuffer[LatticeType::NUMVECTORS];
+                HFunction<LatticeType> HFunc(site.LoadFOld<LatticeType>(fOldBuffer), NULL);
                 mHPreCollision[i] = HFunc.eval();
               }
             }
@@ -152,7 +155,8 @@ namespace hemelb
               for (site_t i = offset; i < offset + mLatDat->GetDomainEdgeCollisionCount(collision_type); i++)
               {
                 const geometry::Site<const geometry::LatticeData> site = mLatDat->GetSite(i);
-                HFunction<LatticeType> HFunc(site.GetFOld<LatticeType>(), NULL);
+                distribn_t fOldBuffer[LatticeType::NUMVECTORS];
+                HFunction<LatticeType> HFunc(site.LoadFOld<LatticeType>(fOldBuffer), NULL);
                 mHPreCollision[i] = HFunc.eval();
               }
             }
@@ -20,6 +20,7 @@ namespace hemelb
       stressTensorCache(simState, latticeData.GetLocalFluidSiteCount()),
       tractionCache(simState, latticeData.GetLocalFluidSiteCount()),
       tangentialProjectionTractionCache(simState, latticeData.GetLocalFluidSiteCount()),
+      stabilityAccumulator(latticeData.GetLocalFluidSiteCount()),
       siteCount(latticeData.GetLocalFluidSiteCount())
     {
       ResetRequirements();
@@ -37,10 +38,32 @@ namespace hemelb
       tangentialProjectionTractionCache.UnsetRefreshFlag();
     }
 
+    bool MacroscopicPropertyCache::AnyRequiresRefresh() const
+    {
+      return densityCache.RequiresRefresh() || velocityCache.RequiresRefresh()
+          || vonMisesStressCache.RequiresRefresh() || wallShearStressMagnitudeCache.RequiresRefresh()
+          || shearRateCache.RequiresRefresh() || stressTensorCache.RequiresRefresh()
+          || tractionCache.RequiresRefresh() || tangentialProjectionTractionCache.RequiresRefresh();
+    }
+
     site_t MacroscopicPropertyCache::GetSiteCount() const
     {
       return siteCount;
     }
+
+    void MacroscopicPropertyCache::Resize(const geometry::LatticeData& latticeData)
+    {
+      siteCount = latticeData.GetLocalFluidSiteCount();
+      densityCache.Resize(siteCount);
+      velocityCache.Resize(siteCount);
+      wallShearStressMagnitudeCache.Resize(siteCount);
+      vonMisesStressCache.Resize(siteCount);
+      shearRateCache.Resize(siteCount);
+      stressTensorCache.Resize(siteCount);
+      tractionCache.Resize(siteCount);
+      tangentialProjectionTractionCache.Resize(siteCount);
+      stabilityAccumulator.Resize(siteCount);
+    }
   }
 }
 
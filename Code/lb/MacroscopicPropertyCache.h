@@ -10,6 +10,7 @@
 #include <vector>
 #include "geometry/LatticeData.h"
 #include "lb/SimulationState.h"
+#include "lb/StabilityAccumulator.h"
 #include "units.h"
 #include "util/RefreshableCache.hpp"
 
@@ -37,12 +38,24 @@ namespace hemelb
          */
         void ResetRequirements();
 
+        /**
+         * True if any of the caches needs to be refreshed on this iteration.
+         * @return
+         */
+        bool AnyRequiresRefresh() const;
+
         /**
          * Returns the number of sites cached.
          * @return
          */
         site_t GetSiteCount() const;
 
+        /**
+         * Resize the caches for the local fluid sites of the lattice, after it is rebuilt.
+         * @param latticeData
+         */
+        void Resize(const geometry::LatticeData& latticeData);
+
         /**
          * The cache of densities for each fluid site on this core.
          */
@@ -83,6 +96,12 @@ namespace hemelb
          */
         util::RefreshableCache<util::Vector3D<LatticeStress> > tangentialProjectionTractionCache;
 
+        /**
+         * The stability and convergence of the fluid sites on this core, gathered during the
+         * collision.
+         */
+        StabilityAccumulator stabilityAccumulator;
+
       private:
         /**
          * The state of the simulation, including the number of timesteps passed.
@@ -30,6 +30,7 @@ namespace hemelb
 
         void Increment();
         void Reset();
+        void SetTimeStep(LatticeTimeStep value);
         void SetIsTerminating(bool value);
         void SetIsRendering(bool value);
         void SetStability(Stability value);
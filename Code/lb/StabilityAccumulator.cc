@@ -0,0 +1,63 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "lb/StabilityAccumulator.h"
+
+namespace hemelb
+{
+  namespace lb
+  {
+    StabilityAccumulator::StabilityAccumulator(site_t siteCount) :
+        siteCount(siteCount), checking(false), recording(false), doConvergenceCheck(false),
+            convergenceReferenceValue(1.0), convergenceRelativeTolerance(0.0),
+            unstableSitePresent(false), unconvergedSitePresent(false)
+    {
+    }
+
+    void StabilityAccumulator::EnableConvergenceCheck(distribn_t referenceValue,
+                                                      distribn_t relativeTolerance)
+    {
+      doConvergenceCheck = true;
+      convergenceReferenceValue = referenceValue;
+      convergenceRelativeTolerance = relativeTolerance;
+      previousVelocities.assign(siteCount, util::Vector3D<distribn_t>(0.0));
+    }
+
+    void StabilityAccumulator::SetChecking(bool check)
+    {
+      checking = check;
+    }
+
+    void StabilityAccumulator::SetRecording(bool record)
+    {
+      recording = record;
+    }
+
+    bool StabilityAccumulator::FoundUnstableSite() const
+    {
+      return unstableSitePresent.load();
+    }
+
+    bool StabilityAccumulator::FoundUnconvergedSite() const
+    {
+      return unconvergedSitePresent.load();
+    }
+
+    void StabilityAccumulator::ResetFlags()
+    {
+      unstableSitePresent.store(false);
+      unconvergedSitePresent.store(false);
+    }
+
+    void StabilityAccumulator::Resize(site_t newSiteCount)
+    {
+      siteCount = newSiteCount;
+      if (doConvergenceCheck)
+      {
+        previousVelocities.assign(siteCount, util::Vector3D<distribn_t>(0.0));
+      }
+    }
+  }
+}
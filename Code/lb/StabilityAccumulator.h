@@ -0,0 +1,159 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_LB_STABILITYACCUMULATOR_H
+#define HEMELB_LB_STABILITYACCUMULATOR_H
+
+#include <atomic>
+#include <vector>
+#include "units.h"
+#include "util/Vector3D.h"
+
+namespace hemelb
+{
+  namespace lb
+  {
+    /**
+     * Gathers the local stability and convergence of the simulation as a side effect of the
+     * collision, so that they can be assessed without another pass over the distributions.
+     *
+     * Each streamer passes the distributions it collides at each site to Accumulate. On steps
+     * when checking is turned on, any distribution that isn't positive (including NaNs) marks
+     * the rank as unstable, and any site whose velocity has changed by more than the tolerance
+     * since it was last recorded marks the rank as unconverged. On steps when recording is
+     * turned on, the velocity at each site is kept for the next check.
+     *
+     * The distributions collided on a step are those produced by the step before, so the
+     * checks made on a step describe the state at the end of the previous one.
+     *
+     * Sites may be accumulated concurrently from several threads.
+     */
+    class StabilityAccumulator
+    {
+      public:
+        /**
+         * Constructor.
+         * @param siteCount The number of local fluid sites.
+         */
+        StabilityAccumulator(site_t siteCount);
+
+        /**
+         * Turn on checking the convergence of the velocity field, as well as stability.
+         * @param referenceValue The velocity used to normalise changes in velocity.
+         * @param relativeTolerance The largest relative change allowed in a converged flow.
+         */
+        void EnableConvergenceCheck(distribn_t referenceValue, distribn_t relativeTolerance);
+
+        /**
+         * Set whether sites are to be checked on the coming step.
+         * @param check
+         */
+        void SetChecking(bool check);
+
+        /**
+         * Set whether site velocities are to be recorded on the coming step, for comparison at
+         * the next check.
+         * @param record
+         */
+        void SetRecording(bool record);
+
+        /**
+         * True if sites need to be passed to Accumulate on this step.
+         * @return
+         */
+        bool IsActive() const
+        {
+          return checking || recording;
+        }
+
+        /**
+         * True if a site has been found to be unstable since the last call to ResetFlags.
+         * @return
+         */
+        bool FoundUnstableSite() const;
+
+        /**
+         * True if a site has been found not to have converged since the last call to ResetFlags.
+         * @return
+         */
+        bool FoundUnconvergedSite() const;
+
+        /**
+         * Clear the unstable and unconverged flags, ready for the next check.
+         */
+        void ResetFlags();
+
+        /**
+         * Change the number of local fluid sites, e.g. when the sites are redistributed. The
+         * velocities recorded for the convergence check are lost.
+         * @param siteCount
+         */
+        void Resize(site_t siteCount);
+
+        /**
+         * Check and record the state of one site, given the distributions it is about to
+         * collide and the moments calculated from them.
+         * @param siteIndex
+         * @param f
+         * @param density
+         * @param momentum
+         */
+        template<class LatticeType>
+        inline void Accumulate(site_t siteIndex, const distribn_t* f, distribn_t density,
+                               const util::Vector3D<distribn_t>& momentum)
+        {
+          if (checking)
+          {
+            for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+            {
+              // Note that by testing for value > 0.0, we also catch stray NaNs.
+              if (! (f[direction] > 0.0))
+              {
+                unstableSitePresent.store(true, std::memory_order_relaxed);
+                break;
+              }
+            }
+          }
+
+          if (doConvergenceCheck)
+          {
+            const util::Vector3D<distribn_t> velocity = momentum / density;
+
+            if (checking
+                && (velocity - previousVelocities[siteIndex]).GetMagnitude() / convergenceReferenceValue
+                    > convergenceRelativeTolerance)
+            {
+              unconvergedSitePresent.store(true, std::memory_order_relaxed);
+            }
+
+            if (recording)
+            {
+              previousVelocities[siteIndex] = velocity;
+            }
+          }
+        }
+
+      private:
+        site_t siteCount;
+
+        bool checking;
+        bool recording;
+
+        bool doConvergenceCheck;
+        distribn_t convergenceReferenceValue;
+        distribn_t convergenceRelativeTolerance;
+
+        /**
+         * The velocity at each site when last recorded. Only allocated when checking convergence.
+         */
+        std::vector<util::Vector3D<distribn_t> > previousVelocities;
+
+        std::atomic<bool> unstableSitePresent;
+        std::atomic<bool> unconvergedSitePresent;
+    };
+  }
+}
+
+#endif /* HEMELB_LB_STABILITYACCUMULATOR_H */
@@ -9,6 +9,7 @@
 
 #include "net/PhasedBroadcastRegular.h"
 #include "geometry/LatticeData.h"
+#include "lb/MacroscopicPropertyCache.h"
 
 namespace hemelb
 {
@@ -31,14 +32,48 @@ namespace hemelb
     {
       public:
         StabilityTester(const geometry::LatticeData * iLatDat, net::Net* net,
-                        SimulationState* simState, reporting::Timers& timings,
+                        SimulationState* simState, MacroscopicPropertyCache& propertyCache,
+                        reporting::Timers& timings,
                         const hemelb::configuration::SimConfig::MonitoringConfig* testerConfig) :
             net::PhasedBroadcastRegular<>(net, simState, SPREADFACTOR), mLatDat(iLatDat),
-                mSimState(simState), timings(timings), testerConfig(testerConfig)
+                mSimState(simState), mAccumulator(propertyCache.stabilityAccumulator),
+                timings(timings), testerConfig(testerConfig), mVelocitiesComparable(false),
+                mVelocitiesRecorded(false)
         {
+          // Checks can only be made on the cycles when this node sends to its parent, so the
+          // interval is rounded up to a whole number of cycles.
+          const unsigned long cycleLength = GetCycleLength();
+          mCyclesBetweenChecks = (testerConfig->stabilityCheckInterval + cycleLength - 1)
+              / cycleLength;
+
+          if (testerConfig->doConvergenceCheck)
+          {
+            mAccumulator.EnableConvergenceCheck(testerConfig->convergenceReferenceValue,
+                                                testerConfig->convergenceRelativeTolerance);
+          }
+
           Reset();
         }
 
+        /**
+         * Tell the streamers whether to check or record the state of the sites on this step,
+         * before any of them collide.
+         */
+        void RequestComms()
+        {
+          net::PhasedBroadcastRegular<>::RequestComms();
+
+          const unsigned long step = mSimState->Get0IndexedTimeStep();
+
+          // The velocities to compare with at a check are recorded on the step before it.
+          const bool recordThisStep = testerConfig->doConvergenceCheck && IsCheckCycle(step + 1);
+          mVelocitiesComparable = mVelocitiesRecorded;
+          mVelocitiesRecorded = recordThisStep;
+
+          mAccumulator.SetChecking(IsCheckCycle(step));
+          mAccumulator.SetRecording(recordThisStep);
+        }
+
         /**
          * Override the reset method in the base class, to reset the stability variables.
          */
@@ -47,6 +82,10 @@ namespace hemelb
           mUpwardsStability = UndefinedStability;
           mDownwardsStability = UndefinedStability;
 
+          mLocallyUnstable = false;
+          mLocallyConverged = false;
+          mAccumulator.ResetFlags();
+
           mSimState->SetStability(UndefinedStability);
 
           for (unsigned int ii = 0; ii < SPREADFACTOR; ii++)
@@ -81,9 +120,9 @@ namespace hemelb
         }
 
         /**
-         * The algorithm that checks distribution function convergence must be run in this
-         * method rather than in ProgressToParent to make sure that the current timestep has
-         * finished streaming.
+         * The local stability and convergence are gathered by the streamers during the
+         * collision of the step this is called on (see StabilityAccumulator), so all that's
+         * needed here is to read them, on the cycles when they were checked.
          *
          * @param splayNumber
          */
@@ -91,116 +130,35 @@ namespace hemelb
         {
           timings[hemelb::reporting::Timers::monitoring].Start();
 
-          // No need to bother testing out local lattice points if we're going to be
-          // sending up a 'Unstable' value anyway.
-          if (mUpwardsStability != Unstable)
+          if (IsCheckCycle(mSimState->Get0IndexedTimeStep()))
           {
-            bool unconvergedSitePresent = false;
-
-            for (site_t i = 0; i < mLatDat->GetLocalFluidSiteCount(); i++)
-            {
-              for (unsigned int l = 0; l < LatticeType::NUMVECTORS; l++)
-              {
-                distribn_t value = *mLatDat->GetFNew(i * LatticeType::NUMVECTORS + l);
-
-                // Note that by testing for value > 0.0, we also catch stray NaNs.
-                if (! (value > 0.0))
-                {
-                  mUpwardsStability = Unstable;
-                  break;
-                }
-              }
-              ///@todo: If we refactor the previous loop out, we can get away with a single break statement
-              if (mUpwardsStability == Unstable)
-              {
-                break;
-              }
-
-              if (testerConfig->doConvergenceCheck)
-              {
-                distribn_t relativeDifference =
-                    ComputeRelativeDifference(mLatDat->GetFNew(i * LatticeType::NUMVECTORS),
-                                              mLatDat->GetSite(i).GetFOld<LatticeType>());
-
-                if (relativeDifference > testerConfig->convergenceRelativeTolerance)
-                {
-                  // The simulation is stable but hasn't converged in the whole domain yet.
-                  unconvergedSitePresent = true;
-                }
-              }
-            }
-
-            switch (mUpwardsStability)
-            {
-              case UndefinedStability:
-              case Stable:
-              case StableAndConverged:
-                mUpwardsStability = (testerConfig->doConvergenceCheck && !unconvergedSitePresent) ?
-                  StableAndConverged :
-                  Stable;
-                break;
-              case Unstable:
-                break;
-            }
+            mLocallyUnstable = mAccumulator.FoundUnstableSite();
+            // Until the velocities have been recorded on the step before a check, we can't
+            // tell whether the flow has converged.
+            mLocallyConverged = mVelocitiesComparable && !mAccumulator.FoundUnconvergedSite();
+            mAccumulator.ResetFlags();
           }
 
-          timings[hemelb::reporting::Timers::monitoring].Stop();
-        }
-
-        /**
-         * Computes the relative difference between the densities at the beginning and end of a
-         * timestep, i.e. |(rho_new - rho_old) / (rho_old - rho_0)|.
-         *
-         * @param fNew Distribution function after stream and collide, i.e. solution of the current timestep.
-         * @param fOld Distribution function at the end of the previous timestep.
-         * @return relative difference between the densities computed from fNew and fOld.
-         */
-        inline double ComputeRelativeDifference(const distribn_t* fNew,
-                                                const distribn_t* fOld) const
-        {
-          distribn_t newDensity;
-          distribn_t newMomentumX;
-          distribn_t newMomentumY;
-          distribn_t newMomentumZ;
-          LatticeType::CalculateDensityAndMomentum(fNew,
-                                                   newDensity,
-                                                   newMomentumX,
-                                                   newMomentumY,
-                                                   newMomentumZ);
-
-          distribn_t oldDensity;
-          distribn_t oldMomentumX;
-          distribn_t oldMomentumY;
-          distribn_t oldMomentumZ;
-          LatticeType::CalculateDensityAndMomentum(fOld,
-                                                   oldDensity,
-                                                   oldMomentumX,
-                                                   oldMomentumY,
-                                                   oldMomentumZ);
-
-          distribn_t absoluteError;
-          distribn_t referenceValue;
-
-          switch (testerConfig->convergenceVariable)
+          // On cycles in between checks, the result of the last check stands.
+          if (mLocallyUnstable)
           {
-            case extraction::OutputField::Velocity:
-            {
-              distribn_t diff_vel_x = newMomentumX / newDensity - oldMomentumX / oldDensity;
-              distribn_t diff_vel_y = newMomentumY / newDensity - oldMomentumY / oldDensity;
-              distribn_t diff_vel_z = newMomentumZ / newDensity - oldMomentumZ / oldDensity;
+            mUpwardsStability = Unstable;
+          }
 
-              absoluteError = sqrt(diff_vel_x * diff_vel_x + diff_vel_y * diff_vel_y
-                  + diff_vel_z * diff_vel_z);
-              referenceValue = testerConfig->convergenceReferenceValue;
+          switch (mUpwardsStability)
+          {
+            case UndefinedStability:
+            case Stable:
+            case StableAndConverged:
+              mUpwardsStability = (testerConfig->doConvergenceCheck && mLocallyConverged) ?
+                StableAndConverged :
+                Stable;
+              break;
+            case Unstable:
               break;
-            }
-            default:
-              // Never reached
-              throw Exception()
-                  << "Convergence check based on requested variable currently not available";
           }
 
-          return absoluteError / referenceValue;
+          timings[hemelb::reporting::Timers::monitoring].Stop();
         }
 
         /**
@@ -278,6 +236,34 @@ namespace hemelb
         }
 
       private:
+        /**
+         * The number of time steps between the starts of successive cycles of the broadcast.
+         */
+        unsigned long GetCycleLength() const
+        {
+          return GetTreeDepth() > 0 ?
+            GetRoundTripLength() :
+            1;
+        }
+
+        /**
+         * True if the given step is one on which this node sends its stability to its parent,
+         * in a cycle on which the stability is to be checked.
+         */
+        bool IsCheckCycle(unsigned long step)
+        {
+          const unsigned long cycleLength = GetCycleLength();
+          const unsigned long cycleNumber = GetTreeDepth() > 0 ?
+            step % cycleLength :
+            0;
+          const unsigned long firstAscent = GetFirstAscending();
+          unsigned long sendOverlap;
+
+          return cycleNumber >= firstAscent
+              && GetSendParentOverlap(cycleNumber - firstAscent, &sendOverlap)
+              && (step / cycleLength) % mCyclesBetweenChecks == 0;
+        }
+
         /**
          * Slightly arbitrary spread factor for the tree.
          */
@@ -302,11 +288,34 @@ namespace hemelb
          */
         lb::SimulationState* mSimState;
 
+        /**
+         * The per-site checks made by the streamers.
+         */
+        StabilityAccumulator& mAccumulator;
+
         /** Timing object. */
         reporting::Timers& timings;
 
         /** Object containing the user-provided configuration for this class */
         const hemelb::configuration::SimConfig::MonitoringConfig* testerConfig;
+
+        /**
+         * The number of broadcast cycles from one check to the next.
+         */
+        unsigned long mCyclesBetweenChecks;
+
+        /**
+         * The outcome of the last check of the local sites.
+         */
+        bool mLocallyUnstable;
+        bool mLocallyConverged;
+
+        /**
+         * Whether the site velocities were recorded on the previous step, and whether they are
+         * being recorded on this one.
+         */
+        bool mVelocitiesComparable;
+        bool mVelocitiesRecorded;
     };
   }
 }
@@ -89,6 +89,16 @@ namespace hemelb
           {
             return false;
           }
+
+          /***
+           * Whether the iolet's condition depends on more than the time step, e.g. on values
+           * received from a coupled code, so that restarting from a checkpoint can't restore it.
+           * @return true if the iolet keeps state between time steps.
+           */
+          virtual bool IsStateful() const
+          {
+            return false;
+          }
           void SetComms(BoundaryComms * boundaryComms)
           {
             comms = boundaryComms;
@@ -62,6 +62,10 @@ namespace hemelb
       {
         return true;
       }
+      bool InOutLetMultiscale::IsStateful() const
+      {
+        return true;
+      }
       int InOutLetMultiscale::GetNumberOfFieldPoints() const
       {
         return numberOfFieldPoints;
@@ -49,6 +49,7 @@ namespace hemelb
           virtual void Initialise(const util::UnitConverter* unitConverter);
           virtual void Reset(SimulationState &state);
           virtual bool IsRegistrationRequired() const;
+          virtual bool IsStateful() const;
 
           virtual int GetNumberOfFieldPoints() const;
           // returns the number of field points that are exchanged with the coupled code.
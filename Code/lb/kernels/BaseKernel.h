@@ -215,6 +215,16 @@ namespace hemelb
 
       };
 
+      /**
+       * Whether a kernel keeps data for each site from one time step to the next, besides the
+       * distributions. Kernels that do must specialise this.
+       */
+      template<typename KernelImpl>
+      struct KeepsSiteState
+      {
+          static const bool value = false;
+      };
+
     }
   }
 }
@@ -59,9 +59,11 @@ namespace hemelb
            */
           Entropic(InitParams* initParams)
           {
-            oldAlpha = new distribn_t[initParams->latDat->GetLocalFluidSiteCount()];
-            // Initialises the value of alpha to 2.0 for every site.
-            for (site_t i = 0; i < initParams->latDat->GetLocalFluidSiteCount(); i++)
+            const site_t siteCount = initParams->latDat->GetLocalFluidSiteCount()
+                + initParams->latDat->GetHaloSiteCount();
+            oldAlpha = new distribn_t[siteCount];
+            // Initialises the value of alpha to 2.0 for every site, including those in the halo.
+            for (site_t i = 0; i < siteCount; i++)
             {
               oldAlpha[i] = 2.0;
             }
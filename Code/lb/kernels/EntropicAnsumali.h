@@ -103,6 +103,15 @@ namespace hemelb
             }
           }
       };
+
+      /**
+       * The entropic kernels keep each site's alpha from the previous step.
+       */
+      template<class LatticeType>
+      struct KeepsSiteState<EntropicAnsumali<LatticeType> >
+      {
+          static const bool value = true;
+      };
     }
   }
 }
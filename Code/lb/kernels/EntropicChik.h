@@ -101,6 +101,15 @@ namespace hemelb
           }
       };
 
+      /**
+       * The entropic kernels keep each site's alpha from the previous step.
+       */
+      template<class LatticeType>
+      struct KeepsSiteState<EntropicChik<LatticeType> >
+      {
+          static const bool value = true;
+      };
+
     }
   }
 }
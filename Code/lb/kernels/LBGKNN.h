@@ -120,7 +120,8 @@ namespace hemelb
           void InitState(const InitParams& initParams)
           {
             // Initialise relaxation time across the domain to HemeLB's default value.
-            mTau.resize(initParams.latDat->GetLocalFluidSiteCount(), initParams.lbmParams->GetTau());
+            mTau.resize(initParams.latDat->GetLocalFluidSiteCount() + initParams.latDat->GetHaloSiteCount(),
+                        initParams.lbmParams->GetTau());
             mTimeStep = initParams.lbmParams->GetTimeStep();
             mSpaceStep = initParams.lbmParams->GetVoxelSize();
           }
@@ -158,6 +159,15 @@ namespace hemelb
 #endif
           }
       };
+
+      /**
+       * LBGKNN keeps each site's relaxation time from the previous step.
+       */
+      template<class tRheologyModel, class LatticeType>
+      struct KeepsSiteState<LBGKNN<tRheologyModel, LatticeType> >
+      {
+          static const bool value = true;
+      };
     }
   }
 }
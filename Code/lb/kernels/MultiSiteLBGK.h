@@ -0,0 +1,324 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_LB_KERNELS_MULTISITELBGK_H
+#define HEMELB_LB_KERNELS_MULTISITELBGK_H
+
+#if defined(HEMELB_USE_AVX512) || defined(HEMELB_USE_AVX2)
+  #include <immintrin.h>
+#endif
+
+#include "units.h"
+
+/**
+ * Functions that use SiteVector are compiled for the instructions it needs, while the rest of
+ * HemeLB isn't, so that a build that uses them still runs on a CPU without them.
+ */
+#if defined(HEMELB_USE_AVX512)
+  #define HEMELB_SIMD_TARGET __attribute__((target("avx512f")))
+#elif defined(HEMELB_USE_AVX2)
+  #define HEMELB_SIMD_TARGET __attribute__((target("avx2")))
+#else
+  #define HEMELB_SIMD_TARGET
+#endif
+
+namespace hemelb
+{
+  namespace lb
+  {
+    namespace kernels
+    {
+      namespace simd
+      {
+#if defined(HEMELB_USE_AVX512)
+        /**
+         * The value of one quantity at eight sites, held in an AVX-512 register.
+         */
+        struct SiteVector
+        {
+            static const unsigned WIDTH = 8;
+
+            SiteVector()
+            {
+            }
+
+            HEMELB_SIMD_TARGET SiteVector(__m512d value) :
+                value(value)
+            {
+            }
+
+            HEMELB_SIMD_TARGET explicit SiteVector(distribn_t scalar) :
+                value(_mm512_set1_pd(scalar))
+            {
+            }
+
+            HEMELB_SIMD_TARGET static SiteVector Load(const distribn_t* source)
+            {
+              return SiteVector(_mm512_loadu_pd(source));
+            }
+
+            HEMELB_SIMD_TARGET void Store(distribn_t* destination) const
+            {
+              _mm512_storeu_pd(destination, value);
+            }
+
+            __m512d value;
+        };
+
+        HEMELB_SIMD_TARGET inline SiteVector operator+(const SiteVector& a, const SiteVector& b)
+        {
+          return SiteVector(_mm512_add_pd(a.value, b.value));
+        }
+
+        HEMELB_SIMD_TARGET inline SiteVector operator-(const SiteVector& a, const SiteVector& b)
+        {
+          return SiteVector(_mm512_sub_pd(a.value, b.value));
+        }
+
+        HEMELB_SIMD_TARGET inline SiteVector operator*(const SiteVector& a, const SiteVector& b)
+        {
+          return SiteVector(_mm512_mul_pd(a.value, b.value));
+        }
+
+        HEMELB_SIMD_TARGET inline SiteVector operator/(const SiteVector& a, const SiteVector& b)
+        {
+          return SiteVector(_mm512_div_pd(a.value, b.value));
+        }
+#elif defined(HEMELB_USE_AVX2)
+        /**
+         * The value of one quantity at four sites, held in an AVX register.
+         */
+        struct SiteVector
+        {
+            static const unsigned WIDTH = 4;
+
+            SiteVector()
+            {
+            }
+
+            HEMELB_SIMD_TARGET SiteVector(__m256d value) :
+                value(value)
+            {
+            }
+
+            HEMELB_SIMD_TARGET explicit SiteVector(distribn_t scalar) :
+                value(_mm256_set1_pd(scalar))
+            {
+            }
+
+            HEMELB_SIMD_TARGET static SiteVector Load(const distribn_t* source)
+            {
+              return SiteVector(_mm256_loadu_pd(source));
+            }
+
+            HEMELB_SIMD_TARGET void Store(distribn_t* destination) const
+            {
+              _mm256_storeu_pd(destination, value);
+            }
+
+            __m256d value;
+        };
+
+        HEMELB_SIMD_TARGET inline SiteVector operator+(const SiteVector& a, const SiteVector& b)
+        {
+          return SiteVector(_mm256_add_pd(a.value, b.value));
+        }
+
+        HEMELB_SIMD_TARGET inline SiteVector operator-(const SiteVector& a, const SiteVector& b)
+        {
+          return SiteVector(_mm256_sub_pd(a.value, b.value));
+        }
+
+        HEMELB_SIMD_TARGET inline SiteVector operator*(const SiteVector& a, const SiteVector& b)
+        {
+          return SiteVector(_mm256_mul_pd(a.value, b.value));
+        }
+
+        HEMELB_SIMD_TARGET inline SiteVector operator/(const SiteVector& a, const SiteVector& b)
+        {
+          return SiteVector(_mm256_div_pd(a.value, b.value));
+        }
+#else
+        /**
+         * The value of one quantity at four sites, for builds without vector intrinsics. The
+         * loops are simple enough for the compiler to vectorise them itself.
+         */
+        struct SiteVector
+        {
+            static const unsigned WIDTH = 4;
+
+            SiteVector()
+            {
+            }
+
+            explicit SiteVector(distribn_t scalar)
+            {
+              for (unsigned lane = 0; lane < WIDTH; ++lane)
+              {
+                value[lane] = scalar;
+              }
+            }
+
+            static SiteVector Load(const distribn_t* source)
+            {
+              SiteVector result;
+              for (unsigned lane = 0; lane < WIDTH; ++lane)
+              {
+                result.value[lane] = source[lane];
+              }
+              return result;
+            }
+
+            void Store(distribn_t* destination) const
+            {
+              for (unsigned lane = 0; lane < WIDTH; ++lane)
+              {
+                destination[lane] = value[lane];
+              }
+            }
+
+            distribn_t value[WIDTH];
+        };
+
+#define HEMELB_SITEVECTOR_OPERATOR(op) \
+        inline SiteVector operator op(const SiteVector& a, const SiteVector& b) \
+        { \
+          SiteVector result; \
+          for (unsigned lane = 0; lane < SiteVector::WIDTH; ++lane) \
+          { \
+            result.value[lane] = a.value[lane] op b.value[lane]; \
+          } \
+          return result; \
+        }
+
+        HEMELB_SITEVECTOR_OPERATOR(+)
+        HEMELB_SITEVECTOR_OPERATOR(-)
+        HEMELB_SITEVECTOR_OPERATOR(*)
+        HEMELB_SITEVECTOR_OPERATOR(/)
+
+#undef HEMELB_SITEVECTOR_OPERATOR
+#endif
+
+        /**
+         * True if the CPU we're running on can execute the instructions this build was
+         * compiled to use for SiteVector.
+         * @return
+         */
+        inline bool IsSupportedByCpu()
+        {
+#if defined(HEMELB_USE_AVX512)
+          return __builtin_cpu_supports("avx512f");
+#elif defined(HEMELB_USE_AVX2)
+          return __builtin_cpu_supports("avx2");
+#else
+          return true;
+#endif
+        }
+      }
+
+      /**
+       * The hydrodynamic variables of MultiSiteLBGK<LatticeType>::SITES sites, stored by
+       * direction then by site, so that f[direction * SITES + site] is the distribution of the
+       * given site in the given direction. This lets the values of one direction at every site
+       * be loaded into a single vector register.
+       */
+      template<class LatticeType>
+      struct MultiSiteHydroVars
+      {
+          static const unsigned SITES = simd::SiteVector::WIDTH;
+
+          distribn_t f[LatticeType::NUMVECTORS * SITES] __attribute__((aligned(64)));
+
+          distribn_t density[SITES] __attribute__((aligned(64)));
+          distribn_t momentumX[SITES] __attribute__((aligned(64)));
+          distribn_t momentumY[SITES] __attribute__((aligned(64)));
+          distribn_t momentumZ[SITES] __attribute__((aligned(64)));
+          distribn_t velocityX[SITES] __attribute__((aligned(64)));
+          distribn_t velocityY[SITES] __attribute__((aligned(64)));
+          distribn_t velocityZ[SITES] __attribute__((aligned(64)));
+
+          distribn_t fEq[LatticeType::NUMVECTORS * SITES] __attribute__((aligned(64)));
+          distribn_t fNeq[LatticeType::NUMVECTORS * SITES] __attribute__((aligned(64)));
+          distribn_t fPostCollision[LatticeType::NUMVECTORS * SITES] __attribute__((aligned(64)));
+      };
+
+      /**
+       * MultiSiteLBGK: the LBGK single-relaxation time kernel, applied to several sites at
+       * once. Each vector register holds one quantity for all of the sites, so the whole of
+       * the calculation of density, momentum, equilibrium and relaxation is done in vector
+       * arithmetic, whatever the lattice.
+       *
+       * The arithmetic is done in the same order as in LBGK and Lattice, so the results agree
+       * with the single-site kernel to within rounding.
+       */
+      template<class LatticeType>
+      class MultiSiteLBGK
+      {
+        public:
+          static const unsigned SITES = simd::SiteVector::WIDTH;
+
+          /**
+           * Calculate the density, momentum, velocity, equilibrium and non-equilibrium
+           * distributions and the post-collision distributions of every site in hydroVars,
+           * from its distributions f.
+           * @param omega The LBGK relaxation parameter, as given by LbmParameters::GetOmega.
+           * @param hydroVars
+           */
+          HEMELB_SIMD_TARGET static void CalculateDensityMomentumFeqAndCollide(const distribn_t omega,
+                                                            MultiSiteHydroVars<LatticeType>& hydroVars)
+          {
+            using simd::SiteVector;
+
+            SiteVector density(0.0), momentumX(0.0), momentumY(0.0), momentumZ(0.0);
+
+            for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+            {
+              const SiteVector f = SiteVector::Load(&hydroVars.f[direction * SITES]);
+              density = density + f;
+              momentumX = momentumX + SiteVector(LatticeType::CX[direction]) * f;
+              momentumY = momentumY + SiteVector(LatticeType::CY[direction]) * f;
+              momentumZ = momentumZ + SiteVector(LatticeType::CZ[direction]) * f;
+            }
+
+            density.Store(hydroVars.density);
+            momentumX.Store(hydroVars.momentumX);
+            momentumY.Store(hydroVars.momentumY);
+            momentumZ.Store(hydroVars.momentumZ);
+            (momentumX / density).Store(hydroVars.velocityX);
+            (momentumY / density).Store(hydroVars.velocityY);
+            (momentumZ / density).Store(hydroVars.velocityZ);
+
+            const SiteVector density_1 = SiteVector(1.) / density;
+            const SiteVector momentumMagnitudeSquared = momentumX * momentumX + momentumY * momentumY
+                + momentumZ * momentumZ;
+            const SiteVector densityLessMomentumTerm = density
+                - SiteVector(3. / 2.) * momentumMagnitudeSquared * density_1;
+            const SiteVector nineHalvesOfDensity_1 = SiteVector(9. / 2.) * density_1;
+            const SiteVector omegaVector(omega);
+
+            for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+            {
+              const SiteVector mom_dot_ei = SiteVector(LatticeType::CX[direction]) * momentumX
+                  + SiteVector(LatticeType::CY[direction]) * momentumY
+                  + SiteVector(LatticeType::CZ[direction]) * momentumZ;
+
+              const SiteVector fEq = SiteVector(LatticeType::EQMWEIGHTS[direction])
+                  * (densityLessMomentumTerm + nineHalvesOfDensity_1 * mom_dot_ei * mom_dot_ei
+                      + SiteVector(3.) * mom_dot_ei);
+
+              const SiteVector f = SiteVector::Load(&hydroVars.f[direction * SITES]);
+              const SiteVector fNeq = f - fEq;
+
+              fEq.Store(&hydroVars.fEq[direction * SITES]);
+              fNeq.Store(&hydroVars.fNeq[direction * SITES]);
+              (f + fNeq * omegaVector).Store(&hydroVars.fPostCollision[direction * SITES]);
+            }
+          }
+      };
+    }
+  }
+}
+
+#endif /* HEMELB_LB_KERNELS_MULTISITELBGK_H */
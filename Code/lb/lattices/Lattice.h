@@ -647,7 +647,7 @@ namespace hemelb
                 inverseVectorIndices[direction] = DmQn::INVERSEDIRECTIONS[direction];
               }
 
-              singletonInfo = new LatticeInfo(DmQn::NUMVECTORS, vectors, inverseVectorIndices);
+              singletonInfo = new LatticeInfo(DmQn::NUMVECTORS, vectors, inverseVectorIndices, DmQn::EQMWEIGHTS);
             }
 
             return *singletonInfo;
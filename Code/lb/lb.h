@@ -17,6 +17,7 @@
 #include "configuration/SimConfig.h"
 #include "reporting/Timers.h"
 #include "lb/BuildSystemInterface.h"
+#include "util/ThreadPool.h"
 #include <typeinfo>
 
 namespace hemelb
@@ -54,13 +55,17 @@ namespace hemelb
          * Object so initialized is not ready for simulation.
          * Must have Initialise(...) called also. Constructor separated due to need to access
          * the partially initialized LBM in order to initialize the arguments to the second construction phase.
+         *
+         * threadCount is the number of threads (including the calling thread) that share the
+         * stream-and-collide work of this rank; 0 means one per hardware thread.
          */
         LBM(hemelb::configuration::SimConfig *iSimulationConfig,
             net::Net* net,
             geometry::LatticeData* latDat,
             SimulationState* simState,
             reporting::Timers &atimings,
-            geometry::neighbouring::NeighbouringDataManager *neighbouringDataManager);
+            geometry::neighbouring::NeighbouringDataManager *neighbouringDataManager,
+            unsigned threadCount);
         ~LBM();
 
         void RequestComms(); ///< part of IteratedAction interface.
@@ -89,6 +94,25 @@ namespace hemelb
                         iolets::BoundaryValues* iOutletValues,
                         const util::UnitConverter* iUnits);
 
+        /**
+         * Set up again for the lattice after it has been rebuilt for a new decomposition, with
+         * the boundary values and neighbouring data manager made for it. The distributions are
+         * left as the lattice has them, but the collisions are made afresh, so this mustn't be
+         * used if CanRebuild is false.
+         */
+        void Rebuild(iolets::BoundaryValues* iInletValues,
+                     iolets::BoundaryValues* iOutletValues,
+                     geometry::neighbouring::NeighbouringDataManager* iNeighbouringDataManager);
+
+        /**
+         * Whether Rebuild can carry on the simulation exactly: false if the kernel keeps data
+         * for each site that making the collisions afresh would lose.
+         */
+        static bool CanRebuild()
+        {
+          return !kernels::KeepsSiteState<LB_KERNEL>::value;
+        }
+
         void ReadVisParameters();
 
         void CalculateMouseFlowField(const ScreenDensity densityIn,
@@ -102,13 +126,30 @@ namespace hemelb
         hemelb::lb::LbmParameters *GetLbmParams();
         lb::MacroscopicPropertyCache& GetPropertyCache();
 
+        /**
+         * Time the stream-and-collide and post-step of the sites of each collision type on their
+         * own, on this thread, as when calibrating the decomposition weights. The sites are
+         * updated as on a time step, but without any communication.
+         * @param rounds The number of updates to time, after one to warm up
+         * @param secondsPerSite Set to the time per site of the median update of the sites of
+         * each collision type, or 0 for types with no sites
+         */
+        void TimeCollisionTypes(unsigned rounds, std::vector<double>& secondsPerSite);
+
       private:
         void SetInitialConditions();
 
         void InitCollisions();
+        void DeleteCollisions();
         // The following function pair simplify initialising the site ranges for each collider object.
         void InitInitParamsSiteRanges(kernels::InitParams& initParams, unsigned& state);
         void AdvanceInitParamsSiteRanges(kernels::InitParams& initParams, unsigned& state);
+        /**
+         * Stream and collide, and do the post-step for, the layers of the deep halo that are up to
+         * date on this step.
+         */
+        void StreamAndCollideHalo();
+        void PostStepHalo();
         /**
          * Ensure that the BoundaryValues objects have all necessary fields populated.
          */
@@ -126,6 +167,13 @@ namespace hemelb
         tInletWallCollision* mInletWallCollision;
         tOutletWallCollision* mOutletWallCollision;
 
+        /**
+         * Stream and collide, and do the post-step for, all the sites of one collision type.
+         * @return The time taken, in seconds
+         */
+        template<typename Collision>
+        double TimeCollisionType(Collision* collision, unsigned collisionType);
+
         template<typename Collision>
         void StreamAndCollide(Collision* collision, const site_t iFirstIndex, const site_t iSiteCount)
         {
@@ -139,6 +187,65 @@ namespace hemelb
           }
         }
 
+        /**
+         * As StreamAndCollide, but split the range across the worker threads. Only to be used
+         * for collisions whose streamers touch nothing but per-site state (i.e. not the iolet
+         * collisions, some of which cache data per iolet).
+         */
+        template<typename Collision>
+        void ThreadedStreamAndCollide(Collision* collision, const site_t iFirstIndex, const site_t iSiteCount)
+        {
+          if (mVisControl->IsRendering())
+          {
+            threadPool.ParallelFor(iFirstIndex, iSiteCount, [this, collision] (site_t first, site_t count)
+            {
+              collision->template StreamAndCollide<true> (first, count, &mParams, mLatDat, propertyCache);
+            });
+          }
+          else
+          {
+            threadPool.ParallelFor(iFirstIndex, iSiteCount, [this, collision] (site_t first, site_t count)
+            {
+              collision->template StreamAndCollide<false> (first, count, &mParams, mLatDat, propertyCache);
+            });
+          }
+        }
+
+        /**
+         * As ThreadedStreamAndCollide (or StreamAndCollide, if not threaded), but in chunks of
+         * PROGRESS_CHUNK_SIZE sites, polling the communication in flight between chunks until it
+         * completes. Many MPI libraries only progress non-blocking sends and receives from inside
+         * MPI calls, so without this they would mostly happen in the Wait step.
+         */
+        template<typename Collision>
+        void StreamAndCollideWithProgress(Collision* collision, const site_t iFirstIndex, const site_t iSiteCount,
+                                          const bool threaded)
+        {
+          const site_t end = iFirstIndex + iSiteCount;
+          for (site_t first = iFirstIndex; first < end;)
+          {
+            const site_t count = (communicationComplete || PROGRESS_CHUNK_SIZE == 0
+              || end - first < PROGRESS_CHUNK_SIZE) ?
+              end - first :
+              PROGRESS_CHUNK_SIZE;
+            if (threaded)
+            {
+              ThreadedStreamAndCollide(collision, first, count);
+            }
+            else
+            {
+              StreamAndCollide(collision, first, count);
+            }
+            first += count;
+            PollCommunication();
+          }
+        }
+
+        /**
+         * Poll the communication in flight, if we are doing so and it hasn't yet completed.
+         */
+        void PollCommunication();
+
         template<typename Collision>
         void PostStep(Collision* collision, const site_t iFirstIndex, const site_t iSiteCount)
         {
@@ -171,6 +278,16 @@ namespace hemelb
         MacroscopicPropertyCache propertyCache;
 
         geometry::neighbouring::NeighbouringDataManager *neighbouringDataManager;
+
+        util::ThreadPool threadPool;
+
+        /**
+         * The number of mid-domain sites to stream and collide between polls of the communication
+         * in flight, or 0 not to poll.
+         */
+        static const site_t PROGRESS_CHUNK_SIZE = HEMELB_PROGRESS_CHUNK_SIZE;
+        //! Whether the point-to-point communication of this step is known to have completed.
+        bool communicationComplete;
     };
 
   } // Namespace lb
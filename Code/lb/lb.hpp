@@ -7,8 +7,10 @@
 #ifndef HEMELB_LB_LB_HPP
 #define HEMELB_LB_LB_HPP
 
+#include <algorithm>
 #include "io/writers/xdr/XdrMemWriter.h"
 #include "lb/lb.h"
+#include "util/utilityFunctions.h"
 
 namespace hemelb
 {
@@ -33,10 +35,12 @@ namespace hemelb
                           geometry::LatticeData* latDat,
                           SimulationState* simState,
                           reporting::Timers &atimings,
-                          geometry::neighbouring::NeighbouringDataManager *neighbouringDataManager) :
+                          geometry::neighbouring::NeighbouringDataManager *neighbouringDataManager,
+                          unsigned threadCount) :
       mSimConfig(iSimulationConfig), mNet(net), mLatDat(latDat), mState(simState), 
           mParams(iSimulationConfig->GetTimeStepLength(), iSimulationConfig->GetVoxelSize()), timings(atimings),
-          propertyCache(*simState, *latDat), neighbouringDataManager(neighbouringDataManager)
+          propertyCache(*simState, *latDat), neighbouringDataManager(neighbouringDataManager),
+          threadPool(threadCount), communicationComplete(true)
     {
       ReadParameters();
     }
@@ -60,15 +64,32 @@ namespace hemelb
     template<class LatticeType>
     void LBM<LatticeType>::InitInitParamsSiteRanges(kernels::InitParams& initParams, unsigned& state)
     {
-      initParams.siteRanges.resize(2);
+      // One range each for the midDomain and domainEdge sites, then one for each layer of the
+      // halo.
+      initParams.siteRanges.resize(2 + geometry::halo::DEPTH);
 
       initParams.siteRanges[0].first = 0;
       initParams.siteRanges[1].first = mLatDat->GetMidDomainSiteCount();
+      site_t haloLayerOffset = mLatDat->GetLocalFluidSiteCount();
+      for (unsigned layer = 1; layer <= geometry::halo::DEPTH; ++layer)
+      {
+        initParams.siteRanges[1 + layer].first = haloLayerOffset;
+        for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; ++collisionType)
+        {
+          haloLayerOffset += mLatDat->GetHaloCollisionCount(layer, collisionType);
+        }
+      }
       state = 0;
       initParams.siteRanges[0].second = initParams.siteRanges[0].first + mLatDat->GetMidDomainCollisionCount(state);
       initParams.siteRanges[1].second = initParams.siteRanges[1].first + mLatDat->GetDomainEdgeCollisionCount(state);
 
       initParams.siteCount = mLatDat->GetMidDomainCollisionCount(state) + mLatDat->GetDomainEdgeCollisionCount(state);
+      for (unsigned layer = 1; layer <= geometry::halo::DEPTH; ++layer)
+      {
+        initParams.siteRanges[1 + layer].second = initParams.siteRanges[1 + layer].first
+            + mLatDat->GetHaloCollisionCount(layer, state);
+        initParams.siteCount += mLatDat->GetHaloCollisionCount(layer, state);
+      }
     }
 
     template<class LatticeType>
@@ -76,11 +97,21 @@ namespace hemelb
     {
       initParams.siteRanges[0].first += mLatDat->GetMidDomainCollisionCount(state);
       initParams.siteRanges[1].first += mLatDat->GetDomainEdgeCollisionCount(state);
+      for (unsigned layer = 1; layer <= geometry::halo::DEPTH; ++layer)
+      {
+        initParams.siteRanges[1 + layer].first += mLatDat->GetHaloCollisionCount(layer, state);
+      }
       ++state;
       initParams.siteRanges[0].second = initParams.siteRanges[0].first + mLatDat->GetMidDomainCollisionCount(state);
       initParams.siteRanges[1].second = initParams.siteRanges[1].first + mLatDat->GetDomainEdgeCollisionCount(state);
 
       initParams.siteCount = mLatDat->GetMidDomainCollisionCount(state) + mLatDat->GetDomainEdgeCollisionCount(state);
+      for (unsigned layer = 1; layer <= geometry::halo::DEPTH; ++layer)
+      {
+        initParams.siteRanges[1 + layer].second = initParams.siteRanges[1 + layer].first
+            + mLatDat->GetHaloCollisionCount(layer, state);
+        initParams.siteCount += mLatDat->GetHaloCollisionCount(layer, state);
+      }
     }
 
     template<class LatticeType>
@@ -142,6 +173,21 @@ namespace hemelb
       mVisControl = iControl;
     }
 
+    template<class LatticeType>
+    void LBM<LatticeType>::Rebuild(iolets::BoundaryValues* iInletValues,
+                                   iolets::BoundaryValues* iOutletValues,
+                                   geometry::neighbouring::NeighbouringDataManager* iNeighbouringDataManager)
+    {
+      mInletValues = iInletValues;
+      mOutletValues = iOutletValues;
+      neighbouringDataManager = iNeighbouringDataManager;
+
+      // The collisions hold the site ranges, and any per-site data, of the old lattice.
+      DeleteCollisions();
+      propertyCache.Resize(*mLatDat);
+      InitCollisions();
+    }
+
     template<class LatticeType>
     void LBM<LatticeType>::PrepareBoundaryObjects()
     {
@@ -175,18 +221,20 @@ namespace hemelb
     {
       distribn_t density = mUnits->ConvertPressureToLatticeUnits(mSimConfig->GetInitialPressure()) / Cs2;
 
-      for (site_t i = 0; i < mLatDat->GetLocalFluidSiteCount(); i++)
+      // The initial distributions are laid out as at the start of an even step.
+      mLatDat->oddStep = false;
+
+      for (site_t i = 0; i < mLatDat->GetLocalFluidSiteCount() + mLatDat->GetHaloSiteCount(); i++)
       {
         distribn_t f_eq[LatticeType::NUMVECTORS];
 
         LatticeType::CalculateFeq(density, 0.0, 0.0, 0.0, f_eq);
 
-        distribn_t* f_old_p = mLatDat->GetFOld(i * LatticeType::NUMVECTORS);
-        distribn_t* f_new_p = mLatDat->GetFNew(i * LatticeType::NUMVECTORS);
-
         for (unsigned int l = 0; l < LatticeType::NUMVECTORS; l++)
         {
-          f_new_p[l] = f_old_p[l] = f_eq[l];
+          const site_t index = mLatDat->GetDistributionIndex<LatticeType>(i, l);
+          mLatDat->SetFNewValue<LatticeType>(index, l, f_eq[l]);
+          *mLatDat->GetFOld(index) = *mLatDat->GetFNew(index);
         }
       }
     }
@@ -219,10 +267,10 @@ namespace hemelb
        */
       site_t offset = mLatDat->GetMidDomainSiteCount();
 
-      StreamAndCollide(mMidFluidCollision, offset, mLatDat->GetDomainEdgeCollisionCount(0));
+      ThreadedStreamAndCollide(mMidFluidCollision, offset, mLatDat->GetDomainEdgeCollisionCount(0));
       offset += mLatDat->GetDomainEdgeCollisionCount(0);
 
-      StreamAndCollide(mWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(1));
+      ThreadedStreamAndCollide(mWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(1));
       offset += mLatDat->GetDomainEdgeCollisionCount(1);
 
       mInletValues->FinishReceive();
@@ -238,6 +286,10 @@ namespace hemelb
 
       StreamAndCollide(mOutletWallCollision, offset, mLatDat->GetDomainEdgeCollisionCount(5));
 
+      // Neighbours sharing the distribution arrays read what was just streamed to them once
+      // the sends tell them it's there.
+      mLatDat->PublishStreamedDistributions();
+
       timings[hemelb::reporting::Timers::lb_calc].Stop();
       timings[hemelb::reporting::Timers::lb].Stop();
     }
@@ -255,30 +307,61 @@ namespace hemelb
        *
        * In site id terms, this means starting at the first site and progressing through the
        * midDomain sites, one type at a time.
+       *
+       * The fluid and wall ranges, which make up the bulk of the work, are shared between the
+       * worker threads. Only this thread talks to MPI, so the sends and receives posted in the
+       * Send step stay in flight while the workers are busy, and this thread polls them between
+       * chunks of sites. The lbOverlap timer records how long the LB went on before they had
+       * all completed.
        */
+      communicationComplete = (PROGRESS_CHUNK_SIZE == 0);
+      if (!communicationComplete)
+      {
+        timings[hemelb::reporting::Timers::lbOverlap].Start();
+      }
+
       site_t offset = 0;
 
-      StreamAndCollide(mMidFluidCollision, offset, mLatDat->GetMidDomainCollisionCount(0));
+      StreamAndCollideWithProgress(mMidFluidCollision, offset, mLatDat->GetMidDomainCollisionCount(0), true);
       offset += mLatDat->GetMidDomainCollisionCount(0);
 
-      StreamAndCollide(mWallCollision, offset, mLatDat->GetMidDomainCollisionCount(1));
+      StreamAndCollideWithProgress(mWallCollision, offset, mLatDat->GetMidDomainCollisionCount(1), true);
       offset += mLatDat->GetMidDomainCollisionCount(1);
 
-      StreamAndCollide(mInletCollision, offset, mLatDat->GetMidDomainCollisionCount(2));
+      StreamAndCollideWithProgress(mInletCollision, offset, mLatDat->GetMidDomainCollisionCount(2), false);
       offset += mLatDat->GetMidDomainCollisionCount(2);
 
-      StreamAndCollide(mOutletCollision, offset, mLatDat->GetMidDomainCollisionCount(3));
+      StreamAndCollideWithProgress(mOutletCollision, offset, mLatDat->GetMidDomainCollisionCount(3), false);
       offset += mLatDat->GetMidDomainCollisionCount(3);
 
-      StreamAndCollide(mInletWallCollision, offset, mLatDat->GetMidDomainCollisionCount(4));
+      StreamAndCollideWithProgress(mInletWallCollision, offset, mLatDat->GetMidDomainCollisionCount(4), false);
       offset += mLatDat->GetMidDomainCollisionCount(4);
 
-      StreamAndCollide(mOutletWallCollision, offset, mLatDat->GetMidDomainCollisionCount(5));
+      StreamAndCollideWithProgress(mOutletWallCollision, offset, mLatDat->GetMidDomainCollisionCount(5), false);
+
+      if (!communicationComplete)
+      {
+        timings[hemelb::reporting::Timers::lbOverlap].Stop();
+      }
 
       timings[hemelb::reporting::Timers::lb_calc].Stop();
       timings[hemelb::reporting::Timers::lb].Stop();
     }
 
+    template<class LatticeType>
+    void LBM<LatticeType>::PollCommunication()
+    {
+      if (communicationComplete)
+      {
+        return;
+      }
+      if (mNet->Progress())
+      {
+        communicationComplete = true;
+        timings[hemelb::reporting::Timers::lbOverlap].Stop();
+      }
+    }
+
     template<class LatticeType>
     void LBM<LatticeType>::PostReceive()
     {
@@ -294,6 +377,10 @@ namespace hemelb
 
       timings[hemelb::reporting::Timers::lb_calc].Start();
 
+      // The halo can only be updated once any distributions received for it have been copied
+      // in, and must be before the post-step, as it streams to the sites on its edge.
+      StreamAndCollideHalo();
+
       //TODO yup, this is horrible. If you read this, please improve the following code.
       PostStep(mMidFluidCollision, offset, mLatDat->GetDomainEdgeCollisionCount(0));
       offset += mLatDat->GetDomainEdgeCollisionCount(0);
@@ -331,10 +418,139 @@ namespace hemelb
 
       PostStep(mOutletWallCollision, offset, mLatDat->GetMidDomainCollisionCount(5));
 
+      PostStepHalo();
+
       timings[hemelb::reporting::Timers::lb_calc].Stop();
       timings[hemelb::reporting::Timers::lb].Stop();
     }
 
+    template<class LatticeType>
+    void LBM<LatticeType>::StreamAndCollideHalo()
+    {
+      /**
+       * With a deep halo, this rank also does LB on copies of the sites of other ranks near its
+       * own, so that it only needs to receive their distributions every few steps. Only the
+       * layers that are still up to date need doing: anything streamed from beyond them is
+       * stale.
+       */
+      site_t offset = mLatDat->GetLocalFluidSiteCount();
+      for (unsigned layer = 1; layer <= mLatDat->GetUpToDateHaloDepth(); ++layer)
+      {
+        ThreadedStreamAndCollide(mMidFluidCollision, offset, mLatDat->GetHaloCollisionCount(layer, 0));
+        offset += mLatDat->GetHaloCollisionCount(layer, 0);
+
+        ThreadedStreamAndCollide(mWallCollision, offset, mLatDat->GetHaloCollisionCount(layer, 1));
+        offset += mLatDat->GetHaloCollisionCount(layer, 1);
+
+        StreamAndCollide(mInletCollision, offset, mLatDat->GetHaloCollisionCount(layer, 2));
+        offset += mLatDat->GetHaloCollisionCount(layer, 2);
+
+        StreamAndCollide(mOutletCollision, offset, mLatDat->GetHaloCollisionCount(layer, 3));
+        offset += mLatDat->GetHaloCollisionCount(layer, 3);
+
+        StreamAndCollide(mInletWallCollision, offset, mLatDat->GetHaloCollisionCount(layer, 4));
+        offset += mLatDat->GetHaloCollisionCount(layer, 4);
+
+        StreamAndCollide(mOutletWallCollision, offset, mLatDat->GetHaloCollisionCount(layer, 5));
+        offset += mLatDat->GetHaloCollisionCount(layer, 5);
+      }
+    }
+
+    template<class LatticeType>
+    void LBM<LatticeType>::PostStepHalo()
+    {
+      site_t offset = mLatDat->GetLocalFluidSiteCount();
+      for (unsigned layer = 1; layer <= mLatDat->GetUpToDateHaloDepth(); ++layer)
+      {
+        PostStep(mMidFluidCollision, offset, mLatDat->GetHaloCollisionCount(layer, 0));
+        offset += mLatDat->GetHaloCollisionCount(layer, 0);
+
+        PostStep(mWallCollision, offset, mLatDat->GetHaloCollisionCount(layer, 1));
+        offset += mLatDat->GetHaloCollisionCount(layer, 1);
+
+        PostStep(mInletCollision, offset, mLatDat->GetHaloCollisionCount(layer, 2));
+        offset += mLatDat->GetHaloCollisionCount(layer, 2);
+
+        PostStep(mOutletCollision, offset, mLatDat->GetHaloCollisionCount(layer, 3));
+        offset += mLatDat->GetHaloCollisionCount(layer, 3);
+
+        PostStep(mInletWallCollision, offset, mLatDat->GetHaloCollisionCount(layer, 4));
+        offset += mLatDat->GetHaloCollisionCount(layer, 4);
+
+        PostStep(mOutletWallCollision, offset, mLatDat->GetHaloCollisionCount(layer, 5));
+        offset += mLatDat->GetHaloCollisionCount(layer, 5);
+      }
+    }
+
+    template<class LatticeType>
+    void LBM<LatticeType>::TimeCollisionTypes(unsigned rounds, std::vector<double>& secondsPerSite)
+    {
+      std::vector<std::vector<double> > roundSeconds(COLLISION_TYPES);
+      for (unsigned round = 0; round <= rounds; ++round)
+      {
+        // Take each type in turn on every round, so that none is favoured by whatever else
+        // the machine is doing at the time.
+        const double seconds[COLLISION_TYPES] = { TimeCollisionType(mMidFluidCollision, 0),
+                                                  TimeCollisionType(mWallCollision, 1),
+                                                  TimeCollisionType(mInletCollision, 2),
+                                                  TimeCollisionType(mOutletCollision, 3),
+                                                  TimeCollisionType(mInletWallCollision, 4),
+                                                  TimeCollisionType(mOutletWallCollision, 5) };
+        mLatDat->SwapOldAndNew();
+
+        // The first round only warms the caches up.
+        if (round > 0)
+        {
+          for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; ++collisionType)
+          {
+            roundSeconds[collisionType].push_back(seconds[collisionType]);
+          }
+        }
+      }
+
+      secondsPerSite.assign(COLLISION_TYPES, 0);
+      for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; ++collisionType)
+      {
+        const site_t siteCount = mLatDat->GetMidDomainCollisionCount(collisionType)
+            + mLatDat->GetDomainEdgeCollisionCount(collisionType);
+        std::vector<double>& seconds = roundSeconds[collisionType];
+        if (siteCount > 0 && !seconds.empty())
+        {
+          // The median, which a few rounds disturbed by anything else running don't move.
+          std::nth_element(seconds.begin(), seconds.begin() + seconds.size() / 2, seconds.end());
+          secondsPerSite[collisionType] = seconds[seconds.size() / 2] / siteCount;
+        }
+      }
+    }
+
+    template<class LatticeType>
+    template<typename Collision>
+    double LBM<LatticeType>::TimeCollisionType(Collision* collision, unsigned collisionType)
+    {
+      site_t midDomainOffset = 0;
+      site_t domainEdgeOffset = mLatDat->GetMidDomainSiteCount();
+      for (unsigned earlierType = 0; earlierType < collisionType; ++earlierType)
+      {
+        midDomainOffset += mLatDat->GetMidDomainCollisionCount(earlierType);
+        domainEdgeOffset += mLatDat->GetDomainEdgeCollisionCount(earlierType);
+      }
+      const site_t midDomainCount = mLatDat->GetMidDomainCollisionCount(collisionType);
+      const site_t domainEdgeCount = mLatDat->GetDomainEdgeCollisionCount(collisionType);
+
+      // Not through StreamAndCollide and PostStep, as there may be no visualisation to ask
+      // whether it is rendering.
+      const double start = util::myClock();
+      collision->template StreamAndCollide<false> (midDomainOffset, midDomainCount, &mParams, mLatDat, propertyCache);
+      collision->template StreamAndCollide<false> (domainEdgeOffset,
+                                                   domainEdgeCount,
+                                                   &mParams,
+                                                   mLatDat,
+                                                   propertyCache);
+      collision->template DoPostStep<false> (midDomainOffset, midDomainCount, &mParams, mLatDat, propertyCache);
+      collision->template DoPostStep<false> (domainEdgeOffset, domainEdgeCount, &mParams, mLatDat, propertyCache);
+      return util::myClock() - start;
+    }
+
     template<class LatticeType>
     void LBM<LatticeType>::EndIteration()
     {
@@ -350,6 +566,12 @@ namespace hemelb
 
     template<class LatticeType>
     LBM<LatticeType>::~LBM()
+    {
+      DeleteCollisions();
+    }
+
+    template<class LatticeType>
+    void LBM<LatticeType>::DeleteCollisions()
     {
       // Delete the collision and stream objects we've been using
       delete mMidFluidCollision;
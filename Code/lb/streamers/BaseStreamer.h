@@ -91,6 +91,20 @@ namespace hemelb
                                                 const LbmParameters* lbmParams,
                                                 lb::MacroscopicPropertyCache& propertyCache)
           {
+            // Sites in the deep halo are accounted for by the ranks that own them.
+            if (site.GetIndex() >= propertyCache.GetSiteCount())
+            {
+              return;
+            }
+
+            if (propertyCache.stabilityAccumulator.IsActive())
+            {
+              propertyCache.stabilityAccumulator.Accumulate<LatticeType>(site.GetIndex(),
+                                                                         hydroVars.f,
+                                                                         hydroVars.density,
+                                                                         hydroVars.momentum);
+            }
+
             if (propertyCache.densityCache.RequiresRefresh())
             {
               propertyCache.densityCache.Put(site.GetIndex(), hydroVars.density);
@@ -88,7 +88,9 @@ namespace hemelb
 
               geometry::Site<geometry::LatticeData> site = latticeData->GetSite(siteIndex);
 
-              kernels::HydroVars<typename CollisionType::CKernel> hydroVars(site.GetFOld<LatticeType>());
+              distribn_t fOldBuffer[LatticeType::NUMVECTORS];
+              const distribn_t* siteFOld = site.LoadFOld<LatticeType>(fOldBuffer);
+              kernels::HydroVars<typename CollisionType::CKernel> hydroVars(siteFOld);
 
               ///< @todo #126 This value of tau will be updated by some kernels within the collider code (e.g. LBGKNN). It would be nicer if tau is handled in a single place.
               hydroVars.tau = lbmParams->GetTau();
@@ -130,7 +132,7 @@ namespace hemelb
                     hydroVars.GetFPostCollision()[*incomingVelocityIter];
                 fPostCollisionInverseDir[siteIndex](index) =
                     hydroVars.GetFPostCollision()[inverseDirection];
-                fOld[siteIndex](index) = site.GetFOld<LatticeType>()[*incomingVelocityIter];
+                fOld[siteIndex](index) = siteFOld[*incomingVelocityIter];
               }
 
               for (std::set<Direction>::const_iterator outgoingVelocityIter =
@@ -140,7 +142,7 @@ namespace hemelb
               {
                 fPostCollision[siteIndex](index) =
                     hydroVars.GetFPostCollision()[*outgoingVelocityIter];
-                fOld[siteIndex](index) = site.GetFOld<LatticeType>()[*outgoingVelocityIter];
+                fOld[siteIndex](index) = siteFOld[*outgoingVelocityIter];
               }
 
               BaseStreamer<JunkYangFactory>::template UpdateMinsAndMaxes<tDoRayTracing>(site,
@@ -181,8 +183,10 @@ namespace hemelb
                   incomingVelocityIter != incomingVelocities[siteIndex].end();
                   ++incomingVelocityIter, ++index)
               {
-                * (latticeData->GetFNew(siteIndex * LatticeType::NUMVECTORS + *incomingVelocityIter)) =
-                    systemSolution[index];
+                latticeData->SetFNewValue<LatticeType>(latticeData->GetDistributionIndex<LatticeType>(siteIndex,
+                                                                                                    *incomingVelocityIter),
+                                                       *incomingVelocityIter,
+                                                       systemSolution[index]);
               }
 
               geometry::Site<geometry::LatticeData> site = latticeData->GetSite(siteIndex);
@@ -465,8 +469,10 @@ namespace hemelb
                 outgoingDirIter != outgoingVelocities[contiguousSiteIndex].end();
                 ++outgoingDirIter, ++index)
             {
-              fNew[index] = *latticeData.GetFNew(contiguousSiteIndex * LatticeType::NUMVECTORS
-                  + *outgoingDirIter);
+              fNew[index] =
+                  latticeData.GetFNewValue<LatticeType>(latticeData.GetDistributionIndex<LatticeType>(contiguousSiteIndex,
+                                                                                                      *outgoingDirIter),
+                                                        *outgoingDirIter);
             }
 
             rVector = THETA
@@ -67,9 +67,9 @@ namespace hemelb
                 * (wallMom.x * LatticeType::CX[ii] + wallMom.y * LatticeType::CY[ii]
                     + wallMom.z * LatticeType::CZ[ii]) / Cs2;
 
-            * (latticeData->GetFNew(SimpleBounceBackDelegate<CollisionImpl>::GetBBIndex(site.GetIndex(),
-                                                                                        ii))) =
-                hydroVars.GetFPostCollision()[ii] - correction;
+            latticeData->SetFNewValue<LatticeType>(SimpleBounceBackDelegate<CollisionImpl>::GetBBIndex(site, ii),
+                                                   ii,
+                                                   hydroVars.GetFPostCollision()[ii] - correction);
           }
         private:
           iolets::BoundaryValues* bValues;
@@ -49,7 +49,7 @@ namespace hemelb
             // TODO having to give 0 as an argument is also ugly.
             // TODO it's ugly that we have to give hydroVars a nonsense distribution vector
             // that doesn't get used.
-            kernels::HydroVars<typename CollisionType::CKernel> ghostHydrovars(site.GetFOld<LatticeType> ());
+            kernels::HydroVars<typename CollisionType::CKernel> ghostHydrovars(hydroVars.f);
 
             ghostHydrovars.density = ghostDensity;
             ghostHydrovars.momentum = ioletNormal * component * ghostDensity;
@@ -58,8 +58,9 @@ namespace hemelb
 
             Direction unstreamed = LatticeType::INVERSEDIRECTIONS[direction];
 
-            *latticeData->GetFNew(site.GetIndex() * LatticeType::NUMVECTORS + unstreamed)
-                = ghostHydrovars.GetFEq()[unstreamed];
+            latticeData->SetFNewValue<LatticeType>(site.GetDistributionIndex<LatticeType>(unstreamed),
+                                                   unstreamed,
+                                                   ghostHydrovars.GetFEq()[unstreamed]);
           }
         protected:
           CollisionType& collider;
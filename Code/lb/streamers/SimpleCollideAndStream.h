@@ -7,10 +7,15 @@
 #ifndef HEMELB_LB_STREAMERS_SIMPLECOLLIDEANDSTREAM_H
 #define HEMELB_LB_STREAMERS_SIMPLECOLLIDEANDSTREAM_H
 
+#include <algorithm>
 #include "lb/streamers/BaseStreamer.h"
 #include "lb/streamers/SimpleCollideAndStreamDelegate.h"
 #include "lb/kernels/BaseKernel.h"
+#include "lb/kernels/LBGK.h"
+#include "lb/kernels/MultiSiteLBGK.h"
+#include "lb/collisions/Normal.h"
 #include "lb/HFunction.h"
+#include "log/Logger.h"
 
 namespace hemelb
 {
@@ -18,6 +23,20 @@ namespace hemelb
   {
     namespace streamers
     {
+      /**
+       * Whether a collision can be done for several sites at once by the MultiSiteLBGK kernel.
+       */
+      template<typename CollisionImpl>
+      struct HasMultiSiteKernel
+      {
+          static const bool value = false;
+      };
+
+      template<typename LatticeType>
+      struct HasMultiSiteKernel<collisions::Normal<kernels::LBGK<LatticeType> > >
+      {
+          static const bool value = true;
+      };
 
       template<typename CollisionImpl>
       class SimpleCollideAndStream : public BaseStreamer<SimpleCollideAndStream<CollisionImpl> >
@@ -32,9 +51,13 @@ namespace hemelb
 
         public:
           SimpleCollideAndStream(kernels::InitParams& initParams) :
-            collider(initParams), bulkLinkDelegate(collider, initParams)
+            collider(initParams), bulkLinkDelegate(collider, initParams),
+                useMultiSiteKernel(HasMultiSiteKernel<CollisionType>::value && kernels::simd::IsSupportedByCpu())
           {
-
+            if (HasMultiSiteKernel<CollisionType>::value && !useMultiSiteKernel)
+            {
+              log::Logger::Log<log::Warning, log::Singleton>("HemeLB was built to collide several sites at once with vector instructions this CPU does not support; colliding one site at a time instead");
+            }
           }
 
           template<bool tDoRayTracing>
@@ -44,11 +67,101 @@ namespace hemelb
                                          geometry::LatticeData* latDat,
                                          lb::MacroscopicPropertyCache& propertyCache)
           {
-            for (site_t siteIndex = firstIndex; siteIndex < (firstIndex + siteCount); siteIndex++)
+            // The dense blocks come first, and the interior sites of each row along z of one of
+            // them stream to fixed offsets. Everything else streams through the neighbour index
+            // table.
+            const site_t endIndex = firstIndex + siteCount;
+            const site_t blockSize = latDat->GetBlockSize();
+            const site_t denseEndIndex = std::min(endIndex, latDat->GetDenseBlockSiteCount());
+            site_t tableIndex = firstIndex;
+
+            for (site_t rowIndex = firstIndex - firstIndex % blockSize; rowIndex < denseEndIndex; rowIndex +=
+                blockSize)
+            {
+              if (!latDat->IsDenseBlockInteriorRow(rowIndex))
+              {
+                continue;
+              }
+              const site_t interiorIndex = std::max(firstIndex, rowIndex + 1);
+              const site_t interiorEndIndex = std::min(denseEndIndex, rowIndex + blockSize - 1);
+              if (interiorIndex < interiorEndIndex)
+              {
+                StreamAndCollideRange<tDoRayTracing, false>(tableIndex,
+                                                            interiorIndex,
+                                                            lbmParams,
+                                                            latDat,
+                                                            propertyCache);
+                StreamAndCollideRange<tDoRayTracing, true>(interiorIndex,
+                                                           interiorEndIndex,
+                                                           lbmParams,
+                                                           latDat,
+                                                           propertyCache);
+                tableIndex = interiorEndIndex;
+              }
+            }
+
+            StreamAndCollideRange<tDoRayTracing, false>(tableIndex, endIndex, lbmParams, latDat, propertyCache);
+          }
+
+        private:
+          /**
+           * Collide and stream the sites from beginIndex up to endIndex, several at a time where
+           * possible.
+           * @tparam tDenseInterior Whether the sites are all interior sites of dense blocks, which
+           * stream to fixed offsets rather than through the neighbour index table
+           */
+          template<bool tDoRayTracing, bool tDenseInterior>
+          inline void StreamAndCollideRange(const site_t beginIndex,
+                                            const site_t endIndex,
+                                            const LbmParameters* lbmParams,
+                                            geometry::LatticeData* latDat,
+                                            lb::MacroscopicPropertyCache& propertyCache)
+          {
+            site_t siteIndex = beginIndex;
+
+#if defined(HEMELB_USE_AVX2) || defined(HEMELB_USE_AVX512)
+            if (useMultiSiteKernel && beginIndex < endIndex)
+            {
+              // Start the groups of sites where the layout keeps the distributions of a group
+              // together, if need be on a multiple of the group size, so that they line up with
+              // the blocks of the distribution layout.
+              const site_t sites = kernels::MultiSiteLBGK<LatticeType>::SITES;
+              const site_t firstGroupIndex = geometry::DistributionLayout::AreSitesContiguous(beginIndex, sites) ?
+                beginIndex :
+                std::min(endIndex, ( (beginIndex + sites - 1) / sites) * sites);
+
+              StreamAndCollideSites<tDoRayTracing, tDenseInterior>(beginIndex,
+                                                                   firstGroupIndex,
+                                                                   lbmParams,
+                                                                   latDat,
+                                                                   propertyCache);
+              siteIndex = StreamAndCollideMultiSite<tDoRayTracing, tDenseInterior>(firstGroupIndex,
+                                                                                   endIndex - firstGroupIndex,
+                                                                                   lbmParams,
+                                                                                   latDat,
+                                                                                   propertyCache);
+            }
+#endif
+
+            StreamAndCollideSites<tDoRayTracing, tDenseInterior>(siteIndex, endIndex, lbmParams, latDat, propertyCache);
+          }
+
+          /**
+           * Collide and stream the sites from beginIndex up to endIndex one at a time.
+           */
+          template<bool tDoRayTracing, bool tDenseInterior>
+          inline void StreamAndCollideSites(const site_t beginIndex,
+                                            const site_t endIndex,
+                                            const LbmParameters* lbmParams,
+                                            geometry::LatticeData* latDat,
+                                            lb::MacroscopicPropertyCache& propertyCache)
+          {
+            for (site_t siteIndex = beginIndex; siteIndex < endIndex; siteIndex++)
             {
               geometry::Site<geometry::LatticeData> site = latDat->GetSite(siteIndex);
 
-              const distribn_t* lFOld = site.GetFOld<LatticeType> ();
+              distribn_t lFOldBuffer[LatticeType::NUMVECTORS];
+              const distribn_t* lFOld = site.LoadFOld<LatticeType> (lFOldBuffer);
 
               kernels::HydroVars<typename CollisionType::CKernel> hydroVars(lFOld);
 
@@ -59,9 +172,22 @@ namespace hemelb
 
               collider.Collide(lbmParams, hydroVars);
 
-              for (unsigned int ii = 0; ii < LatticeType::NUMVECTORS; ii++)
+              if (tDenseInterior)
+              {
+                for (Direction direction = 0; direction < LatticeType::NUMVECTORS; direction++)
+                {
+                  latDat->SetFNewValue<LatticeType>(latDat->GetDenseBlockStreamedIndex<LatticeType>(siteIndex,
+                                                                                                    direction),
+                                                    direction,
+                                                    hydroVars.GetFPostCollision()[direction]);
+                }
+              }
+              else
               {
-                bulkLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
+                for (unsigned int ii = 0; ii < LatticeType::NUMVECTORS; ii++)
+                {
+                  bulkLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
+                }
               }
 
               BaseStreamer<SimpleCollideAndStream>::template UpdateMinsAndMaxes<tDoRayTracing>(site,
@@ -71,6 +197,149 @@ namespace hemelb
             }
           }
 
+          /**
+           * Collide and stream as many whole groups of MultiSiteLBGK::SITES sites as there are
+           * in the range, leaving any remainder to be done one site at a time.
+           *
+           * Where the distribution layout keeps a direction's distributions at the sites of a
+           * group together, they are loaded and stored as whole vectors; otherwise they are
+           * gathered and scattered a site at a time.
+           * @return The index of the first site that hasn't been done.
+           */
+          template<bool tDoRayTracing, bool tDenseInterior>
+          HEMELB_SIMD_TARGET site_t StreamAndCollideMultiSite(const site_t firstIndex,
+                                                              const site_t siteCount,
+                                                              const LbmParameters* lbmParams,
+                                                              geometry::LatticeData* latDat,
+                                                              lb::MacroscopicPropertyCache& propertyCache)
+          {
+            typedef kernels::MultiSiteLBGK<LatticeType> MultiSiteKernel;
+            using kernels::simd::SiteVector;
+            const site_t sites = MultiSiteKernel::SITES;
+            const site_t endIndex = firstIndex + (siteCount / sites) * sites;
+            const bool updateCache = propertyCache.AnyRequiresRefresh();
+            const bool accumulateStability = propertyCache.stabilityAccumulator.IsActive();
+
+            kernels::MultiSiteHydroVars<LatticeType> multiSiteHydroVars;
+            site_t streamedIndices[MultiSiteKernel::SITES];
+
+            for (site_t groupIndex = firstIndex; groupIndex < endIndex; groupIndex += sites)
+            {
+              for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+              {
+                distribn_t* f = &multiSiteHydroVars.f[direction * MultiSiteKernel::SITES];
+                const distribn_t* fOld = latDat->GetContiguousFOld<LatticeType>(groupIndex, sites, direction);
+
+                if (fOld != NULL)
+                {
+                  SiteVector::Load(fOld).Store(f);
+                }
+                else
+                {
+                  for (unsigned lane = 0; lane < MultiSiteKernel::SITES; ++lane)
+                  {
+                    f[lane] = latDat->GetFOldValue<LatticeType>(latDat->GetFOldIndex<LatticeType>(groupIndex + lane,
+                                                                                                  direction),
+                                                                direction);
+                  }
+                }
+              }
+
+              MultiSiteKernel::CalculateDensityMomentumFeqAndCollide(lbmParams->GetOmega(),
+                                                                     multiSiteHydroVars);
+
+              for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+              {
+                const distribn_t* fPostCollision = &multiSiteHydroVars.fPostCollision[direction
+                    * MultiSiteKernel::SITES];
+                bool contiguous = true;
+
+                for (unsigned lane = 0; lane < MultiSiteKernel::SITES; ++lane)
+                {
+                  const site_t siteIndex = groupIndex + lane;
+                  streamedIndices[lane] =
+                      tDenseInterior ?
+                        latDat->GetDenseBlockStreamedIndex<LatticeType>(siteIndex, direction) :
+                        latDat->GetSite(siteIndex).GetStreamedIndex<LatticeType>(direction);
+                  contiguous = contiguous && streamedIndices[lane] == streamedIndices[0] + (site_t) lane;
+                }
+
+                distribn_t* fNew = contiguous ? latDat->GetExactFNew(streamedIndices[0]) : NULL;
+
+                if (fNew != NULL)
+                {
+                  SiteVector::Load(fPostCollision).Store(fNew);
+                }
+                else
+                {
+                  for (unsigned lane = 0; lane < MultiSiteKernel::SITES; ++lane)
+                  {
+                    latDat->SetFNewValue<LatticeType>(streamedIndices[lane], direction, fPostCollision[lane]);
+                  }
+                }
+              }
+
+              if (!updateCache && !accumulateStability)
+              {
+                continue;
+              }
+
+              for (unsigned lane = 0; lane < MultiSiteKernel::SITES; ++lane)
+              {
+                geometry::Site<geometry::LatticeData> site = latDat->GetSite(groupIndex + lane);
+
+                distribn_t fOld[LatticeType::NUMVECTORS];
+                for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+                {
+                  fOld[direction] = multiSiteHydroVars.f[direction * MultiSiteKernel::SITES + lane];
+                }
+
+                if (updateCache)
+                {
+                  kernels::HydroVars<typename CollisionType::CKernel> hydroVars(fOld);
+                  hydroVars.tau = lbmParams->GetTau();
+                  hydroVars.density = multiSiteHydroVars.density[lane];
+                  hydroVars.momentum = util::Vector3D<distribn_t>(multiSiteHydroVars.momentumX[lane],
+                                                                  multiSiteHydroVars.momentumY[lane],
+                                                                  multiSiteHydroVars.momentumZ[lane]);
+                  hydroVars.velocity = util::Vector3D<distribn_t>(multiSiteHydroVars.velocityX[lane],
+                                                                  multiSiteHydroVars.velocityY[lane],
+                                                                  multiSiteHydroVars.velocityZ[lane]);
+
+                  for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+                  {
+                    const unsigned index = direction * MultiSiteKernel::SITES + lane;
+                    hydroVars.SetFEq(direction, multiSiteHydroVars.fEq[index]);
+                    hydroVars.SetFNeq(direction, multiSiteHydroVars.fNeq[index]);
+                    hydroVars.SetFPostCollision(direction, multiSiteHydroVars.fPostCollision[index]);
+                  }
+
+                  BaseStreamer<SimpleCollideAndStream>::template UpdateMinsAndMaxes<tDoRayTracing>(site,
+                                                                                                   hydroVars,
+                                                                                                   lbmParams,
+                                                                                                   propertyCache);
+                }
+                else if (site.GetIndex() < propertyCache.GetSiteCount())
+                {
+                  propertyCache.stabilityAccumulator.Accumulate<LatticeType>(site.GetIndex(),
+                                                                             fOld,
+                                                                             multiSiteHydroVars.density[lane],
+                                                                             util::Vector3D<distribn_t>(multiSiteHydroVars.momentumX[lane],
+                                                                                                        multiSiteHydroVars.momentumY[lane],
+                                                                                                        multiSiteHydroVars.momentumZ[lane]));
+                }
+              }
+            }
+
+            return endIndex;
+          }
+
+          /**
+           * False if this collision has no multi-site kernel, or this CPU can't run it.
+           */
+          const bool useMultiSiteKernel;
+
+        public:
           template<bool tDoRayTracing>
           inline void DoPostStep(const site_t iFirstIndex,
                                  const site_t iSiteCount,
@@ -56,7 +56,8 @@ namespace hemelb
             {
               geometry::Site<geometry::LatticeData> site = latDat->GetSite(siteIndex);
 
-              const distribn_t* fOld = site.GetFOld<LatticeType> ();
+              distribn_t fOldBuffer[LatticeType::NUMVECTORS];
+              const distribn_t* fOld = site.LoadFOld<LatticeType> (fOldBuffer);
 
               kernels::HydroVars<typename CollisionType::CKernel> hydroVars(fOld);
 
@@ -67,16 +68,22 @@ namespace hemelb
 
               collider.Collide(lbmParams, hydroVars);
 
-              for (Direction ii = 0; ii < LatticeType::NUMVECTORS; ii++)
+              // Links that hit only an iolet are streamed as bulk links, as they're not handled
+              // here.
+              const uint8_t* links = site.GetLinksByType();
+              const Direction wallLinksBegin = site.GetWallLinksBegin();
+              const Direction wallLinksEnd = site.GetWallLinksEnd();
+              for (Direction link = 0; link < wallLinksBegin; link++)
               {
-                if (site.HasWall(ii))
-                {
-                  wallLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
-                }
-                else
-                {
-                  bulkLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
-                }
+                bulkLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, links[link]);
+              }
+              for (Direction link = wallLinksBegin; link < wallLinksEnd; link++)
+              {
+                wallLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, links[link]);
+              }
+              for (Direction link = wallLinksEnd; link < LatticeType::NUMVECTORS; link++)
+              {
+                bulkLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, links[link]);
               }
 
               //TODO: Necessary to specify sub-class?
@@ -96,12 +103,10 @@ namespace hemelb
             for (site_t siteIndex = firstIndex; siteIndex < (firstIndex + siteCount); siteIndex++)
             {
               geometry::Site<geometry::LatticeData> site = latticeData->GetSite(siteIndex);
-              for (unsigned int direction = 0; direction < LatticeType::NUMVECTORS; direction++)
+              const uint8_t* links = site.GetLinksByType();
+              for (Direction link = site.GetWallLinksBegin(); link < site.GetWallLinksEnd(); link++)
               {
-                if (site.HasWall(direction))
-                {
-                  wallLinkDelegate.PostStepLink(latticeData, site, direction);
-                }
+                wallLinkDelegate.PostStepLink(latticeData, site, links[link]);
               }
             }
           }
@@ -147,7 +152,8 @@ namespace hemelb
             {
               geometry::Site<geometry::LatticeData> site = latDat->GetSite(siteIndex);
 
-              const distribn_t* fOld = site.GetFOld<LatticeType> ();
+              distribn_t fOldBuffer[LatticeType::NUMVECTORS];
+              const distribn_t* fOld = site.LoadFOld<LatticeType> (fOldBuffer);
 
               kernels::HydroVars<typename CollisionType::CKernel> hydroVars(fOld);
 
@@ -158,16 +164,16 @@ namespace hemelb
 
               collider.Collide(lbmParams, hydroVars);
 
-              for (Direction ii = 0; ii < LatticeType::NUMVECTORS; ii++)
+              // Any wall links are streamed as bulk links, as they're not handled here.
+              const uint8_t* links = site.GetLinksByType();
+              const Direction ioletLinksBegin = site.GetIoletLinksBegin();
+              for (Direction link = 0; link < ioletLinksBegin; link++)
+              {
+                bulkLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, links[link]);
+              }
+              for (Direction link = ioletLinksBegin; link < LatticeType::NUMVECTORS; link++)
               {
-                if (site.HasIolet(ii))
-                {
-                  ioletLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
-                }
-                else
-                {
-                  bulkLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
-                }
+                ioletLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, links[link]);
               }
 
               //TODO: Necessary to specify sub-class?
@@ -187,12 +193,10 @@ namespace hemelb
             for (site_t siteIndex = firstIndex; siteIndex < (firstIndex + siteCount); siteIndex++)
             {
               geometry::Site<geometry::LatticeData> site = latticeData->GetSite(siteIndex);
-              for (unsigned int direction = 0; direction < LatticeType::NUMVECTORS; direction++)
+              const uint8_t* links = site.GetLinksByType();
+              for (Direction link = site.GetIoletLinksBegin(); link < LatticeType::NUMVECTORS; link++)
               {
-                if (site.HasIolet(direction))
-                {
-                  ioletLinkDelegate.PostStepLink(latticeData, site, direction);
-                }
+                ioletLinkDelegate.PostStepLink(latticeData, site, links[link]);
               }
             }
           }
@@ -241,7 +245,8 @@ namespace hemelb
             {
               geometry::Site<geometry::LatticeData> site = latDat->GetSite(siteIndex);
 
-              const distribn_t* fOld = site.GetFOld<LatticeType> ();
+              distribn_t fOldBuffer[LatticeType::NUMVECTORS];
+              const distribn_t* fOld = site.LoadFOld<LatticeType> (fOldBuffer);
 
               kernels::HydroVars<typename CollisionType::CKernel> hydroVars(fOld);
 
@@ -252,20 +257,21 @@ namespace hemelb
 
               collider.Collide(lbmParams, hydroVars);
 
-              for (Direction ii = 0; ii < LatticeType::NUMVECTORS; ii++)
+              // Links that hit both a wall and an iolet are streamed as iolet links.
+              const uint8_t* links = site.GetLinksByType();
+              const Direction wallLinksBegin = site.GetWallLinksBegin();
+              const Direction ioletLinksBegin = site.GetIoletLinksBegin();
+              for (Direction link = 0; link < wallLinksBegin; link++)
               {
-                if (site.HasIolet(ii))
-                {
-                  ioletLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
-                }
-                else if (site.HasWall(ii))
-                {
-                  wallLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
-                }
-                else
-                {
-                  bulkLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, ii);
-                }
+                bulkLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, links[link]);
+              }
+              for (Direction link = wallLinksBegin; link < ioletLinksBegin; link++)
+              {
+                wallLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, links[link]);
+              }
+              for (Direction link = ioletLinksBegin; link < LatticeType::NUMVECTORS; link++)
+              {
+                ioletLinkDelegate.StreamLink(lbmParams, latDat, site, hydroVars, links[link]);
               }
 
               //TODO: Necessary to specify sub-class?
@@ -286,16 +292,17 @@ namespace hemelb
             for (site_t siteIndex = firstIndex; siteIndex < (firstIndex + siteCount); siteIndex++)
             {
               geometry::Site<geometry::LatticeData> site = latticeData->GetSite(siteIndex);
-              for (unsigned int direction = 0; direction < LatticeType::NUMVECTORS; direction++)
+              // But after the step, links that hit both a wall and an iolet are treated as wall
+              // links.
+              const uint8_t* links = site.GetLinksByType();
+              const Direction wallLinksEnd = site.GetWallLinksEnd();
+              for (Direction link = site.GetWallLinksBegin(); link < wallLinksEnd; link++)
+              {
+                wallLinkDelegate.PostStepLink(latticeData, site, links[link]);
+              }
+              for (Direction link = wallLinksEnd; link < LatticeType::NUMVECTORS; link++)
               {
-                if (site.HasWall(direction))
-                {
-                  wallLinkDelegate.PostStepLink(latticeData, site, direction);
-                }
-                else if (site.HasIolet(direction))
-                {
-                  ioletLinkDelegate.PostStepLink(latticeData, site, direction);
-                }
+                ioletLinkDelegate.PostStepLink(latticeData, site, links[link]);
               }
             }
 
@@ -150,7 +150,8 @@ namespace hemelb
             {
               geometry::Site<geometry::LatticeData> site = latDat->GetSite(siteIndex);
 
-              const distribn_t* fOld = site.GetFOld<LatticeType> ();
+              distribn_t fOldBuffer[LatticeType::NUMVECTORS];
+              const distribn_t* fOld = site.LoadFOld<LatticeType> (fOldBuffer);
 
               kernels::HydroVars<typename CollisionType::CKernel> hydroVars(fOld);
 
@@ -223,7 +224,9 @@ namespace hemelb
               CalculateVirtualSiteDistributions(*latDat, *iolet, extra->hydroVarsCache, *vSite, t);
               // Stream this direction
               Direction i = vSiteIt->second.direction;
-              * (latDat->GetFNew(siteIdx * LatticeType::NUMVECTORS + i)) = vSite->hv.fPostColl[i];
+              latDat->SetFNewValue<LatticeType>(latDat->GetDistributionIndex<LatticeType>(siteIdx, i),
+                                                i,
+                                                vSite->hv.fPostColl[i]);
               //* (latticeData->GetFNew(GetBBIndex(site.GetIndex(), direction))) = hydroVars.GetFPostCollision()[direction];
               //return (siteIndex * LatticeType::NUMVECTORS) + LatticeType::INVERSEDIRECTIONS[direction];
             }
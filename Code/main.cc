@@ -8,6 +8,7 @@
 #include "net/IOCommunicator.h"
 #include "configuration/CommandLine.h"
 #include "SimulationMaster.h"
+#include "WeightCalibrator.h"
 
 int main(int argc, char *argv[])
 {
@@ -31,11 +32,20 @@ int main(int argc, char *argv[])
       // Start the debugger (if requested)
       hemelb::debug::Debugger::Init(options.GetDebug(), argv[0], commWorld);
 
-      // Prepare main simulation object...
-      SimulationMaster master = SimulationMaster(options, hemelbCommunicator);
+      if (!options.GetCalibrationFile().empty())
+      {
+        // Work out the site weights for the decomposition, rather than simulate.
+        WeightCalibrator calibrator(options, hemelbCommunicator);
+        calibrator.Run();
+      }
+      else
+      {
+        // Prepare main simulation object...
+        SimulationMaster master = SimulationMaster(options, hemelbCommunicator);
 
-      // ..and run it.
-      master.RunSimulation();
+        // ..and run it.
+        master.RunSimulation();
+      }
     }
 
     // Interpose this catch to print usage before propagating the error.
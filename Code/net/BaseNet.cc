@@ -67,6 +67,16 @@ namespace hemelb
       countsBuffer.clear();
     }
 
+    bool BaseNet::Progress()
+    {
+      return ProgressPointToPoint();
+    }
+
+    void BaseNet::SetNeighbourhood(const std::vector<proc_t>& neighbours)
+    {
+      // Only some implementations make use of this.
+    }
+
     std::vector<int> & BaseNet::GetDisplacementsBuffer()
     {
       displacementsBuffer.push_back(std::vector<int>());
@@ -44,6 +44,21 @@ namespace hemelb
          */
         void Dispatch();
 
+        /***
+         * Give the MPI library a chance to progress any point-to-point communication that has been
+         * sent and received but not yet waited on, without blocking.
+         * @return true if all of it has completed.
+         */
+        bool Progress();
+
+        /***
+         * Tell the Net which ranks this one exchanges data with on most steps, for
+         * implementations that can set something up for that in advance. Collective: every
+         * rank of the communicator must call it, with a symmetric neighbourhood.
+         * @param neighbours
+         */
+        virtual void SetNeighbourhood(const std::vector<proc_t>& neighbours);
+
         inline const MpiCommunicator &GetCommunicator() const
         {
           return communicator;
@@ -69,6 +84,7 @@ namespace hemelb
         virtual void ReceiveAllToAll()=0;
 
         virtual void WaitPointToPoint()=0;
+        virtual bool ProgressPointToPoint()=0;
         virtual void WaitGathers()=0;
         virtual void WaitGatherVs()=0;
         virtual void WaitAllToAll()=0;
@@ -111,5 +111,32 @@ namespace hemelb
       HEMELB_MPI_CALL(MPI_Comm_dup, (*commPtr, &newComm));
       return MpiCommunicator(newComm, true);
     }
+
+    MpiCommunicator MpiCommunicator::SplitShared() const
+    {
+      MPI_Comm newComm;
+      HEMELB_MPI_CALL(MPI_Comm_split_type, (*commPtr, MPI_COMM_TYPE_SHARED, Rank(), MPI_INFO_NULL, &newComm));
+      return MpiCommunicator(newComm, true);
+    }
+
+    MpiCommunicator MpiCommunicator::Split(int colour) const
+    {
+      MPI_Comm newComm;
+      HEMELB_MPI_CALL(MPI_Comm_split, (*commPtr, colour, Rank(), &newComm));
+      return MpiCommunicator(newComm, true);
+    }
+
+    MpiCommunicator MpiCommunicator::DistGraphAdjacent(const std::vector<int>& neighbours, bool reorder) const
+    {
+      MPI_Comm newComm;
+      // MPI wants non-null pointers even for a process without neighbours.
+      const int dummy = 0;
+      const int* ranks = neighbours.empty() ? &dummy : &neighbours.front();
+      HEMELB_MPI_CALL(
+          MPI_Dist_graph_create_adjacent,
+          (*commPtr, (int) neighbours.size(), MpiConstCast(ranks), MPI_UNWEIGHTED, (int) neighbours.size(), MpiConstCast(ranks), MPI_UNWEIGHTED, MPI_INFO_NULL, reorder, &newComm)
+      );
+      return MpiCommunicator(newComm, true);
+    }
   }
 }
@@ -88,6 +88,31 @@ namespace hemelb
          */
         MpiCommunicator Duplicate() const;
 
+        /**
+         * Split the communicator into one for each group of processes that can share memory,
+         * i.e. one per node - see MPI_COMM_SPLIT_TYPE with MPI_COMM_TYPE_SHARED.
+         * @return New communicator of the processes on this one's node.
+         */
+        MpiCommunicator SplitShared() const;
+
+        /**
+         * Split the communicator into one for each colour - see MPI_COMM_SPLIT. Collective.
+         * @param colour The processes with the same colour end up in the same communicator.
+         * @return New communicator of the processes with this one's colour, in the same order.
+         */
+        MpiCommunicator Split(int colour) const;
+
+        /**
+         * Create a communicator with the topology of a distributed graph, in which this process
+         * both sends to and receives from the given ranks - see MPI_DIST_GRAPH_CREATE_ADJACENT.
+         * Collective over this communicator.
+         * @param neighbours Ranks in this communicator, in the order the neighbourhood collectives
+         * on the new one will use.
+         * @param reorder Whether MPI may renumber the processes to suit the hardware.
+         * @return New communicator.
+         */
+        MpiCommunicator DistGraphAdjacent(const std::vector<int>& neighbours, bool reorder) const;
+
         template <typename T>
         void Broadcast(T& val, const int root) const;
         template <typename T>
@@ -19,7 +19,10 @@ namespace hemelb
     {
       if (!Initialized())
       {
-        HEMELB_MPI_CALL(MPI_Init, (&argc, &argv));
+        // Worker threads never call MPI, so funnelled support is all that's needed. If the
+        // library gives less, SimulationMaster runs the LB update on one thread.
+        int provided;
+        HEMELB_MPI_CALL(MPI_Init_thread, (&argc, &argv, MPI_THREAD_FUNNELED, &provided));
         HEMELB_MPI_CALL(MPI_Comm_set_errhandler, (MPI_COMM_WORLD, MPI_ERRORS_RETURN));
         doesOwnMpi = true;
       }
@@ -51,6 +54,13 @@ namespace hemelb
         : false;
     }
 
+    bool MpiEnvironment::IsFunnelledThreadingSupported()
+    {
+      int provided;
+      HEMELB_MPI_CALL(MPI_Query_thread, (&provided));
+      return provided >= MPI_THREAD_FUNNELED;
+    }
+
     void MpiEnvironment::Abort(int errorCode)
     {
       MpiCommunicator::World().Abort(errorCode);
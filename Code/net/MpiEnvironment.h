@@ -45,6 +45,12 @@ namespace hemelb
          * @return
          */
         static bool Finalized();
+        /**
+         * Query whether MPI was initialised with at least funnelled thread support, so that the
+         * main thread may call MPI while other threads are running.
+         * @return
+         */
+        static bool IsFunnelledThreadingSupported();
         /**
          * Abort MPI. Exact behaviour is implementation defined.
          * Should not return.
@@ -56,6 +56,15 @@ namespace hemelb
         void Write(const std::vector<T>& buffer, MPI_Status* stat = MPI_STATUS_IGNORE);
         template<typename T>
         void WriteAt(MPI_Offset offset, const std::vector<T>& buffer, MPI_Status* stat = MPI_STATUS_IGNORE);
+
+        /**
+         * Collective versions of ReadAt and WriteAt, which every rank must call, if need be
+         * with an empty buffer.
+         */
+        template<typename T>
+        void ReadAtAll(MPI_Offset offset, std::vector<T>& buffer, MPI_Status* stat = MPI_STATUS_IGNORE);
+        template<typename T>
+        void WriteAtAll(MPI_Offset offset, const std::vector<T>& buffer, MPI_Status* stat = MPI_STATUS_IGNORE);
       protected:
         MpiFile(const MpiCommunicator& parentComm, MPI_File fh);
 
@@ -49,6 +49,25 @@ namespace hemelb
 
     }
 
+    template<typename T>
+    void MpiFile::ReadAtAll(MPI_Offset offset, std::vector<T>& buffer, MPI_Status* stat)
+    {
+      // Empty vectors have no first element to point at.
+      HEMELB_MPI_CALL(
+          MPI_File_read_at_all,
+          (*filePtr, offset, buffer.empty() ? NULL : &buffer[0], buffer.size(), MpiDataType<T>(), stat)
+      );
+    }
+
+    template<typename T>
+    void MpiFile::WriteAtAll(MPI_Offset offset, const std::vector<T>& buffer, MPI_Status* stat)
+    {
+      HEMELB_MPI_CALL(
+          MPI_File_write_at_all,
+          (*filePtr, offset, buffer.empty() ? NULL : MpiConstCast(&buffer[0]), buffer.size(), MpiDataType<T>(), stat)
+      );
+    }
+
   }
 }
 
@@ -0,0 +1,134 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_NET_SHAREDWINDOWALLOCATOR_H
+#define HEMELB_NET_SHAREDWINDOWALLOCATOR_H
+
+#include <cstddef>
+#include <map>
+#include <type_traits>
+#include "net/mpi.h"
+#include "net/MpiCommunicator.h"
+
+namespace hemelb
+{
+  namespace net
+  {
+    /**
+     * Standard-library allocator that puts each allocation in its own MPI-3 shared-memory window
+     * over the given communicator, whose processes must all share a node (see
+     * MpiCommunicator::SplitShared).
+     *
+     * Allocating and deallocating are collective: every process of the communicator must do
+     * the same allocations in the same order. Each process's allocation is then a segment of
+     * the same window, so processes can find each other's memory with MPI_Win_shared_query on
+     * the window of their own.
+     */
+    template<typename T>
+    class SharedWindowAllocator
+    {
+      public:
+        typedef T value_type;
+        // Containers must take the allocator, and so the communicator, with their memory.
+        typedef std::true_type propagate_on_container_move_assignment;
+        typedef std::true_type propagate_on_container_swap;
+
+        SharedWindowAllocator()
+        {
+        }
+
+        SharedWindowAllocator(const MpiCommunicator& nodeComm) :
+            nodeComm(nodeComm)
+        {
+        }
+
+        template<typename U>
+        SharedWindowAllocator(const SharedWindowAllocator<U>& other) :
+            nodeComm(other.GetCommunicator())
+        {
+        }
+
+        const MpiCommunicator& GetCommunicator() const
+        {
+          return nodeComm;
+        }
+
+        T* allocate(std::size_t n)
+        {
+          T* base;
+          MPI_Win window;
+          HEMELB_MPI_CALL(MPI_Win_allocate_shared,
+                          ( (MPI_Aint) (n * sizeof(T)), (int) sizeof(T), MPI_INFO_NULL, nodeComm, &base, &window));
+          // Processes read each other's segments between their own synchronisation, so keep a
+          // passive-target epoch open for the life of the window.
+          HEMELB_MPI_CALL(MPI_Win_lock_all, (MPI_MODE_NOCHECK, window));
+          Windows()[base] = window;
+          return base;
+        }
+
+        void deallocate(T* base, std::size_t n)
+        {
+          typename std::map<const T*, MPI_Win>::iterator it = Windows().find(base);
+          MPI_Win window = it->second;
+          Windows().erase(it);
+
+          int finalized;
+          HEMELB_MPI_CALL(MPI_Finalized, (&finalized));
+          if (!finalized)
+          {
+            HEMELB_MPI_CALL(MPI_Win_unlock_all, (window));
+            HEMELB_MPI_CALL(MPI_Win_free, (&window));
+          }
+        }
+
+        /**
+         * Get the window of memory allocated by an allocator of this type.
+         * @param base The start of the allocation.
+         */
+        static MPI_Win GetWindow(const T* base)
+        {
+          return Windows().find(base)->second;
+        }
+
+        /**
+         * Get the start of the segment of another process in the window of memory allocated
+         * by an allocator of this type.
+         * @param base The start of the allocation on this process.
+         * @param nodeRank The rank of the other process in the communicator.
+         */
+        static T* GetSegment(const T* base, int nodeRank)
+        {
+          MPI_Aint size;
+          int displacementUnit;
+          T* segment;
+          HEMELB_MPI_CALL(MPI_Win_shared_query, (GetWindow(base), nodeRank, &size, &displacementUnit, &segment));
+          return segment;
+        }
+
+      private:
+        static std::map<const T*, MPI_Win>& Windows()
+        {
+          static std::map<const T*, MPI_Win> windows;
+          return windows;
+        }
+
+        MpiCommunicator nodeComm;
+    };
+
+    template<typename T, typename U>
+    bool operator==(const SharedWindowAllocator<T>& left, const SharedWindowAllocator<U>& right)
+    {
+      return left.GetCommunicator() == right.GetCommunicator();
+    }
+
+    template<typename T, typename U>
+    bool operator!=(const SharedWindowAllocator<T>& left, const SharedWindowAllocator<U>& right)
+    {
+      return ! (left == right);
+    }
+  }
+}
+
+#endif /* HEMELB_NET_SHAREDWINDOWALLOCATOR_H */
@@ -0,0 +1,71 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "net/mixins/alltoall/RuntimeAllToAll.h"
+#include "net/BuildInfo.h"
+#include "Exception.h"
+namespace hemelb
+{
+  namespace net
+  {
+    RuntimeAllToAll::RuntimeAllToAll(const MpiCommunicator& comms) :
+        BaseNet(comms), StoringNet(comms), SeparatedAllToAll(comms), ViaPointPointAllToAll(comms),
+            viaPointPoint(false)
+    {
+      SelectAllToAll(default_alltoall_implementation);
+    }
+
+    void RuntimeAllToAll::SelectAllToAll(const std::string& name)
+    {
+      if (name != "Separated" && name != "ViaPointPoint")
+      {
+        throw Exception() << "Unknown all-to-all implementation '" << name << "'";
+      }
+      viaPointPoint = (name == "ViaPointPoint");
+    }
+
+    std::string RuntimeAllToAll::GetAllToAllName() const
+    {
+      return viaPointPoint ? "ViaPointPoint" : "Separated";
+    }
+
+    void RuntimeAllToAll::ReceiveAllToAll()
+    {
+      if (viaPointPoint)
+      {
+        ViaPointPointAllToAll::ReceiveAllToAll();
+      }
+      else
+      {
+        SeparatedAllToAll::ReceiveAllToAll();
+      }
+    }
+
+    void RuntimeAllToAll::SendAllToAll()
+    {
+      if (viaPointPoint)
+      {
+        ViaPointPointAllToAll::SendAllToAll();
+      }
+      else
+      {
+        SeparatedAllToAll::SendAllToAll();
+      }
+    }
+
+    void RuntimeAllToAll::WaitAllToAll()
+    {
+      if (viaPointPoint)
+      {
+        ViaPointPointAllToAll::WaitAllToAll();
+      }
+      else
+      {
+        SeparatedAllToAll::WaitAllToAll();
+      }
+    }
+  }
+}
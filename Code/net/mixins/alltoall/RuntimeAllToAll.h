@@ -0,0 +1,38 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_NET_MIXINS_ALLTOALL_RUNTIMEALLTOALL_H
+#define HEMELB_NET_MIXINS_ALLTOALL_RUNTIMEALLTOALL_H
+
+#include <string>
+#include "net/mixins/alltoall/SeparatedAllToAll.h"
+#include "net/mixins/alltoall/ViaPointPointAllToAll.h"
+
+namespace hemelb{
+  namespace net{
+    /***
+     * Both all-to-all implementations, choosing between them at run time. Starts as the one set
+     * by HEMELB_ALLTOALL_IMPLEMENTATION. All ranks must choose the same one.
+     */
+    class RuntimeAllToAll : public SeparatedAllToAll, public ViaPointPointAllToAll
+    {
+    public:
+      RuntimeAllToAll(const MpiCommunicator& comms);
+      /***
+       * Use the implementation with the given name, as for HEMELB_ALLTOALL_IMPLEMENTATION.
+       */
+      void SelectAllToAll(const std::string& name);
+      std::string GetAllToAllName() const;
+    protected:
+      void ReceiveAllToAll();
+      void SendAllToAll();
+      void WaitAllToAll();
+    private:
+      bool viaPointPoint;
+    };
+  }
+}
+#endif
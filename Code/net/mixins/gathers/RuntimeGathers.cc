@@ -0,0 +1,107 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "net/mixins/gathers/RuntimeGathers.h"
+#include "net/BuildInfo.h"
+#include "Exception.h"
+namespace hemelb
+{
+  namespace net
+  {
+    RuntimeGathers::RuntimeGathers(const MpiCommunicator& comms) :
+        BaseNet(comms), StoringNet(comms), SeparatedGathers(comms), ViaPointPointGathers(comms),
+            viaPointPoint(false)
+    {
+      SelectGathers(default_gathers_implementation);
+    }
+
+    void RuntimeGathers::SelectGathers(const std::string& name)
+    {
+      if (name != "Separated" && name != "ViaPointPoint")
+      {
+        throw Exception() << "Unknown gathers implementation '" << name << "'";
+      }
+      viaPointPoint = (name == "ViaPointPoint");
+    }
+
+    std::string RuntimeGathers::GetGathersName() const
+    {
+      return viaPointPoint ? "ViaPointPoint" : "Separated";
+    }
+
+    void RuntimeGathers::ReceiveGathers()
+    {
+      if (viaPointPoint)
+      {
+        ViaPointPointGathers::ReceiveGathers();
+      }
+      else
+      {
+        SeparatedGathers::ReceiveGathers();
+      }
+    }
+
+    void RuntimeGathers::SendGathers()
+    {
+      if (viaPointPoint)
+      {
+        ViaPointPointGathers::SendGathers();
+      }
+      else
+      {
+        SeparatedGathers::SendGathers();
+      }
+    }
+
+    void RuntimeGathers::ReceiveGatherVs()
+    {
+      if (viaPointPoint)
+      {
+        ViaPointPointGathers::ReceiveGatherVs();
+      }
+      else
+      {
+        SeparatedGathers::ReceiveGatherVs();
+      }
+    }
+
+    void RuntimeGathers::SendGatherVs()
+    {
+      if (viaPointPoint)
+      {
+        ViaPointPointGathers::SendGatherVs();
+      }
+      else
+      {
+        SeparatedGathers::SendGatherVs();
+      }
+    }
+
+    void RuntimeGathers::WaitGathers()
+    {
+      if (viaPointPoint)
+      {
+        ViaPointPointGathers::WaitGathers();
+      }
+      else
+      {
+        SeparatedGathers::WaitGathers();
+      }
+    }
+
+    void RuntimeGathers::WaitGatherVs()
+    {
+      if (viaPointPoint)
+      {
+        ViaPointPointGathers::WaitGatherVs();
+      }
+      else
+      {
+        SeparatedGathers::WaitGatherVs();
+      }
+    }
+  }
+}
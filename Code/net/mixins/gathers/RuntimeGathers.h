@@ -0,0 +1,41 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_NET_MIXINS_GATHERS_RUNTIMEGATHERS_H
+#define HEMELB_NET_MIXINS_GATHERS_RUNTIMEGATHERS_H
+
+#include <string>
+#include "net/mixins/gathers/SeparatedGathers.h"
+#include "net/mixins/gathers/ViaPointPointGathers.h"
+
+namespace hemelb{
+  namespace net{
+    /***
+     * Both gather implementations, choosing between them at run time. Starts as the one set by
+     * HEMELB_GATHERS_IMPLEMENTATION. All ranks must choose the same one.
+     */
+    class RuntimeGathers : public SeparatedGathers, public ViaPointPointGathers
+    {
+    public:
+      RuntimeGathers(const MpiCommunicator& comms);
+      /***
+       * Use the implementation with the given name, as for HEMELB_GATHERS_IMPLEMENTATION.
+       */
+      void SelectGathers(const std::string& name);
+      std::string GetGathersName() const;
+    protected:
+      void ReceiveGathers();
+      void SendGathers();
+      void ReceiveGatherVs();
+      void SendGatherVs();
+      void WaitGathers();
+      void WaitGatherVs();
+    private:
+      bool viaPointPoint;
+    };
+  }
+}
+#endif
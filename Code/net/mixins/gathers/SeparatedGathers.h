@@ -16,7 +16,7 @@ namespace hemelb{
     {
     public:
       SeparatedGathers(const MpiCommunicator& comms);
-    private:
+    protected:
       void ReceiveGathers(){}
       void SendGathers(){}
       void ReceiveGatherVs(){}
@@ -20,7 +20,7 @@ namespace hemelb{
     {
     public:
       ViaPointPointGathers(const MpiCommunicator& comms);
-    private:
+    protected:
       void ReceiveGathers();
       void SendGathers();
       void ReceiveGatherVs();
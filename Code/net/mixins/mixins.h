@@ -10,10 +10,16 @@
 #include "net/mixins/pointpoint/CoalescePointPoint.h"
 #include "net/mixins/pointpoint/ImmediatePointPoint.h"
 #include "net/mixins/pointpoint/SeparatedPointPoint.h"
+#include "net/mixins/pointpoint/PersistentPointPoint.h"
+#include "net/mixins/pointpoint/NeighbourhoodPointPoint.h"
+#include "net/mixins/pointpoint/PackedPointPoint.h"
+#include "net/mixins/pointpoint/RuntimePointPoint.h"
 #include "net/mixins/StoringNet.h"
 #include "net/mixins/gathers/SeparatedGathers.h"
 #include "net/mixins/InterfaceDelegationNet.h"
 #include "net/mixins/gathers/ViaPointPointGathers.h"
+#include "net/mixins/gathers/RuntimeGathers.h"
 #include "net/mixins/alltoall/SeparatedAllToAll.h"
 #include "net/mixins/alltoall/ViaPointPointAllToAll.h"
+#include "net/mixins/alltoall/RuntimeAllToAll.h"
 #endif
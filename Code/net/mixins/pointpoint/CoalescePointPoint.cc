@@ -16,7 +16,7 @@ namespace hemelb
     {
       if (requests.size() < count)
       {
-        requests.resize(count, MPI_Request());
+        requests.resize(count, MPI_REQUEST_NULL);
         statuses.resize(count, MPI_Status());
       }
     }
@@ -121,6 +121,23 @@ namespace hemelb
       }
     }
 
+    bool CoalescePointPoint::ProgressPointToPoint()
+    {
+      if (!sendReceivePrepped)
+      {
+        return true;
+      }
+
+      // Requests not yet sent are null, which MPI counts as complete, as are those completed
+      // by an earlier call. A later MPI_Waitall on them returns immediately.
+      int complete = 0;
+      MPI_Testall((int) (sendProcessorComms.size() + receiveProcessorComms.size()),
+                  &requests[0],
+                  &complete,
+                  &statuses[0]);
+      return complete;
+    }
+
     void CoalescePointPoint::WaitPointToPoint()
     {
 
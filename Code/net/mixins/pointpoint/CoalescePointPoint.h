@@ -23,6 +23,7 @@ namespace hemelb
         ~CoalescePointPoint();
 
         void WaitPointToPoint();
+        bool ProgressPointToPoint();
 
       protected:
         void ReceivePointToPoint();
@@ -47,5 +47,10 @@ namespace hemelb
     {
 
     }
+
+    bool ImmediatePointPoint::ProgressPointToPoint()
+    {
+      return true;
+    }
   }
 }
@@ -26,6 +26,7 @@ namespace hemelb
         ~ImmediatePointPoint();
 
         void WaitPointToPoint();
+        bool ProgressPointToPoint(); //Always complete
         // we will *NOT* store the requests, so we must provide RequestSendImpl ourselves.
         virtual void RequestSendImpl(void* pointer, int count, proc_t rank, MPI_Datatype type);
         virtual void RequestReceiveImpl(void* pointer, int count, proc_t rank, MPI_Datatype type);
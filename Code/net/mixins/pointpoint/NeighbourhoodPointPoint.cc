@@ -0,0 +1,178 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "net/mixins/pointpoint/NeighbourhoodPointPoint.h"
+
+namespace hemelb
+{
+  namespace net
+  {
+
+    void NeighbourhoodPointPoint::SetNeighbourhood(const std::vector<proc_t>& newNeighbours)
+    {
+      neighbours = newNeighbours;
+      // No reordering: the sites were decomposed over the ranks of the communicator before the
+      // graph was known, so a process given a new rank would still hold the same sites, and the
+      // renumbering could only ever go unused.
+      graphComm = communicator.DistGraphAdjacent(std::vector<int>(neighbours.begin(), neighbours.end()), false);
+
+      sendCounts.resize(neighbours.size());
+      receiveCounts.resize(neighbours.size());
+      sendDisplacements.resize(neighbours.size());
+      receiveDisplacements.resize(neighbours.size());
+      sendTypes.resize(neighbours.size());
+      receiveTypes.resize(neighbours.size());
+    }
+
+    void NeighbourhoodPointPoint::SeparateNeighbourhoodComms()
+    {
+      for (std::vector<proc_t>::const_iterator neighbour = neighbours.begin(); neighbour != neighbours.end();
+          ++neighbour)
+      {
+        std::map<proc_t, ProcComms>::iterator send = sendProcessorComms.find(*neighbour);
+        if (send != sendProcessorComms.end())
+        {
+          ProcComms& comms = neighbourhoodSends[*neighbour];
+          comms.insert(comms.end(), send->second.begin(), send->second.end());
+          sendProcessorComms.erase(send);
+        }
+
+        std::map<proc_t, ProcComms>::iterator receive = receiveProcessorComms.find(*neighbour);
+        if (receive != receiveProcessorComms.end())
+        {
+          ProcComms& comms = neighbourhoodReceives[*neighbour];
+          comms.insert(comms.end(), receive->second.begin(), receive->second.end());
+          receiveProcessorComms.erase(receive);
+        }
+      }
+    }
+
+    void NeighbourhoodPointPoint::DescribeExchange(std::map<proc_t, ProcComms>& comms,
+                                                   std::vector<int>& counts,
+                                                   std::vector<MPI_Aint>& displacements,
+                                                   std::vector<MPI_Datatype>& types)
+    {
+      for (size_t neighbourId = 0; neighbourId < neighbours.size(); ++neighbourId)
+      {
+        std::map<proc_t, ProcComms>::iterator it = comms.find(neighbours[neighbourId]);
+        if (it == comms.end())
+        {
+          counts[neighbourId] = 0;
+          displacements[neighbourId] = 0;
+          types[neighbourId] = MPI_BYTE;
+          continue;
+        }
+
+        it->second.CreateMPIType();
+        counts[neighbourId] = 1;
+        MPI_Get_address(it->second.front().Pointer, &displacements[neighbourId]);
+        types[neighbourId] = it->second.Type;
+      }
+    }
+
+    void NeighbourhoodPointPoint::StartExchange()
+    {
+      if (! (sent && received))
+      {
+        return;
+      }
+
+      DescribeExchange(neighbourhoodSends, sendCounts, sendDisplacements, sendTypes);
+      DescribeExchange(neighbourhoodReceives, receiveCounts, receiveDisplacements, receiveTypes);
+
+      for (std::map<proc_t, ProcComms>::iterator it = neighbourhoodSends.begin(); it != neighbourhoodSends.end();
+          ++it)
+      {
+        int typeSize = 0; //DTMP:byte size tracking
+        MPI_Type_size(it->second.Type, &typeSize); //DTMP:
+        BytesSent += typeSize; //DTMP:
+      }
+
+      // Without neighbours, MPI still wants valid pointers.
+      int noCount = 0;
+      MPI_Aint noDisplacement = 0;
+      MPI_Datatype noType = MPI_BYTE;
+      const bool none = neighbours.empty();
+      MPI_Ineighbor_alltoallw(MPI_BOTTOM,
+                              none ? &noCount : &sendCounts[0],
+                              none ? &noDisplacement : &sendDisplacements[0],
+                              none ? &noType : &sendTypes[0],
+                              MPI_BOTTOM,
+                              none ? &noCount : &receiveCounts[0],
+                              none ? &noDisplacement : &receiveDisplacements[0],
+                              none ? &noType : &receiveTypes[0],
+                              graphComm,
+                              &exchangeRequest);
+    }
+
+    void NeighbourhoodPointPoint::ReceivePointToPoint()
+    {
+      if (graphComm)
+      {
+        SeparateNeighbourhoodComms();
+        received = true;
+        StartExchange();
+      }
+      CoalescePointPoint::ReceivePointToPoint();
+    }
+
+    void NeighbourhoodPointPoint::SendPointToPoint()
+    {
+      if (graphComm)
+      {
+        SeparateNeighbourhoodComms();
+        sent = true;
+        StartExchange();
+      }
+      CoalescePointPoint::SendPointToPoint();
+    }
+
+    /*!
+     Free the allocated data.
+     */
+    NeighbourhoodPointPoint::~NeighbourhoodPointPoint()
+    {
+    }
+
+    bool NeighbourhoodPointPoint::ProgressPointToPoint()
+    {
+      int exchangeComplete = 1;
+      MPI_Test(&exchangeRequest, &exchangeComplete, MPI_STATUS_IGNORE);
+      return CoalescePointPoint::ProgressPointToPoint() && exchangeComplete;
+    }
+
+    void NeighbourhoodPointPoint::WaitPointToPoint()
+    {
+      MPI_Wait(&exchangeRequest, MPI_STATUS_IGNORE);
+      CoalescePointPoint::WaitPointToPoint();
+
+      // The datatypes only exist if the exchange was started.
+      const bool exchanged = sent && received;
+      for (std::map<proc_t, ProcComms>::iterator it = neighbourhoodSends.begin(); it != neighbourhoodSends.end();
+          ++it)
+      {
+        if (exchanged)
+        {
+          MPI_Type_free(&it->second.Type);
+        }
+      }
+      neighbourhoodSends.clear();
+
+      for (std::map<proc_t, ProcComms>::iterator it = neighbourhoodReceives.begin();
+          it != neighbourhoodReceives.end(); ++it)
+      {
+        if (exchanged)
+        {
+          MPI_Type_free(&it->second.Type);
+        }
+      }
+      neighbourhoodReceives.clear();
+
+      sent = false;
+      received = false;
+    }
+  }
+}
@@ -0,0 +1,81 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_NET_MIXINS_POINTPOINT_NEIGHBOURHOODPOINTPOINT_H
+#define HEMELB_NET_MIXINS_POINTPOINT_NEIGHBOURHOODPOINTPOINT_H
+#include "net/mixins/pointpoint/CoalescePointPoint.h"
+namespace hemelb
+{
+  namespace net
+  {
+    /**
+     * Point-to-point communication with the ranks in the neighbourhood set by SetNeighbourhood
+     * goes through a single MPI_Ineighbor_alltoallw per step on a distributed graph
+     * communicator. Each neighbour gets one message, built as for CoalescePointPoint. Any other
+     * communication falls back to CoalescePointPoint.
+     *
+     * Because the exchange is collective, every rank must send and receive on this Net the same
+     * number of times once the neighbourhood is set, even if it has nothing for its neighbours.
+     *
+     * MPI isn't allowed to reorder the processes of the graph communicator to suit the hardware,
+     * as the neighbourhood is only known once the domain has been decomposed.
+     */
+    class NeighbourhoodPointPoint : public CoalescePointPoint
+    {
+
+      public:
+        NeighbourhoodPointPoint(const MpiCommunicator& comms) :
+            BaseNet(comms), StoringNet(comms), CoalescePointPoint(comms), exchangeRequest(MPI_REQUEST_NULL),
+                sent(false), received(false)
+        {
+        }
+        ~NeighbourhoodPointPoint();
+
+        void SetNeighbourhood(const std::vector<proc_t>& neighbours);
+
+        void WaitPointToPoint();
+        bool ProgressPointToPoint();
+
+      protected:
+        void ReceivePointToPoint();
+        void SendPointToPoint();
+
+      private:
+        /**
+         * Move the communication with the neighbourhood out of that stored for CoalescePointPoint.
+         */
+        void SeparateNeighbourhoodComms();
+        /**
+         * Once both sends and receives have been asked for, start the exchange.
+         */
+        void StartExchange();
+        /**
+         * Describe the communication with each neighbour, if any, as a datatype, count and
+         * absolute address.
+         */
+        void DescribeExchange(std::map<proc_t, ProcComms>& comms,
+                              std::vector<int>& counts,
+                              std::vector<MPI_Aint>& displacements,
+                              std::vector<MPI_Datatype>& types);
+
+        MpiCommunicator graphComm;
+        std::vector<proc_t> neighbours;
+
+        std::map<proc_t, ProcComms> neighbourhoodSends;
+        std::map<proc_t, ProcComms> neighbourhoodReceives;
+
+        std::vector<int> sendCounts, receiveCounts;
+        std::vector<MPI_Aint> sendDisplacements, receiveDisplacements;
+        std::vector<MPI_Datatype> sendTypes, receiveTypes;
+
+        MPI_Request exchangeRequest;
+        bool sent;
+        bool received;
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,153 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include <cstring>
+#include "net/mixins/pointpoint/PackedPointPoint.h"
+
+namespace hemelb
+{
+  namespace net
+  {
+
+    void PackedPointPoint::EnsureEnoughRequests(size_t count)
+    {
+      if (requests.size() < count)
+      {
+        requests.resize(count, MPI_REQUEST_NULL);
+        statuses.resize(count, MPI_Status());
+      }
+    }
+
+    size_t PackedPointPoint::GetExtent(const SimpleRequest& request)
+    {
+      MPI_Aint lowerBound, extent;
+      MPI_Type_get_extent(request.Type, &lowerBound, &extent);
+      return request.Count * extent;
+    }
+
+    size_t PackedPointPoint::SizeBuffer(const ProcComms& comms, std::vector<char>& buffer)
+    {
+      size_t bytes = 0;
+      for (ProcComms::const_iterator request = comms.begin(); request != comms.end(); ++request)
+      {
+        bytes += GetExtent(*request);
+      }
+      if (buffer.size() < bytes)
+      {
+        buffer.resize(bytes);
+      }
+      return bytes;
+    }
+
+    void PackedPointPoint::ReceivePointToPoint()
+    {
+      EnsureEnoughRequests(receiveProcessorComms.size() + sendProcessorComms.size());
+      proc_t m = 0;
+
+      for (std::map<proc_t, ProcComms>::iterator it = receiveProcessorComms.begin(); it != receiveProcessorComms.end();
+          ++it)
+      {
+        if (it->second.size() == 1)
+        {
+          const SimpleRequest& only = it->second.front();
+          MPI_Irecv(only.Pointer, (int) GetExtent(only), MPI_BYTE, it->first, 10, communicator, &requests[m]);
+        }
+        else
+        {
+          std::vector<char>& buffer = receiveBuffers[it->first];
+          const size_t bytes = SizeBuffer(it->second, buffer);
+          MPI_Irecv(&buffer[0], (int) bytes, MPI_BYTE, it->first, 10, communicator, &requests[m]);
+        }
+        ++m;
+      }
+    }
+
+    void PackedPointPoint::SendPointToPoint()
+    {
+      EnsureEnoughRequests(receiveProcessorComms.size() + sendProcessorComms.size());
+      proc_t m = 0;
+
+      for (std::map<proc_t, ProcComms>::iterator it = sendProcessorComms.begin(); it != sendProcessorComms.end(); ++it)
+      {
+        MPI_Request& request = requests[receiveProcessorComms.size() + m];
+        if (it->second.size() == 1)
+        {
+          const SimpleRequest& only = it->second.front();
+          BytesSent += GetExtent(only); //DTMP:
+          MPI_Isend(only.Pointer, (int) GetExtent(only), MPI_BYTE, it->first, 10, communicator, &request);
+        }
+        else
+        {
+          // Gather everything for this neighbour into its buffer.
+          std::vector<char>& buffer = sendBuffers[it->first];
+          const size_t bytes = SizeBuffer(it->second, buffer);
+          char* packed = &buffer[0];
+          for (ProcComms::iterator part = it->second.begin(); part != it->second.end(); ++part)
+          {
+            const size_t partBytes = GetExtent(*part);
+            std::memcpy(packed, part->Pointer, partBytes);
+            packed += partBytes;
+          }
+          BytesSent += bytes; //DTMP:
+          MPI_Isend(&buffer[0], (int) bytes, MPI_BYTE, it->first, 10, communicator, &request);
+        }
+        ++m;
+      }
+    }
+
+    /*!
+     Free the allocated data.
+     */
+    PackedPointPoint::~PackedPointPoint()
+    {
+    }
+
+    bool PackedPointPoint::ProgressPointToPoint()
+    {
+      if (requests.empty())
+      {
+        return true;
+      }
+
+      // As for CoalescePointPoint, null requests count as complete. Received buffers are only
+      // unpacked in WaitPointToPoint.
+      int complete = 0;
+      MPI_Testall((int) (sendProcessorComms.size() + receiveProcessorComms.size()),
+                  &requests[0],
+                  &complete,
+                  &statuses[0]);
+      return complete;
+    }
+
+    void PackedPointPoint::WaitPointToPoint()
+    {
+      if (!requests.empty())
+      {
+        MPI_Waitall((int) (sendProcessorComms.size() + receiveProcessorComms.size()), &requests[0], &statuses[0]);
+      }
+
+      // Scatter the packed messages to where they were asked for.
+      for (std::map<proc_t, ProcComms>::iterator it = receiveProcessorComms.begin(); it != receiveProcessorComms.end();
+          ++it)
+      {
+        if (it->second.size() == 1)
+        {
+          continue;
+        }
+        const char* packed = &receiveBuffers[it->first][0];
+        for (ProcComms::iterator part = it->second.begin(); part != it->second.end(); ++part)
+        {
+          const size_t partBytes = GetExtent(*part);
+          std::memcpy(part->Pointer, packed, partBytes);
+          packed += partBytes;
+        }
+      }
+
+      receiveProcessorComms.clear();
+      sendProcessorComms.clear();
+    }
+  }
+}
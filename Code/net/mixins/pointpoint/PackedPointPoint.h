@@ -0,0 +1,65 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_NET_MIXINS_POINTPOINT_PACKEDPOINTPOINT_H
+#define HEMELB_NET_MIXINS_POINTPOINT_PACKEDPOINTPOINT_H
+#include "net/BaseNet.h"
+#include "net/mixins/StoringNet.h"
+namespace hemelb
+{
+  namespace net
+  {
+    /**
+     * As CoalescePointPoint, one message per neighbour, but without derived datatypes, which
+     * many MPI implementations handle slowly. Where there is more than one thing to send to a
+     * neighbour, they are copied one after another into a contiguous buffer kept for that
+     * neighbour, and sent as bytes. Received messages are copied out of the same kind of buffer
+     * once they arrive. A single contiguous send or receive, like each neighbour's share of the
+     * LB distributions, goes straight from or to its own memory.
+     *
+     * Every message is sent as bytes, so the two ends need not split it up the same way.
+     */
+    class PackedPointPoint : public virtual StoringNet
+    {
+
+      public:
+        PackedPointPoint(const MpiCommunicator& comms) :
+            BaseNet(comms), StoringNet(comms)
+        {
+        }
+        ~PackedPointPoint();
+
+        void WaitPointToPoint();
+        bool ProgressPointToPoint();
+
+      protected:
+        void ReceivePointToPoint();
+        void SendPointToPoint();
+
+      private:
+        void EnsureEnoughRequests(size_t count);
+
+        /**
+         * The number of bytes between the start and end of the memory of the request.
+         */
+        static size_t GetExtent(const SimpleRequest& request);
+
+        /**
+         * Size the buffer for the given communication and return the size.
+         */
+        static size_t SizeBuffer(const ProcComms& comms, std::vector<char>& buffer);
+
+        // Kept from one step to the next, to save allocating them each time.
+        std::map<proc_t, std::vector<char> > sendBuffers;
+        std::map<proc_t, std::vector<char> > receiveBuffers;
+
+        std::vector<MPI_Request> requests;
+        std::vector<MPI_Status> statuses;
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,212 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "net/mixins/pointpoint/PersistentPointPoint.h"
+
+namespace hemelb
+{
+  namespace net
+  {
+
+    bool PersistentPointPoint::Matches(const PersistentRequests& persistent,
+                                       const std::map<proc_t, ProcComms>& comms)
+    {
+      if (persistent.Comms.size() != comms.size())
+      {
+        return false;
+      }
+
+      for (std::map<proc_t, ProcComms>::const_iterator made = persistent.Comms.begin(), wanted = comms.begin();
+          made != persistent.Comms.end(); ++made, ++wanted)
+      {
+        if (made->first != wanted->first || made->second.size() != wanted->second.size())
+        {
+          return false;
+        }
+        for (ProcComms::const_iterator madeRequest = made->second.begin(), wantedRequest = wanted->second.begin();
+            madeRequest != made->second.end(); ++madeRequest, ++wantedRequest)
+        {
+          if (madeRequest->Pointer != wantedRequest->Pointer || madeRequest->Count != wantedRequest->Count
+              || madeRequest->Type != wantedRequest->Type)
+          {
+            return false;
+          }
+        }
+      }
+      return true;
+    }
+
+    void PersistentPointPoint::Free(PersistentRequests& persistent)
+    {
+      for (std::vector<MPI_Request>::iterator request = persistent.Requests.begin();
+          request != persistent.Requests.end(); ++request)
+      {
+        MPI_Request_free(& (*request));
+      }
+      for (std::map<proc_t, ProcComms>::iterator it = persistent.Comms.begin(); it != persistent.Comms.end(); ++it)
+      {
+        MPI_Type_free(&it->second.Type);
+      }
+      persistent.Comms.clear();
+      persistent.Requests.clear();
+      persistent.Statuses.clear();
+      persistent.Bytes = 0;
+    }
+
+    void PersistentPointPoint::Rebuild(PersistentRequests& persistent,
+                                       const std::map<proc_t, ProcComms>& comms,
+                                       bool send)
+    {
+      Free(persistent);
+      ++requestsBuilt;
+
+      persistent.Comms = comms;
+      persistent.Requests.resize(comms.size(), MPI_REQUEST_NULL);
+      persistent.Statuses.resize(comms.size(), MPI_Status());
+
+      proc_t m = 0;
+      for (std::map<proc_t, ProcComms>::iterator it = persistent.Comms.begin(); it != persistent.Comms.end(); ++it)
+      {
+        it->second.CreateMPIType();
+
+        int typeSize = 0;
+        MPI_Type_size(it->second.Type, &typeSize);
+        persistent.Bytes += typeSize;
+
+        if (send)
+        {
+          MPI_Send_init(it->second.front().Pointer,
+                        1,
+                        it->second.Type,
+                        it->first,
+                        10,
+                        communicator,
+                        &persistent.Requests[m]);
+        }
+        else
+        {
+          MPI_Recv_init(it->second.front().Pointer,
+                        1,
+                        it->second.Type,
+                        it->first,
+                        10,
+                        communicator,
+                        &persistent.Requests[m]);
+        }
+        ++m;
+      }
+    }
+
+    int PersistentPointPoint::Start(std::vector<PersistentRequests>& cache,
+                                    const std::map<proc_t, ProcComms>& comms,
+                                    bool send)
+    {
+      size_t index = 0;
+      while (index < cache.size() && !Matches(cache[index], comms))
+      {
+        ++index;
+      }
+      if (index == cache.size())
+      {
+        if (cache.size() < CACHE_SIZE)
+        {
+          cache.push_back(PersistentRequests());
+        }
+        else
+        {
+          index = 0;
+          for (size_t other = 1; other < cache.size(); ++other)
+          {
+            if (cache[other].LastUsed < cache[index].LastUsed)
+            {
+              index = other;
+            }
+          }
+        }
+        Rebuild(cache[index], comms, send);
+      }
+
+      cache[index].LastUsed = exchanges;
+      MPI_Startall((int) cache[index].Requests.size(), &cache[index].Requests[0]);
+      return (int) index;
+    }
+
+    void PersistentPointPoint::ReceivePointToPoint()
+    {
+      ++exchanges;
+      // Nothing to receive this step: leave the requests for when there is again.
+      if (receiveProcessorComms.empty())
+      {
+        return;
+      }
+      activeReceives = Start(receives, receiveProcessorComms, false);
+    }
+
+    void PersistentPointPoint::SendPointToPoint()
+    {
+      if (sendProcessorComms.empty())
+      {
+        return;
+      }
+      activeSends = Start(sends, sendProcessorComms, true);
+      BytesSent += sends[activeSends].Bytes; //DTMP:
+    }
+
+    /*!
+     Free the allocated data.
+     */
+    PersistentPointPoint::~PersistentPointPoint()
+    {
+      for (size_t index = 0; index < receives.size(); ++index)
+      {
+        Free(receives[index]);
+      }
+      for (size_t index = 0; index < sends.size(); ++index)
+      {
+        Free(sends[index]);
+      }
+    }
+
+    bool PersistentPointPoint::ProgressPointToPoint()
+    {
+      // Requests not started this step, or completed already, count as complete.
+      int receivesComplete = 1;
+      int sendsComplete = 1;
+      if (activeReceives >= 0)
+      {
+        PersistentRequests& active = receives[activeReceives];
+        MPI_Testall((int) active.Requests.size(), &active.Requests[0], &receivesComplete, &active.Statuses[0]);
+      }
+      if (activeSends >= 0)
+      {
+        PersistentRequests& active = sends[activeSends];
+        MPI_Testall((int) active.Requests.size(), &active.Requests[0], &sendsComplete, &active.Statuses[0]);
+      }
+      return receivesComplete && sendsComplete;
+    }
+
+    void PersistentPointPoint::WaitPointToPoint()
+    {
+      if (activeReceives >= 0)
+      {
+        PersistentRequests& active = receives[activeReceives];
+        MPI_Waitall((int) active.Requests.size(), &active.Requests[0], &active.Statuses[0]);
+      }
+      if (activeSends >= 0)
+      {
+        PersistentRequests& active = sends[activeSends];
+        MPI_Waitall((int) active.Requests.size(), &active.Requests[0], &active.Statuses[0]);
+      }
+      activeReceives = -1;
+      activeSends = -1;
+
+      // Unlike the other implementations, keep the datatypes: they belong to the persistent
+      // requests now.
+      receiveProcessorComms.clear();
+      sendProcessorComms.clear();
+    }
+  }
+}
@@ -0,0 +1,109 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_NET_MIXINS_POINTPOINT_PERSISTENTPOINTPOINT_H
+#define HEMELB_NET_MIXINS_POINTPOINT_PERSISTENTPOINTPOINT_H
+#include "net/BaseNet.h"
+#include "net/mixins/StoringNet.h"
+namespace hemelb
+{
+  namespace net
+  {
+    /**
+     * As CoalescePointPoint, one message per neighbour made of everything sent to or received from
+     * it, but with persistent requests. Most of the communication of a step is the same as that
+     * of one of the last few: the same buffers, to and from the same neighbours. When it is, the
+     * requests and datatypes made for it are restarted, rather than being created afresh.
+     *
+     * A few sets of requests are kept for sends and for receives, so that exchanges that take
+     * turns, such as the lattice's halo and the steps of a phased broadcast, each keep their own.
+     * When none matches, the set used least recently is made again for the new communication.
+     */
+    class PersistentPointPoint : public virtual StoringNet
+    {
+
+      public:
+        PersistentPointPoint(const MpiCommunicator& comms) :
+            BaseNet(comms), StoringNet(comms), activeReceives(-1), activeSends(-1), exchanges(0),
+                requestsBuilt(0)
+        {
+        }
+        ~PersistentPointPoint();
+
+        void WaitPointToPoint();
+        bool ProgressPointToPoint();
+
+        /**
+         * The number of times a set of persistent requests has been made, for sends and
+         * receives together.
+         */
+        unsigned long GetPersistentRequestsBuilt() const
+        {
+          return requestsBuilt;
+        }
+
+        //! The number of sets of requests kept for sends, and for receives.
+        static const size_t CACHE_SIZE = 4;
+
+      protected:
+        void ReceivePointToPoint();
+        void SendPointToPoint();
+
+      private:
+        /**
+         * Persistent requests, one per neighbour, and the communication they were made for.
+         */
+        struct PersistentRequests
+        {
+            PersistentRequests() :
+                Bytes(0), LastUsed(0)
+            {
+            }
+
+            std::map<proc_t, ProcComms> Comms;
+            std::vector<MPI_Request> Requests;
+            std::vector<MPI_Status> Statuses;
+            //! Total size of the messages, for the BytesSent count.
+            long long int Bytes;
+            //! The exchange they were last started for.
+            unsigned long LastUsed;
+        };
+
+        /**
+         * Whether the requests were made for exactly the given communication.
+         */
+        static bool Matches(const PersistentRequests& persistent, const std::map<proc_t, ProcComms>& comms);
+
+        /**
+         * Free the requests and their datatypes.
+         */
+        static void Free(PersistentRequests& persistent);
+
+        /**
+         * Replace the requests with new ones for the given communication.
+         */
+        void Rebuild(PersistentRequests& persistent, const std::map<proc_t, ProcComms>& comms, bool send);
+
+        /**
+         * Find the requests made for the given communication in the cache, making them if
+         * there are none, and start them.
+         * @return The index in the cache of the requests started
+         */
+        int Start(std::vector<PersistentRequests>& cache, const std::map<proc_t, ProcComms>& comms, bool send);
+
+        std::vector<PersistentRequests> receives;
+        std::vector<PersistentRequests> sends;
+        //! The requests started in this exchange, or -1 if none.
+        int activeReceives;
+        int activeSends;
+        //! The number of exchanges started, to find the requests used least recently.
+        unsigned long exchanges;
+        unsigned long requestsBuilt;
+    };
+  }
+}
+
+#endif
@@ -0,0 +1,265 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "net/mixins/pointpoint/RuntimePointPoint.h"
+#include "net/BuildInfo.h"
+#include "Exception.h"
+
+namespace hemelb
+{
+  namespace net
+  {
+    RuntimePointPoint::RuntimePointPoint(const MpiCommunicator& comms) :
+        BaseNet(comms), StoringNet(comms), NeighbourhoodPointPoint(comms), SeparatedPointPoint(comms),
+            ImmediatePointPoint(comms), PersistentPointPoint(comms), PackedPointPoint(comms),
+            implementation(Coalesce), tuning(false), autoTuned(false), exchangesPerCandidate(0),
+            exchangesThisCandidate(0), tuningTimes(IMPLEMENTATION_COUNT, 0.0)
+    {
+      SelectPointPoint(default_pointpoint_implementation);
+    }
+
+    const std::string& RuntimePointPoint::GetPointPointName(Implementation implementation)
+    {
+      static const std::string names[IMPLEMENTATION_COUNT] = { "Coalesce",
+                                                               "Separated",
+                                                               "Immediate",
+                                                               "Persistent",
+                                                               "Neighbourhood",
+                                                               "Packed" };
+      return names[implementation];
+    }
+
+    const std::string& RuntimePointPoint::GetPointPointName() const
+    {
+      return GetPointPointName(implementation);
+    }
+
+    void RuntimePointPoint::SelectPointPoint(const std::string& name)
+    {
+      for (int candidate = 0; candidate < IMPLEMENTATION_COUNT; ++candidate)
+      {
+        if (GetPointPointName(Implementation(candidate)) == name)
+        {
+          implementation = Implementation(candidate);
+          tuning = false;
+          autoTuned = false;
+          return;
+        }
+      }
+      throw Exception() << "Unknown point-to-point implementation '" << name << "'";
+    }
+
+    void RuntimePointPoint::AutoTunePointPoint(unsigned exchangesPerImplementation)
+    {
+      implementation = Coalesce;
+      tuning = true;
+      autoTuned = false;
+      exchangesPerCandidate = exchangesPerImplementation;
+      exchangesThisCandidate = 0;
+      tuningTimes.assign(IMPLEMENTATION_COUNT, 0.0);
+    }
+
+    void RuntimePointPoint::CountTuningTime(double start)
+    {
+      if (tuning && exchangesThisCandidate > 0)
+      {
+        tuningTimes[implementation] += MPI_Wtime() - start;
+      }
+    }
+
+    void RuntimePointPoint::EndTuningExchange()
+    {
+      if (++exchangesThisCandidate <= exchangesPerCandidate)
+      {
+        return;
+      }
+
+      // Move on to the next candidate. Immediate blocks in each request, so may deadlock
+      // where the others wouldn't; it is only used if asked for by name.
+      exchangesThisCandidate = 0;
+      do
+      {
+        implementation = Implementation(implementation + 1);
+      }
+      while (implementation == Immediate);
+      if (implementation != IMPLEMENTATION_COUNT)
+      {
+        return;
+      }
+
+      // All tried: judge each by its slowest rank, which the others end up waiting for.
+      std::vector<double> slowest(IMPLEMENTATION_COUNT);
+      HEMELB_MPI_CALL(MPI_Allreduce,
+                      (&tuningTimes[0], &slowest[0], IMPLEMENTATION_COUNT, MPI_DOUBLE, MPI_MAX, communicator));
+      tuningTimes = slowest;
+
+      implementation = Coalesce;
+      for (int candidate = 0; candidate < IMPLEMENTATION_COUNT; ++candidate)
+      {
+        if (candidate != Immediate && tuningTimes[candidate] < tuningTimes[implementation])
+        {
+          implementation = Implementation(candidate);
+        }
+      }
+      tuning = false;
+      autoTuned = true;
+
+      log::Logger::Log<log::Info, log::Singleton>("Point-to-point communication tuned: using %s, %fs over %u exchanges",
+                                                  GetPointPointName().c_str(),
+                                                  tuningTimes[implementation],
+                                                  exchangesPerCandidate);
+    }
+
+    void RuntimePointPoint::SetNeighbourhood(const std::vector<proc_t>& neighbours)
+    {
+      // Collective, so set up whether or not it's going to be used.
+      NeighbourhoodPointPoint::SetNeighbourhood(neighbours);
+    }
+
+    void RuntimePointPoint::RequestSendImpl(void* pointer, int count, proc_t rank, MPI_Datatype type)
+    {
+      if (implementation == Immediate)
+      {
+        ImmediatePointPoint::RequestSendImpl(pointer, count, rank, type);
+      }
+      else
+      {
+        StoringNet::RequestSendImpl(pointer, count, rank, type);
+      }
+    }
+
+    void RuntimePointPoint::RequestReceiveImpl(void* pointer, int count, proc_t rank, MPI_Datatype type)
+    {
+      if (implementation == Immediate)
+      {
+        ImmediatePointPoint::RequestReceiveImpl(pointer, count, rank, type);
+      }
+      else
+      {
+        StoringNet::RequestReceiveImpl(pointer, count, rank, type);
+      }
+    }
+
+    void RuntimePointPoint::ReceivePointToPoint()
+    {
+      const double start = MPI_Wtime();
+      switch (implementation)
+      {
+        case Coalesce:
+          CoalescePointPoint::ReceivePointToPoint();
+          break;
+        case Separated:
+          SeparatedPointPoint::ReceivePointToPoint();
+          break;
+        case Immediate:
+          ImmediatePointPoint::ReceivePointToPoint();
+          break;
+        case Persistent:
+          PersistentPointPoint::ReceivePointToPoint();
+          break;
+        case Neighbourhood:
+          NeighbourhoodPointPoint::ReceivePointToPoint();
+          break;
+        case Packed:
+        default:
+          PackedPointPoint::ReceivePointToPoint();
+          break;
+      }
+      CountTuningTime(start);
+    }
+
+    void RuntimePointPoint::SendPointToPoint()
+    {
+      const double start = MPI_Wtime();
+      switch (implementation)
+      {
+        case Coalesce:
+          CoalescePointPoint::SendPointToPoint();
+          break;
+        case Separated:
+          SeparatedPointPoint::SendPointToPoint();
+          break;
+        case Immediate:
+          ImmediatePointPoint::SendPointToPoint();
+          break;
+        case Persistent:
+          PersistentPointPoint::SendPointToPoint();
+          break;
+        case Neighbourhood:
+          NeighbourhoodPointPoint::SendPointToPoint();
+          break;
+        case Packed:
+        default:
+          PackedPointPoint::SendPointToPoint();
+          break;
+      }
+      CountTuningTime(start);
+    }
+
+    bool RuntimePointPoint::ProgressPointToPoint()
+    {
+      const double start = MPI_Wtime();
+      bool complete;
+      switch (implementation)
+      {
+        case Coalesce:
+          complete = CoalescePointPoint::ProgressPointToPoint();
+          break;
+        case Separated:
+          complete = SeparatedPointPoint::ProgressPointToPoint();
+          break;
+        case Immediate:
+          complete = ImmediatePointPoint::ProgressPointToPoint();
+          break;
+        case Persistent:
+          complete = PersistentPointPoint::ProgressPointToPoint();
+          break;
+        case Neighbourhood:
+          complete = NeighbourhoodPointPoint::ProgressPointToPoint();
+          break;
+        case Packed:
+        default:
+          complete = PackedPointPoint::ProgressPointToPoint();
+          break;
+      }
+      CountTuningTime(start);
+      return complete;
+    }
+
+    void RuntimePointPoint::WaitPointToPoint()
+    {
+      const double start = MPI_Wtime();
+      switch (implementation)
+      {
+        case Coalesce:
+          CoalescePointPoint::WaitPointToPoint();
+          break;
+        case Separated:
+          SeparatedPointPoint::WaitPointToPoint();
+          break;
+        case Immediate:
+          ImmediatePointPoint::WaitPointToPoint();
+          break;
+        case Persistent:
+          PersistentPointPoint::WaitPointToPoint();
+          break;
+        case Neighbourhood:
+          NeighbourhoodPointPoint::WaitPointToPoint();
+          break;
+        case Packed:
+        default:
+          PackedPointPoint::WaitPointToPoint();
+          break;
+      }
+      CountTuningTime(start);
+
+      if (tuning)
+      {
+        EndTuningExchange();
+      }
+    }
+  }
+}
@@ -0,0 +1,119 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_NET_MIXINS_POINTPOINT_RUNTIMEPOINTPOINT_H
+#define HEMELB_NET_MIXINS_POINTPOINT_RUNTIMEPOINTPOINT_H
+#include <string>
+#include "net/mixins/pointpoint/ImmediatePointPoint.h"
+#include "net/mixins/pointpoint/NeighbourhoodPointPoint.h"
+#include "net/mixins/pointpoint/PackedPointPoint.h"
+#include "net/mixins/pointpoint/PersistentPointPoint.h"
+#include "net/mixins/pointpoint/SeparatedPointPoint.h"
+namespace hemelb
+{
+  namespace net
+  {
+    /**
+     * Every point-to-point implementation at once, choosing between them at run time. They
+     * all work on the requests stored by the one StoringNet, so the choice can change between
+     * one exchange and the next.
+     *
+     * The implementation starts as the one set by HEMELB_POINTPOINT_IMPLEMENTATION. It can be
+     * chosen by name, or tuned: each candidate is timed over a number of exchanges, and the one
+     * whose slowest rank took the least time is kept.
+     *
+     * Ranks must agree on the implementation, so every rank must select the same one, or start
+     * tuning, at the same point, and then wait on the Net the same number of times.
+     */
+    class RuntimePointPoint : public NeighbourhoodPointPoint,
+                              public SeparatedPointPoint,
+                              public ImmediatePointPoint,
+                              public PersistentPointPoint,
+                              public PackedPointPoint
+    {
+      public:
+        enum Implementation
+        {
+          Coalesce,
+          Separated,
+          Immediate,
+          Persistent,
+          Neighbourhood,
+          Packed,
+          IMPLEMENTATION_COUNT
+        };
+
+        RuntimePointPoint(const MpiCommunicator& comms);
+
+        /**
+         * Use the implementation with the given name, as for HEMELB_POINTPOINT_IMPLEMENTATION.
+         * @param name
+         */
+        void SelectPointPoint(const std::string& name);
+
+        /**
+         * Time each implementation, except Immediate, over the given number of exchanges, after
+         * one more to let it set up, and then keep the fastest. Collective.
+         * @param exchangesPerImplementation
+         */
+        void AutoTunePointPoint(unsigned exchangesPerImplementation);
+
+        const std::string& GetPointPointName() const;
+
+        bool IsPointPointAutoTuned() const
+        {
+          return autoTuned;
+        }
+
+        /**
+         * The time the slowest rank spent in each implementation while tuning, or zero for those
+         * not tried.
+         */
+        const std::vector<double>& GetPointPointTuningTimes() const
+        {
+          return tuningTimes;
+        }
+
+        static const std::string& GetPointPointName(Implementation implementation);
+
+        void SetNeighbourhood(const std::vector<proc_t>& neighbours);
+
+        void RequestSendImpl(void* pointer, int count, proc_t rank, MPI_Datatype type);
+        void RequestReceiveImpl(void* pointer, int count, proc_t rank, MPI_Datatype type);
+
+        void WaitPointToPoint();
+        bool ProgressPointToPoint();
+
+      protected:
+        void ReceivePointToPoint();
+        void SendPointToPoint();
+
+      private:
+        /**
+         * Count an exchange towards tuning, moving on to the next candidate, or making the
+         * choice, when it has had enough.
+         */
+        void EndTuningExchange();
+
+        /**
+         * Count the time since the given start towards the implementation being tuned, unless
+         * it is still setting up.
+         */
+        void CountTuningTime(double start);
+
+        Implementation implementation;
+
+        bool tuning;
+        bool autoTuned;
+        unsigned exchangesPerCandidate;
+        unsigned exchangesThisCandidate;
+        //! The time this rank has spent in the Net with each implementation while tuning.
+        std::vector<double> tuningTimes;
+    };
+  }
+}
+
+#endif
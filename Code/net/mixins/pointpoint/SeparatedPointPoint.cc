@@ -16,7 +16,7 @@ namespace hemelb
     {
       if (requests.size() < count)
       {
-        requests.resize(count, MPI_Request());
+        requests.resize(count, MPI_REQUEST_NULL);
         statuses.resize(count, MPI_Status());
       }
     }
@@ -101,6 +101,20 @@ namespace hemelb
     {
     }
 
+    bool SeparatedPointPoint::ProgressPointToPoint()
+    {
+      if (!sendReceivePrepped)
+      {
+        return true;
+      }
+
+      // Requests not yet sent are null, which MPI counts as complete, as are those completed
+      // by an earlier call. A later MPI_Waitall on them returns immediately.
+      int complete = 0;
+      MPI_Testall(static_cast<int>(count_sends + count_receives), &requests[0], &complete, &statuses[0]);
+      return complete;
+    }
+
     void SeparatedPointPoint::WaitPointToPoint()
     {
       MPI_Waitall(static_cast<int>(count_sends+count_receives), &requests[0], &statuses[0]);
@@ -24,6 +24,7 @@ namespace hemelb
         ~SeparatedPointPoint();
 
         void WaitPointToPoint();
+        bool ProgressPointToPoint();
 
       protected:
         void ReceivePointToPoint();
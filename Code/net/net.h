@@ -10,24 +10,51 @@
 #include "net/BaseNet.h"
 #include "net/mixins/mixins.h"
 #include "net/BuildInfo.h"
+#include "reporting/Reportable.h"
 namespace hemelb
 {
   namespace net
   {
-    class Net : public PointPointImpl,
+    /**
+     * The Net, with every implementation of each kind of communication compiled in, so that they
+     * can be chosen at run time. Reports the ones in use.
+     */
+    class Net : public RuntimePointPoint,
                 public InterfaceDelegationNet,
-                public AllToAllImpl,
-                public GathersImpl
+                public RuntimeAllToAll,
+                public RuntimeGathers,
+                public reporting::Reportable
     {
       public:
         Net(const MpiCommunicator &communicator) :
-            BaseNet(communicator), StoringNet(communicator), PointPointImpl(communicator),
-                InterfaceDelegationNet(communicator), AllToAllImpl(communicator),
-                GathersImpl(communicator)
+            BaseNet(communicator), StoringNet(communicator), RuntimePointPoint(communicator),
+                InterfaceDelegationNet(communicator), RuntimeAllToAll(communicator),
+                RuntimeGathers(communicator)
         {
         }
+
+        void Report(ctemplate::TemplateDictionary& dictionary)
+        {
+          ctemplate::TemplateDictionary *comms = dictionary.AddSectionDictionary("COMMUNICATIONS");
+          comms->SetValue("POINTPOINT", GetPointPointName());
+          comms->SetValue("GATHERS", GetGathersName());
+          comms->SetValue("ALLTOALL", GetAllToAllName());
+          comms->SetValue("AUTOTUNED", IsPointPointAutoTuned() ? "true" : "false");
+          if (IsPointPointAutoTuned())
+          {
+            for (int candidate = 0; candidate < IMPLEMENTATION_COUNT; ++candidate)
+            {
+              if (candidate == Immediate)
+              {
+                continue;
+              }
+              ctemplate::TemplateDictionary *tried = comms->AddSectionDictionary("CANDIDATE");
+              tried->SetValue("NAME", RuntimePointPoint::GetPointPointName(Implementation(candidate)));
+              tried->SetFormattedValue("TIME", "%.6g", GetPointPointTuningTimes()[candidate]);
+            }
+          }
+        }
     };
   }
 }
 #endif
-
@@ -15,7 +15,7 @@ namespace hemelb
     {
 
       StepManager::StepManager(Phase phases, reporting::Timers *timers, bool separate_concerns) :
-          registry(phases), concerns(), timers(timers), separate_concerns(separate_concerns)
+          registry(phases), concerns(), timers(timers), separate_concerns(separate_concerns), tracer(NULL)
       {
       }
 
@@ -124,6 +124,11 @@ namespace hemelb
         CallActionsForStep(static_cast<steps::Step>(step), 0);
       }
 
+      void StepManager::SetTracer(Tracer * newTracer)
+      {
+        tracer = newTracer;
+      }
+
       void StepManager::CallActionsSeparatedConcerns()
       {
         CallSpecialAction(steps::BeginAll);
@@ -136,17 +141,27 @@ namespace hemelb
 
       void StepManager::CallActions()
       {
+        if (tracer)
+        {
+          tracer->StartStep();
+        }
         if (separate_concerns)
         {
           CallActionsSeparatedConcerns();
-          return;
         }
-        CallSpecialAction(steps::BeginAll);
-        for (Phase phase = 0; phase < registry.size(); phase++)
+        else
         {
-          CallActionsForPhase(phase);
+          CallSpecialAction(steps::BeginAll);
+          for (Phase phase = 0; phase < registry.size(); phase++)
+          {
+            CallActionsForPhase(phase);
+          }
+          CallSpecialAction(steps::EndAll);
+        }
+        if (tracer)
+        {
+          tracer->EndStep();
         }
-        CallSpecialAction(steps::EndAll);
       }
 
       void StepManager::CallActionsForStep(steps::Step step, Phase phase)
@@ -155,7 +170,7 @@ namespace hemelb
         std::vector<Action> &actionsForStep = registry[phase][step];
         for (std::vector<Action>::iterator action = actionsForStep.begin(); action != actionsForStep.end(); action++)
         {
-          action->Call();
+          CallAction(*action, step, phase);
         }
         StopTimer(step);
       }
@@ -168,12 +183,24 @@ namespace hemelb
         {
           if (action->concern == concern)
           {
-            action->Call();
+            CallAction(*action, step, phase);
           }
         }
         StopTimer(step);
       }
 
+      void StepManager::CallAction(Action & action, steps::Step step, Phase phase)
+      {
+        if (tracer && tracer->IsRecording())
+        {
+          const double begin = MPI_Wtime();
+          action.Call();
+          tracer->Record(action.concern, step, phase, begin, MPI_Wtime());
+          return;
+        }
+        action.Call();
+      }
+
       void StepManager::StartTimer(steps::Step step)
       {
         if (!timers)
@@ -14,6 +14,7 @@
 #include "net/IteratedAction.h"
 #include "net/phased/Concern.h"
 #include "net/phased/steps.h"
+#include "net/phased/Tracer.h"
 
 #include "log/Logger.h"
 namespace hemelb
@@ -160,13 +161,21 @@ namespace hemelb
            */
           unsigned int ActionCount() const;
 
+          /***
+           * Record the actions called to a timeline
+           * @param tracer Tracer to record to, or NULL to stop recording. Not owned.
+           */
+          void SetTracer(Tracer * tracer);
+
         private:
           std::vector<Registry> registry; // one registry for each phase
           std::vector<Concern*> concerns; // can't be a set as must be order-stable
           reporting::Timers *timers;
           void StartTimer(steps::Step step);
           void StopTimer(steps::Step step);
+          void CallAction(Action & action, steps::Step step, Phase phase);
           const bool separate_concerns;
+          Tracer *tracer;
 
       };
     }
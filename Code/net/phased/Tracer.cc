@@ -0,0 +1,183 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "net/phased/Tracer.h"
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+#include <sstream>
+#include <typeinfo>
+#ifdef __GNUC__
+#include <cxxabi.h>
+#endif
+#include "net/MpiDataType.h"
+#include "net/MpiFile.h"
+#include "log/Logger.h"
+
+namespace hemelb
+{
+  namespace net
+  {
+    namespace phased
+    {
+      Tracer::Tracer(const MpiCommunicator& comms, const std::string& path, unsigned long firstStep,
+                     unsigned long stepCount, size_t capacity) :
+          comms(comms), path(path), firstStep(firstStep), lastStep(firstStep + stepCount - 1), events(capacity),
+              recorded(0), timeStep(0), recording(false), origin(0)
+      {
+      }
+
+      void Tracer::StartStep()
+      {
+        ++timeStep;
+        if (timeStep == firstStep)
+        {
+          // Line the ranks' clocks up, as well as MPI_Wtime allows, so that their timelines can
+          // be compared.
+          HEMELB_MPI_CALL(MPI_Barrier, (comms));
+          origin = MPI_Wtime();
+          recording = true;
+        }
+      }
+
+      void Tracer::EndStep()
+      {
+        if (timeStep == lastStep)
+        {
+          recording = false;
+          Write();
+        }
+      }
+
+      void Tracer::Finish()
+      {
+        if (recording)
+        {
+          recording = false;
+          Write();
+        }
+        else if (timeStep < firstStep)
+        {
+          log::Logger::Log<log::Warning, log::Singleton>("The run ended at time step %lu, before the timeline was due to start at time step %lu, so no timeline was written",
+                                                         timeStep,
+                                                         firstStep);
+        }
+      }
+
+      std::string Tracer::GetConcernName(const Concern& concern)
+      {
+        const char* mangled = typeid(concern).name();
+#ifdef __GNUC__
+        int status;
+        char* demangled = abi::__cxa_demangle(mangled, NULL, NULL, &status);
+        if (status == 0)
+        {
+          std::string name(demangled);
+          std::free(demangled);
+          return name;
+        }
+#endif
+        return mangled;
+      }
+
+      const char* Tracer::GetStepName(steps::Step step)
+      {
+        switch (step)
+        {
+          case steps::BeginAll:
+            return "BeginAll";
+          case steps::BeginPhase:
+            return "BeginPhase";
+          case steps::Receive:
+            return "Receive";
+          case steps::PreSend:
+            return "PreSend";
+          case steps::Send:
+            return "Send";
+          case steps::PreWait:
+            return "PreWait";
+          case steps::Wait:
+            return "Wait";
+          case steps::EndPhase:
+            return "EndPhase";
+          case steps::EndAll:
+            return "EndAll";
+        }
+        return "Unknown";
+      }
+
+      void Tracer::Write()
+      {
+        const int rank = comms.Rank();
+        const unsigned long kept = recorded < events.size() ?
+          recorded :
+          events.size();
+        if (kept < recorded)
+        {
+          log::Logger::Log<log::Warning, log::OnePerCore>("Timeline kept only the last %lu of %lu events",
+                                                          kept,
+                                                          recorded);
+        }
+
+        // Each rank writes its own chunk of the event array, so that the chunks need only be
+        // put end to end. The process name comes first, so that no chunk is empty.
+        std::ostringstream json;
+        json.setf(std::ios::fixed);
+        json.precision(3);
+        json << (rank == 0 ?
+          "{\"traceEvents\":[\n" :
+          ",\n");
+        json << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank << ",\"args\":{\"name\":\"Rank " << rank
+            << "\"}}";
+
+        std::map<const Concern*, std::string> names;
+        for (unsigned long index = recorded - kept; index < recorded; ++index)
+        {
+          const Event& event = events[index % events.size()];
+          std::map<const Concern*, std::string>::iterator name = names.find(event.concern);
+          if (name == names.end())
+          {
+            name = names.insert(std::make_pair(event.concern, GetConcernName(*event.concern))).first;
+          }
+
+          json << ",\n{\"name\":\"" << name->second << "\",\"cat\":\"" << GetStepName(event.step)
+              << "\",\"ph\":\"X\",\"pid\":" << rank << ",\"tid\":0,\"ts\":" << (event.begin - origin) * 1e6
+              << ",\"dur\":" << (event.end - event.begin) * 1e6 << ",\"args\":{\"step\":" << event.timeStep
+              << ",\"phase\":" << event.phase << "}}";
+        }
+
+        if (rank == comms.Size() - 1)
+        {
+          json << "\n]}\n";
+        }
+
+        const std::string text = json.str();
+        const std::vector<char> chunk(text.begin(), text.end());
+
+        int64_t size = chunk.size();
+        int64_t offset = 0;
+        HEMELB_MPI_CALL(MPI_Exscan, (&size, &offset, 1, MpiDataType<int64_t>(), MPI_SUM, comms));
+        if (rank == 0)
+        {
+          // MPI_Exscan leaves the first rank's result undefined.
+          offset = 0;
+        }
+        const int64_t total = comms.AllReduce(size, MPI_SUM);
+
+        MpiFile file = MpiFile::Open(comms, path, MPI_MODE_WRONLY | MPI_MODE_CREATE);
+        // Cut off anything left from a longer file of the same name.
+        HEMELB_MPI_CALL(MPI_File_set_size, (file, (MPI_Offset) total));
+        file.WriteAt((MPI_Offset) offset, chunk);
+        file.Close();
+
+        log::Logger::Log<log::Info, log::Singleton>("Wrote timeline of time steps %lu to %lu to %s",
+                                                    firstStep,
+                                                    std::min(timeStep, lastStep),
+                                                    path.c_str());
+      }
+    }
+  }
+}
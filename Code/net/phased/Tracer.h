@@ -0,0 +1,134 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_NET_PHASED_TRACER_H
+#define HEMELB_NET_PHASED_TRACER_H
+#include <string>
+#include <vector>
+#include "net/MpiCommunicator.h"
+#include "net/phased/Concern.h"
+#include "net/phased/steps.h"
+
+namespace hemelb
+{
+  namespace net
+  {
+    namespace phased
+    {
+      /***
+       * Records when each action called by a StepManager began and ended, over a window of
+       * time steps, and writes the lot from all ranks to one file in the Chrome trace event
+       * format, which chrome://tracing and Perfetto display as a timeline per rank.
+       *
+       * Events go into a ring buffer allocated up front, which only the thread calling the
+       * actions writes to, so recording an event neither locks nor allocates. If the window
+       * has more events than the buffer holds, the oldest are overwritten.
+       *
+       * Starting the window and writing the file are collective, so every rank must call
+       * StartStep and EndStep for every time step.
+       */
+      class Tracer
+      {
+        public:
+          /***
+           * Construct a tracer
+           * @param comms Communicator of the ranks to trace
+           * @param path File to write the timeline to
+           * @param firstStep Time step at which to start recording, counting from one
+           * @param stepCount Number of time steps to record
+           * @param capacity Number of events to keep on each rank
+           */
+          Tracer(const MpiCommunicator& comms, const std::string& path, unsigned long firstStep,
+                 unsigned long stepCount, size_t capacity = 65536);
+
+          /***
+           * Start the next time step, synchronising the ranks' clocks if it opens the window.
+           */
+          void StartStep();
+
+          /***
+           * End the current time step, writing the timeline if it closes the window.
+           */
+          void EndStep();
+
+          /***
+           * Close the window early, writing what has been recorded of it, if the run stops
+           * before the window ends. Does nothing if the window has already been written.
+           */
+          void Finish();
+
+          /***
+           * Whether actions in the current time step should be recorded
+           */
+          bool IsRecording() const
+          {
+            return recording;
+          }
+
+          /***
+           * Record an action which has been called
+           * @param concern Concern on which the action was called
+           * @param step Step in which it was called
+           * @param phase Phase in which it was called
+           * @param begin MPI_Wtime before the call
+           * @param end MPI_Wtime after the call
+           */
+          void Record(const Concern* concern, steps::Step step, unsigned int phase, double begin, double end)
+          {
+            Event& event = events[recorded % events.size()];
+            event.concern = concern;
+            event.step = step;
+            event.phase = phase;
+            event.timeStep = timeStep;
+            event.begin = begin;
+            event.end = end;
+            ++recorded;
+          }
+
+          /***
+           * Get a readable name for a concern, from its dynamic type
+           * @param concern
+           * @return The name of the concern's class
+           */
+          static std::string GetConcernName(const Concern& concern);
+
+          /***
+           * Get the name of a step
+           * @param step
+           * @return The name of the step
+           */
+          static const char* GetStepName(steps::Step step);
+
+        private:
+          struct Event
+          {
+              const Concern* concern;
+              steps::Step step;
+              unsigned int phase;
+              unsigned long timeStep;
+              double begin;
+              double end;
+          };
+
+          /***
+           * Write the events recorded on all ranks to the file, in one collective write.
+           */
+          void Write();
+
+          MpiCommunicator comms;
+          const std::string path;
+          const unsigned long firstStep;
+          const unsigned long lastStep;
+          std::vector<Event> events;
+          unsigned long recorded; // total ever recorded, so the next event goes at recorded % capacity
+          unsigned long timeStep;
+          bool recording;
+          double origin; // MPI_Wtime on every rank at the start of the window
+      };
+    }
+  }
+}
+#endif //ONCE
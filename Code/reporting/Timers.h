@@ -117,6 +117,10 @@ namespace hemelb
           colloidUpdateCalculations,
           colloidOutput,
           extractionWriting,
+          lbOverlap, //!< Time spent on mid-domain LB before the point-to-point communication completed
+          rebalance, //!< Time spent measuring the load balance and redecomposing the domain during the run
+          checkpoint, //!< Time spent taking, starting and finishing checkpoints, rather than simulating
+          checkpointBackground, //!< Time checkpoints spent being written while the simulation went on
           last
         //!< last, this has to be the last element of the enumeration so it can be used to track cardinality
         };
@@ -221,7 +225,8 @@ namespace hemelb
       "Move Counts Sending", "Move Data Sending", "Populating moves list for decomposition optimisation",
       "Initial geometry reading", "Colloid initialisation", "Colloid position communication",
       "Colloid velocity communication", "Colloid force calculations", "Colloid calculations for updating",
-      "Colloid outputting", "Extraction writing" };
+      "Colloid outputting", "Extraction writing", "LB overlapped with MPI",
+      "Load rebalancing", "Checkpointing", "Checkpoint writing in background" };
   }
 
 }
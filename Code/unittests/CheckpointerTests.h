@@ -0,0 +1,176 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_UNITTESTS_CHECKPOINTERTESTS_H
+#define HEMELB_UNITTESTS_CHECKPOINTERTESTS_H
+
+#include <fstream>
+#include <cppunit/TestFixture.h>
+#include "Checkpointer.h"
+#include "io/formats/checkpoint.h"
+#include "unittests/helpers/FourCubeBasedTestFixture.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    /**
+     * Class to test the writing and reading of checkpoints.
+     */
+    class CheckpointerTests : public helpers::FourCubeBasedTestFixture
+    {
+        CPPUNIT_TEST_SUITE( CheckpointerTests);
+        CPPUNIT_TEST( TestRoundTrip);
+        CPPUNIT_TEST( TestGeometryOrder);
+        CPPUNIT_TEST( TestBackgroundWrite);
+        CPPUNIT_TEST( TestNotACheckpoint);
+        CPPUNIT_TEST_SUITE_END();
+      public:
+        void setUp()
+        {
+          FourCubeBasedTestFixture::setUp();
+          timings = new reporting::Timers(Comms());
+        }
+
+        void tearDown()
+        {
+          delete timings;
+          FourCubeBasedTestFixture::tearDown();
+        }
+
+        void TestRoundTrip()
+        {
+          const Direction numVectors = lb::lattices::D3Q15::NUMVECTORS;
+          std::vector<distribn_t> distributions(latDat->GetLocalFluidSiteCount() * numVectors);
+          for (size_t index = 0; index < distributions.size(); ++index)
+          {
+            distributions[index] = lb::lattices::D3Q15::EQMWEIGHTS[index % numVectors] + 1e-4 * (index % 97);
+          }
+          latDat->SetLocalDistributions(distributions);
+          for (unsigned step = 1; step < 42; ++step)
+          {
+            simState->Increment();
+          }
+
+          Checkpointer checkpointer(Comms(), *latDat, *simState, NULL, *timings);
+          checkpointer.Write("checkpoint.dat");
+
+          // Move on, then go back.
+          std::vector<distribn_t> others(distributions.size(), 0.0);
+          latDat->SetLocalDistributions(others);
+          simState->Increment();
+          checkpointer.Read("checkpoint.dat");
+
+          std::vector<distribn_t> got;
+          latDat->GetLocalDistributions(got);
+          CPPUNIT_ASSERT_EQUAL(distributions.size(), got.size());
+          for (size_t index = 0; index < distributions.size(); ++index)
+          {
+            CPPUNIT_ASSERT_EQUAL(distributions[index], got[index]);
+          }
+          // The run carries on from the step after the checkpoint.
+          CPPUNIT_ASSERT_EQUAL(43lu, simState->GetTimeStep());
+        }
+
+        void TestGeometryOrder()
+        {
+          const Direction numVectors = lb::lattices::D3Q15::NUMVECTORS;
+          std::vector<distribn_t> distributions(latDat->GetLocalFluidSiteCount() * numVectors);
+          for (size_t index = 0; index < distributions.size(); ++index)
+          {
+            distributions[index] = index;
+          }
+          latDat->SetLocalDistributions(distributions);
+
+          Checkpointer checkpointer(Comms(), *latDat, *simState, NULL, *timings);
+          checkpointer.Write("checkpoint.dat");
+
+          // The sites should be block by block, and then site by site within each block, not in
+          // the order they are stored in.
+          std::vector<site_t> localSites;
+          for (site_t blockId = 0; blockId < latDat->GetBlockCount(); ++blockId)
+          {
+            const geometry::Block& block = latDat->GetBlock(blockId);
+            for (site_t site = 0; !block.IsEmpty() && site < latDat->GetSitesPerBlockVolumeUnit(); ++site)
+            {
+              if (!block.SiteIsSolid(site))
+              {
+                localSites.push_back(block.GetLocalContiguousIndexForSite(site));
+              }
+            }
+          }
+          CPPUNIT_ASSERT_EQUAL(latDat->GetLocalFluidSiteCount(), (site_t) localSites.size());
+
+          std::ifstream file("checkpoint.dat", std::ios::binary);
+          file.seekg(hemelb::io::formats::checkpoint::HeaderLength);
+          std::vector<distribn_t> written(distributions.size());
+          file.read(reinterpret_cast<char*>(&written[0]), written.size() * sizeof(distribn_t));
+          CPPUNIT_ASSERT(file.good());
+          for (size_t site = 0; site < localSites.size(); ++site)
+          {
+            for (Direction direction = 0; direction < numVectors; ++direction)
+            {
+              CPPUNIT_ASSERT_EQUAL(distributions[localSites[site] * numVectors + direction],
+                                   written[site * numVectors + direction]);
+            }
+          }
+        }
+
+        void TestBackgroundWrite()
+        {
+          const Direction numVectors = lb::lattices::D3Q15::NUMVECTORS;
+          std::vector<distribn_t> distributions(latDat->GetLocalFluidSiteCount() * numVectors);
+          for (size_t index = 0; index < distributions.size(); ++index)
+          {
+            distributions[index] = lb::lattices::D3Q15::EQMWEIGHTS[index % numVectors] + 1e-4 * (index % 89);
+          }
+          latDat->SetLocalDistributions(distributions);
+
+          Checkpointer checkpointer(Comms(), *latDat, *simState, NULL, *timings);
+          CPPUNIT_ASSERT(!checkpointer.IsWriting());
+          checkpointer.Start("checkpoint.dat");
+          CPPUNIT_ASSERT(checkpointer.IsWriting());
+
+          // The simulation carries on while the checkpoint is written.
+          std::vector<distribn_t> others(distributions.size(), 0.0);
+          latDat->SetLocalDistributions(others);
+          simState->Increment();
+
+          checkpointer.Finish();
+          CPPUNIT_ASSERT(!checkpointer.IsWriting());
+          checkpointer.Read("checkpoint.dat");
+
+          std::vector<distribn_t> got;
+          latDat->GetLocalDistributions(got);
+          CPPUNIT_ASSERT_EQUAL(distributions.size(), got.size());
+          for (size_t index = 0; index < distributions.size(); ++index)
+          {
+            CPPUNIT_ASSERT_EQUAL(distributions[index], got[index]);
+          }
+          CPPUNIT_ASSERT_EQUAL(2lu, simState->GetTimeStep());
+        }
+
+        void TestNotACheckpoint()
+        {
+          std::ofstream notACheckpoint("not_a_checkpoint.dat");
+          for (unsigned line = 0; line < 16; ++line)
+          {
+            notACheckpoint << "Not a checkpoint\n";
+          }
+          notACheckpoint.close();
+
+          Checkpointer checkpointer(Comms(), *latDat, *simState, NULL, *timings);
+          CPPUNIT_ASSERT_THROW(checkpointer.Read("not_a_checkpoint.dat"), Exception);
+        }
+
+      private:
+        reporting::Timers* timings;
+    };
+    CPPUNIT_TEST_SUITE_REGISTRATION( CheckpointerTests);
+  }
+}
+
+#endif // HEMELB_UNITTESTS_CHECKPOINTERTESTS_H
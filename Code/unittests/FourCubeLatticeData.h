@@ -56,9 +56,15 @@ namespace hemelb
          * The plane (x,y,3) is an outlet (boundary 1).
          * The planes (0,y,z), (3,y,z), (x,0,z) and (x,3,z) are all walls.
          *
+         * @param comm
+         * @param sitesPerBlockUnit
+         * @param rankCount The number of ranks to pretend the fluid sites are spread over
+         * @param upperHalfRank The rank to put the sites in the upper half of the cube in z on,
+         * which must be in comm. If not zero, the sites really are split between the ranks.
          * @return
          */
-        static FourCubeLatticeData* Create(const net::IOCommunicator& comm, site_t sitesPerBlockUnit = 6, proc_t rankCount = 1)
+        static FourCubeLatticeData* Create(const net::IOCommunicator& comm, site_t sitesPerBlockUnit = 6,
+                                           proc_t rankCount = 1, proc_t upperHalfRank = 0)
         {
           hemelb::geometry::Geometry readResult(util::Vector3D<site_t>::Ones(),
                                                 sitesPerBlockUnit);
@@ -86,7 +92,9 @@ namespace hemelb
                 hemelb::geometry::GeometrySite& site = block.Sites[index];
 
                 site.isFluid = true;
-                site.targetProcessor = 0;
+                site.targetProcessor = 2 * k > minInd + maxInd ?
+                  upperHalfRank :
+                  0;
 
                 for (Direction direction = 1; direction < lb::lattices::D3Q15::NUMVECTORS; ++direction)
                 {
@@ -154,6 +162,11 @@ namespace hemelb
 
           FourCubeLatticeData* returnable = new FourCubeLatticeData(readResult, comm);
 
+          if (upperHalfRank != 0)
+          {
+            return returnable;
+          }
+
           // First, fiddle with the fluid site count, for tests that require this set.
           returnable->fluidSitesOnEachProcessor.resize(rankCount);
           returnable->fluidSitesOnEachProcessor[0] = sitesAlongCube * sitesAlongCube
@@ -174,6 +187,7 @@ namespace hemelb
           TestSiteData mutableSiteData(siteData[site]);
           mutableSiteData.SetHasWall(direction);
           siteData[site] = geometry::SiteData(mutableSiteData);
+          SetLinkTypes(site);
         }
 
         /***
@@ -184,6 +198,27 @@ namespace hemelb
           TestSiteData mutableSiteData(siteData[site]);
           mutableSiteData.SetHasIolet(direction);
           siteData[site] = geometry::SiteData(mutableSiteData);
+          SetLinkTypes(site);
+        }
+
+        /***
+         Not used in setting up the four cube, but used in other tests to poke changes into the four cube for those tests.
+         The four cube has no links that hit both a wall and an iolet, so this makes the first iolet link of each site hit a
+         wall too.
+         **/
+        void SetWallOnFirstIoletLinks()
+        {
+          for (site_t site = 0; site < GetLocalFluidSiteCount(); ++site)
+          {
+            for (Direction direction = 0; direction < latticeInfo.GetNumVectors(); ++direction)
+            {
+              if (siteData[site].HasIolet(direction))
+              {
+                SetHasWall(site, direction);
+                break;
+              }
+            }
+          }
         }
 
         /***
@@ -223,7 +258,7 @@ namespace hemelb
         {
           for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
           {
-            *GetFOld(site * LatticeType::NUMVECTORS + direction) = fOldIn[direction];
+            *GetFOld(GetDistributionIndex<LatticeType>(site, direction)) = fOldIn[direction];
           }
         }
 
@@ -52,6 +52,10 @@ namespace hemelb
         void TestConstruct()
         {
           CPPUNIT_ASSERT(options);
+          // Simulate, rather than calibrate, unless asked to.
+          CPPUNIT_ASSERT(options->GetCalibrationFile().empty());
+          // And start afresh.
+          CPPUNIT_ASSERT(options->GetRestartFile().empty());
         }
 
       private:
@@ -8,6 +8,7 @@
 #define HEMELB_UNITTESTS_CONFIGURATION_SIMCONFIGTESTS_H
 #include "configuration/SimConfig.h"
 #include "resources/Resource.h"
+#include "util/fileutils.h"
 #include "unittests/helpers/FolderTestFixture.h"
 #include "unittests/helpers/LaddFail.h"
 
@@ -53,6 +54,24 @@ namespace hemelb
             CPPUNIT_ASSERT(!monConfig->doIncompressibilityCheck);
             CPPUNIT_ASSERT(!monConfig->convergenceTerminate);
             CPPUNIT_ASSERT_DOUBLES_EQUAL(0., monConfig->convergenceRelativeTolerance, 1e-6);
+            CPPUNIT_ASSERT_EQUAL(1lu, monConfig->stabilityCheckInterval);
+            CPPUNIT_ASSERT(!monConfig->doTimeline);
+
+            // Likewise for <communications>: leave the choice to the build.
+            const hemelb::configuration::SimConfig::CommunicationsConfig* commsConfig =
+                config->GetCommunicationsConfiguration();
+            CPPUNIT_ASSERT(commsConfig->pointPoint.empty());
+            CPPUNIT_ASSERT(commsConfig->gathers.empty());
+            CPPUNIT_ASSERT(commsConfig->allToAll.empty());
+
+            // And for <decomposition>: decompose once, at the start.
+            CPPUNIT_ASSERT(!config->GetDecompositionConfiguration()->doRebalance);
+            CPPUNIT_ASSERT(config->GetDecompositionConfiguration()->siteWeightsPath.empty());
+            CPPUNIT_ASSERT_EQUAL(std::string("parmetis"), config->GetDecompositionConfiguration()->partitioner);
+            CPPUNIT_ASSERT(config->GetDecompositionConfiguration()->cacheDirectory.empty());
+
+            // And for <checkpoint>: don't.
+            CPPUNIT_ASSERT(!config->GetCheckpointConfiguration()->doCheckpoint);
           }
 
           void Test_0_2_1_Read()
@@ -73,6 +92,33 @@ namespace hemelb
             CPPUNIT_ASSERT_EQUAL(1e-9, monConfig->convergenceRelativeTolerance);
             CPPUNIT_ASSERT_EQUAL(monConfig->convergenceVariable, extraction::OutputField::Velocity);
             CPPUNIT_ASSERT_EQUAL(0.01, monConfig->convergenceReferenceValue); // 1 m/s * (delta_t / delta_x) = 0.01
+            CPPUNIT_ASSERT_EQUAL(10lu, monConfig->stabilityCheckInterval);
+            CPPUNIT_ASSERT(monConfig->doTimeline);
+            CPPUNIT_ASSERT_EQUAL(100lu, monConfig->timelineFirstStep);
+            CPPUNIT_ASSERT_EQUAL(5lu, monConfig->timelineSteps);
+            CPPUNIT_ASSERT_EQUAL(65536lu, monConfig->timelineEvents);
+
+            const hemelb::configuration::SimConfig::CommunicationsConfig* commsConfig =
+                config->GetCommunicationsConfiguration();
+            CPPUNIT_ASSERT_EQUAL(std::string("auto"), commsConfig->pointPoint);
+            CPPUNIT_ASSERT_EQUAL(5u, commsConfig->autoTuneExchanges);
+            CPPUNIT_ASSERT_EQUAL(std::string("ViaPointPoint"), commsConfig->gathers);
+            CPPUNIT_ASSERT(commsConfig->allToAll.empty());
+
+            const hemelb::configuration::SimConfig::DecompositionConfig* decompositionConfig =
+                config->GetDecompositionConfiguration();
+            CPPUNIT_ASSERT(decompositionConfig->doRebalance);
+            CPPUNIT_ASSERT_EQUAL(500lu, decompositionConfig->rebalanceInterval);
+            CPPUNIT_ASSERT_DOUBLES_EQUAL(1.2, decompositionConfig->rebalanceThreshold, 1e-12);
+            // Relative to the config file, as the geometry file is.
+            CPPUNIT_ASSERT_EQUAL(util::NormalizePathRelativeToPath("weights.txt", Resource("config.xml").Path()),
+                                 decompositionConfig->siteWeightsPath);
+            CPPUNIT_ASSERT_EQUAL(std::string("hilbert"), decompositionConfig->partitioner);
+            CPPUNIT_ASSERT_EQUAL(util::NormalizePathRelativeToPath("decompositions", Resource("config.xml").Path()),
+                                 decompositionConfig->cacheDirectory);
+
+            CPPUNIT_ASSERT(config->GetCheckpointConfiguration()->doCheckpoint);
+            CPPUNIT_ASSERT_EQUAL(1000lu, config->GetCheckpointConfiguration()->interval);
           }
 
           void TestXMLFileContent()
@@ -0,0 +1,87 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_UNITTESTS_GEOMETRY_DEEPHALOTESTS_H
+#define HEMELB_UNITTESTS_GEOMETRY_DEEPHALOTESTS_H
+
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include "geometry/DeepHalo.h"
+#include "lb/lattices/D3Q15.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace geometry
+    {
+      using namespace hemelb::geometry;
+
+      /**
+       * Check how far around the sites on a rank the deep halo reaches.
+       */
+      class DeepHaloTests : public CppUnit::TestFixture
+      {
+          CPPUNIT_TEST_SUITE ( DeepHaloTests);
+          CPPUNIT_TEST ( TestGetBlockHaloWidth);
+          CPPUNIT_TEST ( TestFindHaloLayers);
+          CPPUNIT_TEST_SUITE_END();
+
+        public:
+          void TestGetBlockHaloWidth()
+          {
+            CPPUNIT_ASSERT_EQUAL((site_t) 1, halo::GetBlockHaloWidth(1, 8));
+            CPPUNIT_ASSERT_EQUAL((site_t) 1, halo::GetBlockHaloWidth(8, 8));
+            CPPUNIT_ASSERT_EQUAL((site_t) 2, halo::GetBlockHaloWidth(9, 8));
+            CPPUNIT_ASSERT_EQUAL((site_t) 3, halo::GetBlockHaloWidth(3, 1));
+          }
+
+          void TestFindHaloLayers()
+          {
+            // A single all-fluid block, with the sites with x < 4 on rank 0 and the rest on
+            // rank 1.
+            const site_t blockSize = 8;
+            Geometry geometry(util::Vector3D<site_t>::Ones(), blockSize);
+            std::vector<util::Vector3D<site_t> > edgeSites;
+            for (site_t i = 0; i < blockSize; ++i)
+            {
+              for (site_t j = 0; j < blockSize; ++j)
+              {
+                for (site_t k = 0; k < blockSize; ++k)
+                {
+                  GeometrySite site(true);
+                  site.targetProcessor = i < 4 ? 0 : 1;
+                  geometry.Blocks[0].Sites.push_back(site);
+
+                  if (i == 3)
+                  {
+                    edgeSites.push_back(util::Vector3D<site_t>(i, j, k));
+                  }
+                }
+              }
+            }
+
+            const std::vector<std::vector<util::Vector3D<site_t> > > layers =
+                halo::FindHaloLayers(geometry, lb::lattices::D3Q15::GetLatticeInfo(), 0, edgeSites, 2);
+
+            CPPUNIT_ASSERT_EQUAL((size_t) 2, layers.size());
+            for (unsigned layer = 0; layer < 2; ++layer)
+            {
+              CPPUNIT_ASSERT_EQUAL((size_t) (blockSize * blockSize), layers[layer].size());
+              for (std::vector<util::Vector3D<site_t> >::const_iterator it = layers[layer].begin();
+                  it != layers[layer].end(); ++it)
+              {
+                CPPUNIT_ASSERT_EQUAL((site_t) (4 + layer), it->x);
+              }
+            }
+          }
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION ( DeepHaloTests);
+    }
+  }
+}
+
+#endif /* HEMELB_UNITTESTS_GEOMETRY_DEEPHALOTESTS_H */
@@ -0,0 +1,140 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_UNITTESTS_GEOMETRY_DENSEBLOCKSTESTS_H
+#define HEMELB_UNITTESTS_GEOMETRY_DENSEBLOCKSTESTS_H
+
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include "geometry/DenseBlocks.h"
+#include "lb/lattices/D3Q15.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace geometry
+    {
+      using namespace hemelb::geometry;
+
+      /**
+       * Check the numbering of dense blocks and the implicit neighbour addressing within them.
+       */
+      class DenseBlocksTests : public CppUnit::TestFixture
+      {
+          CPPUNIT_TEST_SUITE ( DenseBlocksTests);
+          CPPUNIT_TEST ( TestOrderDenseBlockSitesFirst);
+          CPPUNIT_TEST ( TestIsInteriorSite);
+          CPPUNIT_TEST ( TestIsInteriorRow);
+          CPPUNIT_TEST ( TestNumberTableRows);
+          CPPUNIT_TEST ( TestNeighbourOffset);
+          CPPUNIT_TEST_SUITE_END();
+
+        public:
+          void TestOrderDenseBlockSitesFirst()
+          {
+            // Two sites of block 3, then all four sites of block 5 and of block 1, out of
+            // order.
+            const site_t blocks[] = { 3, 5, 1, 5, 3, 1, 1, 5, 5, 1 };
+            const site_t sites[] = { 0, 2, 3, 0, 1, 0, 1, 1, 3, 2 };
+            const std::vector<site_t> blockNumbers(blocks, blocks + 10);
+            const std::vector<site_t> siteNumbers(sites, sites + 10);
+
+            std::vector<site_t> order;
+            for (site_t index = 0; index < 10; ++index)
+            {
+              order.push_back(index);
+            }
+
+            CPPUNIT_ASSERT_EQUAL((site_t) 8,
+                                 denseblocks::OrderDenseBlockSitesFirst(order, blockNumbers, siteNumbers, 4));
+
+            const site_t expected[] = { 5, 6, 9, 2, 3, 7, 1, 8, 0, 4 };
+            for (site_t index = 0; index < 10; ++index)
+            {
+              CPPUNIT_ASSERT_EQUAL(expected[index], order[index]);
+            }
+          }
+
+          void TestIsInteriorSite()
+          {
+            const site_t blockSize = 4;
+            site_t interiorCount = 0;
+            for (site_t localSiteId = 0; localSiteId < blockSize * blockSize * blockSize; ++localSiteId)
+            {
+              if (denseblocks::IsInteriorSite(localSiteId, blockSize))
+              {
+                ++interiorCount;
+              }
+            }
+            CPPUNIT_ASSERT_EQUAL((site_t) 8, interiorCount);
+
+            CPPUNIT_ASSERT(denseblocks::IsInteriorSite( (1 * blockSize + 2) * blockSize + 1, blockSize));
+            CPPUNIT_ASSERT(!denseblocks::IsInteriorSite( (1 * blockSize + 3) * blockSize + 1, blockSize));
+            CPPUNIT_ASSERT(!denseblocks::IsInteriorSite( (0 * blockSize + 1) * blockSize + 1, blockSize));
+          }
+
+          void TestIsInteriorRow()
+          {
+            const site_t blockSize = 4;
+            for (site_t rowStart = 0; rowStart < blockSize * blockSize * blockSize; rowStart += blockSize)
+            {
+              CPPUNIT_ASSERT_EQUAL(denseblocks::IsInteriorSite(rowStart + 1, blockSize),
+                                   denseblocks::IsInteriorRow(rowStart, blockSize));
+              CPPUNIT_ASSERT_EQUAL(denseblocks::IsInteriorSite(rowStart + 2, blockSize),
+                                   denseblocks::IsInteriorRow(rowStart, blockSize));
+            }
+            CPPUNIT_ASSERT(denseblocks::IsInteriorRow( (1 * blockSize + 2) * blockSize, blockSize));
+            CPPUNIT_ASSERT(!denseblocks::IsInteriorRow( (0 * blockSize + 2) * blockSize, blockSize));
+          }
+
+          void TestNumberTableRows()
+          {
+            const site_t blockSize = 4;
+            std::vector<site_t> tableRows;
+            CPPUNIT_ASSERT_EQUAL((site_t) (64 - 8), denseblocks::NumberTableRows(blockSize, tableRows));
+            CPPUNIT_ASSERT_EQUAL((size_t) 64, tableRows.size());
+
+            site_t nextRow = 0;
+            for (site_t localSiteId = 0; localSiteId < 64; ++localSiteId)
+            {
+              if (denseblocks::IsInteriorSite(localSiteId, blockSize))
+              {
+                CPPUNIT_ASSERT_EQUAL((site_t) -1, tableRows[localSiteId]);
+              }
+              else
+              {
+                CPPUNIT_ASSERT_EQUAL(nextRow++, tableRows[localSiteId]);
+              }
+            }
+          }
+
+          void TestNeighbourOffset()
+          {
+            typedef lb::lattices::D3Q15 Lattice;
+            const site_t blockSize = 8;
+            const site_t centre = (3 * blockSize + 4) * blockSize + 5;
+
+            for (Direction direction = 0; direction < Lattice::NUMVECTORS; ++direction)
+            {
+              const site_t neighbour = ( (3 + Lattice::CX[direction]) * blockSize + 4 + Lattice::CY[direction])
+                  * blockSize + 5 + Lattice::CZ[direction];
+              CPPUNIT_ASSERT_EQUAL(neighbour,
+                                   centre + denseblocks::GetNeighbourOffset<Lattice>(direction, blockSize));
+              CPPUNIT_ASSERT_EQUAL(denseblocks::GetNeighbourOffset<Lattice>(direction, blockSize),
+                                   denseblocks::GetNeighbourOffset(util::Vector3D<int>(Lattice::CX[direction],
+                                                                                       Lattice::CY[direction],
+                                                                                       Lattice::CZ[direction]),
+                                                                   blockSize));
+            }
+          }
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION ( DenseBlocksTests);
+    }
+  }
+}
+
+#endif /* HEMELB_UNITTESTS_GEOMETRY_DENSEBLOCKSTESTS_H */
@@ -0,0 +1,142 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_UNITTESTS_GEOMETRY_DISTRIBUTIONLAYOUTTESTS_H
+#define HEMELB_UNITTESTS_GEOMETRY_DISTRIBUTIONLAYOUTTESTS_H
+
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include "geometry/DistributionLayout.h"
+#include "lb/lattices/D3Q15.h"
+#include "lb/lattices/D3Q19.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace geometry
+    {
+      using namespace hemelb::geometry;
+
+      /**
+       * Check that every layout maps each (site, direction) pair to a distinct index within
+       * the allocated part of the distribution array.
+       */
+      class DistributionLayoutTests : public CppUnit::TestFixture
+      {
+          CPPUNIT_TEST_SUITE ( DistributionLayoutTests);
+          CPPUNIT_TEST ( TestAOS);
+          CPPUNIT_TEST ( TestSOA);
+          CPPUNIT_TEST ( TestAOSOA);
+          CPPUNIT_TEST ( TestAOSOAPadding);
+          CPPUNIT_TEST ( TestContiguousSites);
+          CPPUNIT_TEST_SUITE_END();
+
+        public:
+          void TestAOS()
+          {
+            CheckBijective<layouts::AOS, lb::lattices::D3Q15>(37);
+
+            // This must stay the original HemeLB layout.
+            CPPUNIT_ASSERT_EQUAL(site_t(3 * 15 + 4), layouts::AOS::GetIndex(3, 4, 15, 37));
+          }
+
+          void TestSOA()
+          {
+            CheckBijective<layouts::SOA, lb::lattices::D3Q15>(37);
+            CheckBijective<layouts::SOA, lb::lattices::D3Q19>(37);
+
+            CPPUNIT_ASSERT_EQUAL(site_t(4 * 37 + 3), layouts::SOA::GetIndex(3, 4, 15, 37));
+          }
+
+          void TestAOSOA()
+          {
+            CheckBijective<layouts::AOSOA, lb::lattices::D3Q15>(37);
+            CheckBijective<layouts::AOSOA, lb::lattices::D3Q19>(2 * layouts::AOSOA::BLOCK_SIZE);
+
+            // Neighbouring sites in one direction are adjacent in memory within a block.
+            CPPUNIT_ASSERT_EQUAL(layouts::AOSOA::GetIndex(0, 5, 15, 37) + 1,
+                                 layouts::AOSOA::GetIndex(1, 5, 15, 37));
+          }
+
+          void TestAOSOAPadding()
+          {
+            const site_t block = layouts::AOSOA::BLOCK_SIZE;
+            CPPUNIT_ASSERT_EQUAL(site_t(0), layouts::AOSOA::GetAllocatedSiteCount(0));
+            CPPUNIT_ASSERT_EQUAL(block, layouts::AOSOA::GetAllocatedSiteCount(1));
+            CPPUNIT_ASSERT_EQUAL(block, layouts::AOSOA::GetAllocatedSiteCount(block));
+            CPPUNIT_ASSERT_EQUAL(2 * block, layouts::AOSOA::GetAllocatedSiteCount(block + 1));
+          }
+
+          void TestContiguousSites()
+          {
+            CheckContiguousSites<layouts::AOS>(37);
+            CheckContiguousSites<layouts::SOA>(37);
+            CheckContiguousSites<layouts::AOSOA>(37);
+
+            CPPUNIT_ASSERT(!layouts::AOS::AreSitesContiguous(0, 2));
+            CPPUNIT_ASSERT(layouts::SOA::AreSitesContiguous(3, 4));
+            CPPUNIT_ASSERT(layouts::AOSOA::AreSitesContiguous(0, layouts::AOSOA::BLOCK_SIZE));
+            CPPUNIT_ASSERT(!layouts::AOSOA::AreSitesContiguous(1, layouts::AOSOA::BLOCK_SIZE));
+          }
+
+        private:
+          /**
+           * Check that whenever a layout says a run of sites is contiguous, each direction's
+           * distributions for those sites really are adjacent.
+           */
+          template<typename Layout>
+          void CheckContiguousSites(const site_t siteCount)
+          {
+            const site_t allocated = Layout::GetAllocatedSiteCount(siteCount);
+
+            for (site_t site = 0; site < siteCount; ++site)
+            {
+              for (site_t count = 1; site + count <= siteCount; ++count)
+              {
+                if (!Layout::AreSitesContiguous(site, count))
+                {
+                  continue;
+                }
+                for (Direction direction = 0; direction < 15; ++direction)
+                {
+                  CPPUNIT_ASSERT_EQUAL(Layout::GetIndex(site, direction, 15, allocated) + count - 1,
+                                       Layout::GetIndex(site + count - 1, direction, 15, allocated));
+                }
+              }
+            }
+          }
+
+          template<typename Layout, typename LatticeType>
+          void CheckBijective(const site_t siteCount)
+          {
+            const site_t allocated = Layout::GetAllocatedSiteCount(siteCount);
+            CPPUNIT_ASSERT(allocated >= siteCount);
+
+            std::vector<bool> used(allocated * LatticeType::NUMVECTORS, false);
+
+            for (site_t site = 0; site < siteCount; ++site)
+            {
+              for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+              {
+                const site_t index = Layout::GetIndex(site,
+                                                      direction,
+                                                      LatticeType::NUMVECTORS,
+                                                      allocated);
+                CPPUNIT_ASSERT(index >= 0);
+                CPPUNIT_ASSERT(index < allocated * (site_t) LatticeType::NUMVECTORS);
+                CPPUNIT_ASSERT(!used[index]);
+                used[index] = true;
+              }
+            }
+          }
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION ( DistributionLayoutTests);
+    }
+  }
+}
+
+#endif /* HEMELB_UNITTESTS_GEOMETRY_DISTRIBUTIONLAYOUTTESTS_H */
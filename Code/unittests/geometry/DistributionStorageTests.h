@@ -0,0 +1,88 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_UNITTESTS_GEOMETRY_DISTRIBUTIONSTORAGETESTS_H
+#define HEMELB_UNITTESTS_GEOMETRY_DISTRIBUTIONSTORAGETESTS_H
+
+#include <cmath>
+#include <cppunit/TestFixture.h>
+#include "geometry/DistributionStorage.h"
+#include "lb/lattices/D3Q19.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace geometry
+    {
+      using namespace hemelb::geometry;
+
+      /**
+       * Check that distributions survive being stored and read back in each precision.
+       */
+      class DistributionStorageTests : public CppUnit::TestFixture
+      {
+          CPPUNIT_TEST_SUITE ( DistributionStorageTests);
+          CPPUNIT_TEST ( TestDouble);
+          CPPUNIT_TEST ( TestSingle);
+          CPPUNIT_TEST ( TestMixed);
+          CPPUNIT_TEST_SUITE_END();
+
+        public:
+          void TestDouble()
+          {
+            for (Direction direction = 0; direction < lb::lattices::D3Q19::NUMVECTORS; ++direction)
+            {
+              const distribn_t f = NearEquilibrium(direction);
+              CPPUNIT_ASSERT_EQUAL(f, RoundTrip<storages::DOUBLE>(f, direction));
+            }
+          }
+
+          void TestSingle()
+          {
+            for (Direction direction = 0; direction < lb::lattices::D3Q19::NUMVECTORS; ++direction)
+            {
+              const distribn_t f = NearEquilibrium(direction);
+              CPPUNIT_ASSERT_DOUBLES_EQUAL(f, RoundTrip<storages::SINGLE>(f, direction), 1e-7 * f);
+            }
+          }
+
+          void TestMixed()
+          {
+            for (Direction direction = 0; direction < lb::lattices::D3Q19::NUMVECTORS; ++direction)
+            {
+              const distribn_t f = NearEquilibrium(direction);
+              const distribn_t mixedError = std::fabs(RoundTrip<storages::MIXED>(f, direction) - f);
+              const distribn_t singleError = std::fabs(RoundTrip<storages::SINGLE>(f, direction) - f);
+
+              // Only the small deviation from the reference equilibrium is rounded.
+              CPPUNIT_ASSERT(mixedError <= singleError);
+              CPPUNIT_ASSERT_DOUBLES_EQUAL(f, RoundTrip<storages::MIXED>(f, direction), 1e-8 * f);
+            }
+          }
+
+        private:
+          /**
+           * A distribution a little off the equilibrium at rest, as in a slow flow.
+           */
+          static distribn_t NearEquilibrium(const Direction direction)
+          {
+            return lb::lattices::D3Q19::EQMWEIGHTS[direction] * (1.0 + 1.2345678901e-3 * (direction + 1));
+          }
+
+          template<typename Storage>
+          static distribn_t RoundTrip(const distribn_t value, const Direction direction)
+          {
+            const distribn_t weight = lb::lattices::D3Q19::EQMWEIGHTS[direction];
+            return Storage::Decode(Storage::Encode(value, weight), weight);
+          }
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION ( DistributionStorageTests);
+    }
+  }
+}
+
+#endif /* HEMELB_UNITTESTS_GEOMETRY_DISTRIBUTIONSTORAGETESTS_H */
@@ -23,6 +23,8 @@ namespace hemelb
           CPPUNIT_TEST ( TestConstruct);
           CPPUNIT_TEST ( TestConvertGlobalId);
           CPPUNIT_TEST ( TestGetProcFromGlobalId);
+          CPPUNIT_TEST ( TestLinksByType);
+          CPPUNIT_TEST ( TestLocalDistributions);
 
           CPPUNIT_TEST_SUITE_END();
 
@@ -68,6 +70,58 @@ namespace hemelb
             CPPUNIT_ASSERT_EQUAL(latDat->ProcProvidingSiteByGlobalNoncontiguousId(43), 0);
           }
 
+          void TestLinksByType()
+          {
+            latDat->SetWallOnFirstIoletLinks();
+            site_t sitesWithWallAndIoletLinks = 0;
+
+            for (site_t siteIndex = 0; siteIndex < latDat->GetLocalFluidSiteCount(); ++siteIndex)
+            {
+              const Site<LatticeData> site = latDat->GetSite(siteIndex);
+              const uint8_t* links = site.GetLinksByType();
+              std::vector<bool> seen(lb::lattices::D3Q15::NUMVECTORS, false);
+
+              for (Direction link = 0; link < lb::lattices::D3Q15::NUMVECTORS; ++link)
+              {
+                const Direction direction = links[link];
+                CPPUNIT_ASSERT(direction < lb::lattices::D3Q15::NUMVECTORS);
+                CPPUNIT_ASSERT(!seen[direction]);
+                seen[direction] = true;
+
+                // The streamers rely on these ranges to pick the delegate for each link.
+                CPPUNIT_ASSERT_EQUAL(link >= site.GetIoletLinksBegin(), site.HasIolet(direction));
+                CPPUNIT_ASSERT_EQUAL(link >= site.GetWallLinksBegin() && link < site.GetWallLinksEnd(),
+                                     site.HasWall(direction));
+              }
+
+              if (site.GetIoletLinksBegin() < site.GetWallLinksEnd())
+              {
+                ++sitesWithWallAndIoletLinks;
+              }
+            }
+
+            CPPUNIT_ASSERT(sitesWithWallAndIoletLinks > 0);
+          }
+
+          void TestLocalDistributions()
+          {
+            const Direction numVectors = lb::lattices::D3Q15::NUMVECTORS;
+            std::vector<distribn_t> distributions(latDat->GetLocalFluidSiteCount() * numVectors);
+            for (size_t index = 0; index < distributions.size(); ++index)
+            {
+              distributions[index] = lb::lattices::D3Q15::EQMWEIGHTS[index % numVectors] + 1e-4 * (index % 97);
+            }
+            latDat->SetLocalDistributions(distributions);
+
+            std::vector<distribn_t> got;
+            latDat->GetLocalDistributions(got);
+            CPPUNIT_ASSERT_EQUAL(distributions.size(), got.size());
+            for (size_t index = 0; index < distributions.size(); ++index)
+            {
+              CPPUNIT_ASSERT_DOUBLES_EQUAL(distributions[index], got[index], 1e-6);
+            }
+          }
+
         private:
       };
       CPPUNIT_TEST_SUITE_REGISTRATION ( NeighbouringLatticeDataTests);
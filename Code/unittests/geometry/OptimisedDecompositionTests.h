@@ -0,0 +1,153 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_UNITTESTS_GEOMETRY_OPTIMISEDDECOMPOSITIONTESTS_H
+#define HEMELB_UNITTESTS_GEOMETRY_OPTIMISEDDECOMPOSITIONTESTS_H
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include "geometry/decomposition/OptimisedDecomposition.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace geometry
+    {
+      using hemelb::geometry::decomposition::OptimisedDecomposition;
+
+      /**
+       * Test the cutting of the Hilbert curve into pieces for the ranks, for more ranks than
+       * the tests run on.
+       */
+      class OptimisedDecompositionTests : public CppUnit::TestFixture
+      {
+          CPPUNIT_TEST_SUITE ( OptimisedDecompositionTests);
+          CPPUNIT_TEST ( TestApplyCostFactor);
+          CPPUNIT_TEST ( TestCutEvenWeights);
+          CPPUNIT_TEST ( TestCutUnevenWeights);
+          CPPUNIT_TEST ( TestCutInRuns);
+          CPPUNIT_TEST_SUITE_END();
+
+        public:
+          void TestApplyCostFactor()
+          {
+            CPPUNIT_ASSERT_EQUAL(16 * 3, OptimisedDecomposition::ApplyCostFactor(3, 1.0f));
+            CPPUNIT_ASSERT_EQUAL(16 * 3 * 2, OptimisedDecomposition::ApplyCostFactor(3, 2.0f));
+            CPPUNIT_ASSERT_EQUAL(6, OptimisedDecomposition::ApplyCostFactor(3, 0.125f));
+            // No site is ever free.
+            CPPUNIT_ASSERT_EQUAL(1, OptimisedDecomposition::ApplyCostFactor(3, 0.0f));
+          }
+
+          void TestCutEvenWeights()
+          {
+            std::vector<int64_t> weights(12, 5);
+            std::vector<proc_t> ranks;
+            OptimisedDecomposition::CutAlongCurve(weights, 0, 60, 4, ranks);
+
+            CPPUNIT_ASSERT_EQUAL(weights.size(), ranks.size());
+            for (size_t item = 0; item < ranks.size(); ++item)
+            {
+              CPPUNIT_ASSERT_EQUAL((proc_t) (item / 3), ranks[item]);
+            }
+          }
+
+          void TestCutUnevenWeights()
+          {
+            std::vector<int64_t> weights;
+            const int64_t totalWeight = MakeUnevenWeights(weights);
+            const int64_t heaviest = *std::max_element(weights.begin(), weights.end());
+
+            for (proc_t rankCount = 1; rankCount <= 7; ++rankCount)
+            {
+              std::vector<proc_t> ranks;
+              OptimisedDecomposition::CutAlongCurve(weights, 0, totalWeight, rankCount, ranks);
+
+              // Each rank gets one piece of the curve, and every piece is within an item of an
+              // even share of the weight.
+              std::vector<int64_t> rankWeights(rankCount, 0);
+              for (size_t item = 0; item < ranks.size(); ++item)
+              {
+                CPPUNIT_ASSERT(ranks[item] >= 0 && ranks[item] < rankCount);
+                if (item > 0)
+                {
+                  CPPUNIT_ASSERT(ranks[item] == ranks[item - 1] || ranks[item] == ranks[item - 1] + 1);
+                }
+                rankWeights[ranks[item]] += weights[item];
+              }
+              CPPUNIT_ASSERT_EQUAL((proc_t) 0, ranks.front());
+              CPPUNIT_ASSERT_EQUAL(rankCount - 1, ranks.back());
+              for (proc_t rank = 0; rank < rankCount; ++rank)
+              {
+                CPPUNIT_ASSERT(rankWeights[rank] > 0);
+                CPPUNIT_ASSERT(std::abs(rankWeights[rank] * rankCount - totalWeight) <= heaviest * rankCount);
+              }
+            }
+          }
+
+          void TestCutInRuns()
+          {
+            // The ranks cut the curve a block at a time, given the weight before each block, and
+            // that must come to the same as cutting it all at once.
+            std::vector<int64_t> weights;
+            const int64_t totalWeight = MakeUnevenWeights(weights);
+            const proc_t rankCount = 5;
+
+            std::vector<proc_t> wholeRanks;
+            OptimisedDecomposition::CutAlongCurve(weights, 0, totalWeight, rankCount, wholeRanks);
+
+            int64_t weightBefore = 0;
+            for (size_t begin = 0; begin < weights.size(); begin += 7)
+            {
+              const size_t end = std::min(weights.size(), begin + 7);
+              std::vector<int64_t> run(weights.begin() + begin, weights.begin() + end);
+              std::vector<proc_t> runRanks;
+              OptimisedDecomposition::CutAlongCurve(run, weightBefore, totalWeight, rankCount, runRanks);
+
+              for (size_t item = begin; item < end; ++item)
+              {
+                CPPUNIT_ASSERT_EQUAL(wholeRanks[item], runRanks[item - begin]);
+                weightBefore += weights[item];
+              }
+            }
+          }
+
+        private:
+          /**
+           * Make the weights of the sites of some blocks along a curve, with different weights
+           * for different collision types and different cost factors for the blocks.
+           * @param weights
+           * @return The total weight
+           */
+          int64_t MakeUnevenWeights(std::vector<int64_t>& weights)
+          {
+            const int typeWeights[] = { 1, 3, 8 };
+            const float costFactors[] = { 1.0f, 4.0f, 0.25f, 1.5f, 0.5f };
+            const int sitesPerBlock = 12;
+
+            weights.clear();
+            int64_t totalWeight = 0;
+            for (int block = 0; block < 5; ++block)
+            {
+              for (int site = 0; site < sitesPerBlock; ++site)
+              {
+                const int typeWeight = typeWeights[ (site * site + block) % 3];
+                weights.push_back(OptimisedDecomposition::ApplyCostFactor(typeWeight, costFactors[block]));
+                totalWeight += weights.back();
+              }
+            }
+            return totalWeight;
+          }
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION ( OptimisedDecompositionTests);
+    }
+  }
+}
+
+#endif /* HEMELB_UNITTESTS_GEOMETRY_OPTIMISEDDECOMPOSITIONTESTS_H */
@@ -0,0 +1,95 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_UNITTESTS_GEOMETRY_SITEORDERINGTESTS_H
+#define HEMELB_UNITTESTS_GEOMETRY_SITEORDERINGTESTS_H
+
+#include <cstdlib>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include "geometry/SiteOrdering.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace geometry
+    {
+      using namespace hemelb::geometry;
+
+      /**
+       * Check that the space-filling curves used to order sites visit every site of a cube
+       * exactly once, and in the expected order.
+       */
+      class SiteOrderingTests : public CppUnit::TestFixture
+      {
+          CPPUNIT_TEST_SUITE ( SiteOrderingTests);
+          CPPUNIT_TEST ( TestMorton);
+          CPPUNIT_TEST ( TestHilbert);
+          CPPUNIT_TEST_SUITE_END();
+
+        public:
+          void TestMorton()
+          {
+            CPPUNIT_ASSERT_EQUAL((uint64_t) 0, orderings::MORTON::GetKey(util::Vector3D<site_t>(0, 0, 0)));
+            CPPUNIT_ASSERT_EQUAL((uint64_t) 1, orderings::MORTON::GetKey(util::Vector3D<site_t>(0, 0, 1)));
+            CPPUNIT_ASSERT_EQUAL((uint64_t) 2, orderings::MORTON::GetKey(util::Vector3D<site_t>(0, 1, 0)));
+            CPPUNIT_ASSERT_EQUAL((uint64_t) 4, orderings::MORTON::GetKey(util::Vector3D<site_t>(1, 0, 0)));
+            CPPUNIT_ASSERT_EQUAL((uint64_t) 7, orderings::MORTON::GetKey(util::Vector3D<site_t>(1, 1, 1)));
+            CPPUNIT_ASSERT_EQUAL((uint64_t) 8, orderings::MORTON::GetKey(util::Vector3D<site_t>(0, 0, 2)));
+
+            CheckKeysFillCube<orderings::MORTON>();
+          }
+
+          void TestHilbert()
+          {
+            std::vector<util::Vector3D<site_t> > curve = CheckKeysFillCube<orderings::HILBERT>();
+
+            // Each site on the Hilbert curve is a nearest neighbour of the one before.
+            for (size_t index = 1; index < curve.size(); ++index)
+            {
+              const util::Vector3D<site_t> step = curve[index] - curve[index - 1];
+              CPPUNIT_ASSERT_EQUAL((site_t) 1, std::abs(step.x) + std::abs(step.y) + std::abs(step.z));
+            }
+          }
+
+        private:
+          static const site_t CUBE_SIZE = 8;
+
+          /**
+           * Check that the keys of the sites in a cube are distinct and fill the range from
+           * zero, as the first part of the curve should.
+           * @return The sites of the cube in order along the curve.
+           */
+          template<typename Ordering>
+          static std::vector<util::Vector3D<site_t> > CheckKeysFillCube()
+          {
+            const uint64_t siteCount = CUBE_SIZE * CUBE_SIZE * CUBE_SIZE;
+            std::vector<util::Vector3D<site_t> > curve(siteCount, util::Vector3D<site_t>(-1));
+
+            for (site_t x = 0; x < CUBE_SIZE; ++x)
+            {
+              for (site_t y = 0; y < CUBE_SIZE; ++y)
+              {
+                for (site_t z = 0; z < CUBE_SIZE; ++z)
+                {
+                  const uint64_t key = Ordering::GetKey(util::Vector3D<site_t>(x, y, z));
+                  CPPUNIT_ASSERT(key < siteCount);
+                  CPPUNIT_ASSERT_EQUAL((site_t) -1, curve[key].x);
+                  curve[key] = util::Vector3D<site_t>(x, y, z);
+                }
+              }
+            }
+
+            return curve;
+          }
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION ( SiteOrderingTests);
+    }
+  }
+}
+
+#endif /* HEMELB_UNITTESTS_GEOMETRY_SITEORDERINGTESTS_H */
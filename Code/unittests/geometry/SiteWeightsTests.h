@@ -0,0 +1,73 @@
+
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_UNITTESTS_GEOMETRY_SITEWEIGHTSTESTS_H
+#define HEMELB_UNITTESTS_GEOMETRY_SITEWEIGHTSTESTS_H
+
+#include <fstream>
+#include <cppunit/TestFixture.h>
+#include "geometry/decomposition/SiteWeights.h"
+#include "unittests/helpers/FolderTestFixture.h"
+#include "Exception.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace geometry
+    {
+      using namespace hemelb::geometry::decomposition;
+
+      /**
+       * Check that site weights files are read back as written, and that bad ones are refused.
+       */
+      class SiteWeightsTests : public helpers::FolderTestFixture
+      {
+          CPPUNIT_TEST_SUITE ( SiteWeightsTests);
+          CPPUNIT_TEST ( TestRoundTrip);
+          CPPUNIT_TEST ( TestMissingType);
+          CPPUNIT_TEST ( TestUnknownType);
+          CPPUNIT_TEST_SUITE_END();
+
+        public:
+          void TestRoundTrip()
+          {
+            SiteWeights weights;
+            for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; ++collisionType)
+            {
+              weights.Set(collisionType, 10 + 3 * collisionType);
+            }
+            weights.Write("weights.txt");
+
+            const SiteWeights read = SiteWeights::Read("weights.txt");
+            for (unsigned collisionType = 0; collisionType < COLLISION_TYPES; ++collisionType)
+            {
+              CPPUNIT_ASSERT_EQUAL(10 + 3 * (int) collisionType, read[collisionType]);
+            }
+          }
+
+          void TestMissingType()
+          {
+            std::ofstream file("weights.txt");
+            file << "bulk 10\nwall 20\ninlet 30\noutlet 30\nwallinlet 40\n";
+            file.close();
+            CPPUNIT_ASSERT_THROW(SiteWeights::Read("weights.txt"), Exception);
+          }
+
+          void TestUnknownType()
+          {
+            std::ofstream file("weights.txt");
+            file << "bulk 10\nwall 20\ninlet 30\noutlet 30\nwallinlet 40\nwalloutlet 40\ncorner 50\n";
+            file.close();
+            CPPUNIT_ASSERT_THROW(SiteWeights::Read("weights.txt"), Exception);
+          }
+      };
+      CPPUNIT_TEST_SUITE_REGISTRATION ( SiteWeightsTests);
+    }
+  }
+}
+
+#endif /* HEMELB_UNITTESTS_GEOMETRY_SITEWEIGHTSTESTS_H */
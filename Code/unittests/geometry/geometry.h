@@ -10,6 +10,13 @@
 #include "unittests/geometry/GeometryReaderTests.h"
 #include "unittests/geometry/NeedsTests.h"
 #include "unittests/geometry/LatticeDataTests.h"
+#include "unittests/geometry/DistributionLayoutTests.h"
+#include "unittests/geometry/DistributionStorageTests.h"
+#include "unittests/geometry/SiteOrderingTests.h"
+#include "unittests/geometry/DenseBlocksTests.h"
+#include "unittests/geometry/DeepHaloTests.h"
+#include "unittests/geometry/SiteWeightsTests.h"
+#include "unittests/geometry/OptimisedDecompositionTests.h"
 #include "unittests/geometry/neighbouring/neighbouring.h"
 
 #endif // ONCE
@@ -222,7 +222,8 @@ namespace hemelb
 
               // It should arrive in the NeighbouringDataManager, from the values sent from the localLatticeData
 
-              netMock->RequireSend(const_cast<distribn_t*> (exampleSite.GetFOld<lb::lattices::D3Q15> ()),
+              distribn_t sentFOld[lb::lattices::D3Q15::NUMVECTORS];
+              netMock->RequireSend(const_cast<distribn_t*> (exampleSite.LoadFOld<lb::lattices::D3Q15> (sentFOld)),
                                    lb::lattices::D3Q15::NUMVECTORS,
                                    0,
                                    "IntersectionDataToSelf");
@@ -272,7 +273,8 @@ namespace hemelb
               Site < LatticeData > exampleSite = latDat->GetSite(targetLocalIdx);
               // It should arrive in the NeighbouringDataManager, from the values sent from the localLatticeData
 
-              netMock->RequireSend(const_cast<distribn_t*> (exampleSite.GetFOld<lb::lattices::D3Q15> ()),
+              distribn_t sentFOld[lb::lattices::D3Q15::NUMVECTORS];
+              netMock->RequireSend(const_cast<distribn_t*> (exampleSite.LoadFOld<lb::lattices::D3Q15> (sentFOld)),
                                    lb::lattices::D3Q15::NUMVECTORS,
                                    0,
                                    "IntersectionDataToSelf");
@@ -86,14 +86,14 @@ namespace hemelb
               std::vector<distribn_t> distribution;
               for (unsigned int direction = 0; direction < lb::lattices::D3Q15::NUMVECTORS; direction++)
               {
-                distribution.push_back(exampleSite->GetFOld<lb::lattices::D3Q15>()[direction]);
+                distribution.push_back(exampleSite->GetFOldInDirection(direction));
               }
 
               data->GetDistribution(dummyId) = distribution;
 
               for (unsigned int direction = 0; direction < lb::lattices::D3Q15::NUMVECTORS; direction++)
               {
-                CPPUNIT_ASSERT_EQUAL(exampleSite->GetFOld<lb::lattices::D3Q15>()[direction],
+                CPPUNIT_ASSERT_EQUAL(exampleSite->GetFOldInDirection(direction),
                                      data->GetFOld(dummyId * lb::lattices::D3Q15::NUMVECTORS)[direction]);
               }
             }
@@ -110,7 +110,7 @@ namespace hemelb
               std::vector<distribn_t> distribution;
               for (unsigned int direction = 0; direction < lb::lattices::D3Q15::NUMVECTORS; direction++)
               {
-                distribution.push_back(exampleSite->GetFOld<lb::lattices::D3Q15>()[direction]);
+                distribution.push_back(exampleSite->GetFOldInDirection(direction));
               }
               data->SaveSite(dummyId,
                              distribution,
@@ -129,7 +129,7 @@ namespace hemelb
               CPPUNIT_ASSERT_EQUAL(exampleSite->GetWallNormal(), neighbouringSite.GetWallNormal());
               for (unsigned int direction = 0; direction < lb::lattices::D3Q15::NUMVECTORS; direction++)
               {
-                CPPUNIT_ASSERT_EQUAL(exampleSite->GetFOld<lb::lattices::D3Q15>()[direction],
+                CPPUNIT_ASSERT_EQUAL(exampleSite->GetFOldInDirection(direction),
                                      neighbouringSite.GetFOld<lb::lattices::D3Q15>()[direction]);
               }
             }
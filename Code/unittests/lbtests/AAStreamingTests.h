@@ -0,0 +1,226 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_UNITTESTS_LBTESTS_AASTREAMINGTESTS_H
+#define HEMELB_UNITTESTS_LBTESTS_AASTREAMINGTESTS_H
+
+#include <sstream>
+#include <vector>
+#include <cppunit/TestFixture.h>
+
+#include "lb/streamers/Streamers.h"
+#include "net/net.h"
+#include "unittests/helpers/FourCubeBasedTestFixture.h"
+#include "unittests/lbtests/LbTestsHelper.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace lbtests
+    {
+      /**
+       * Run pairs of time steps, an even step and an odd one, over a four cube closed by
+       * bounce-back walls, and compare the distributions after each pair with those of plain
+       * two-array collision and streaming worked out here. Built with HEMELB_USE_AA_STREAMING
+       * this tests the in-place streaming of each kind of step, and otherwise the two-array
+       * streaming it must agree with.
+       *
+       * Split between two ranks, the sites either side of the cut stream to each other over
+       * shared links, through the exchange of the lattice data. That needs the tests to be run
+       * on more than one rank; on one, the cube isn't split.
+       */
+      class AAStreamingTests : public helpers::FourCubeBasedTestFixture
+      {
+          CPPUNIT_TEST_SUITE ( AAStreamingTests);
+          CPPUNIT_TEST ( TestStepPairs);
+          CPPUNIT_TEST ( TestStepPairsAcrossRanks);
+          CPPUNIT_TEST_SUITE_END();
+
+          typedef lb::lattices::D3Q15 LatticeType;
+          typedef lb::streamers::SimpleBounceBack<lb::collisions::Normal<lb::kernels::LBGK<LatticeType> > >::Type Streamer;
+
+        public:
+          void TestStepPairs()
+          {
+            StepAndCompare(latDat);
+          }
+
+          void TestStepPairsAcrossRanks()
+          {
+            FourCubeLatticeData* splitLatDat = FourCubeLatticeData::Create(Comms(),
+                                                                           6,
+                                                                           1,
+                                                                           Comms().Size() > 1 ?
+                                                                             1 :
+                                                                             0);
+            if (Comms().Size() > 1 && Comms().Rank() < 2)
+            {
+              CPPUNIT_ASSERT(!splitLatDat->GetNeighbouringRanks().empty());
+            }
+            StepAndCompare(splitLatDat);
+            delete splitLatDat;
+          }
+
+        private:
+          /**
+           * Turn the iolets into walls, run two pairs of steps on the lattice and check the
+           * distributions of its sites after each.
+           * @param lattice
+           */
+          void StepAndCompare(FourCubeLatticeData* lattice)
+          {
+            const site_t siteCount = lattice->GetLocalFluidSiteCount();
+            std::vector<distribn_t> distributions(siteCount * LatticeType::NUMVECTORS);
+            for (site_t site = 0; site < siteCount; ++site)
+            {
+              for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+              {
+                if (lattice->GetSite(site).HasIolet(direction))
+                {
+                  lattice->SetHasWall(site, direction);
+                }
+                distributions[site * LatticeType::NUMVECTORS + direction] =
+                    InitialValue(lattice->GetSite(site).GetGlobalSiteCoords(), direction);
+              }
+            }
+            lattice->SetLocalDistributions(distributions);
+
+            std::vector<distribn_t> expected(cubeSites * cubeSites * cubeSites * LatticeType::NUMVECTORS);
+            for (site_t x = 1; x <= cubeSites; ++x)
+            {
+              for (site_t y = 1; y <= cubeSites; ++y)
+              {
+                for (site_t z = 1; z <= cubeSites; ++z)
+                {
+                  for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+                  {
+                    expected[CubeIndex(x, y, z, direction)] = InitialValue(util::Vector3D<site_t>(x, y, z),
+                                                                           direction);
+                  }
+                }
+              }
+            }
+
+            lb::kernels::InitParams params = initParams;
+            params.latDat = lattice;
+            params.siteCount = siteCount;
+            Streamer streamer(params);
+            lb::MacroscopicPropertyCache propertyCache(*simState, *lattice);
+
+            for (int pair = 0; pair < 2; ++pair)
+            {
+              for (int step = 0; step < 2; ++step)
+              {
+#ifdef HEMELB_USE_AA_STREAMING
+                CPPUNIT_ASSERT_EQUAL(step == 1, lattice->IsOddStep());
+#endif
+                Step(lattice, streamer, propertyCache);
+                ExpectedStep(expected);
+              }
+
+              lattice->GetLocalDistributions(distributions);
+              for (site_t site = 0; site < siteCount; ++site)
+              {
+                const util::Vector3D<site_t>& coords = lattice->GetSite(site).GetGlobalSiteCoords();
+                for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+                {
+                  std::stringstream message;
+                  message << "Pair " << pair << ", site " << coords << ", direction " << direction;
+                  CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(message.str(),
+                                                       expected[CubeIndex(coords.x, coords.y, coords.z, direction)],
+                                                       distributions[site * LatticeType::NUMVECTORS + direction],
+                                                       allowedError);
+                }
+              }
+            }
+          }
+
+          /**
+           * Do a time step as the LBM does, exchanging the distributions streamed to other ranks.
+           */
+          void Step(FourCubeLatticeData* lattice, Streamer& streamer, lb::MacroscopicPropertyCache& propertyCache)
+          {
+            net::Net net(Comms());
+            lattice->SendAndReceive(&net);
+            streamer.StreamAndCollide<false>(0, lattice->GetLocalFluidSiteCount(), lbmParams, lattice, propertyCache);
+            lattice->PublishStreamedDistributions();
+            net.Dispatch();
+            lattice->CopyReceived();
+            streamer.PostStep<false>(0, lattice->GetLocalFluidSiteCount(), lbmParams, lattice, propertyCache);
+            lattice->SwapOldAndNew();
+          }
+
+          /**
+           * Collide and stream the whole cube with separate arrays before and after.
+           * @param distributions Indexed by CubeIndex
+           */
+          void ExpectedStep(std::vector<distribn_t>& distributions)
+          {
+            std::vector<distribn_t> streamed(distributions.size());
+            for (site_t x = 1; x <= cubeSites; ++x)
+            {
+              for (site_t y = 1; y <= cubeSites; ++y)
+              {
+                for (site_t z = 1; z <= cubeSites; ++z)
+                {
+                  const distribn_t* f = &distributions[CubeIndex(x, y, z, 0)];
+                  distribn_t density, momentum[3];
+                  LbTestsHelper::CalculateRhoMomentum<LatticeType>(f, density, momentum);
+                  distribn_t fEquilibrium[LatticeType::NUMVECTORS];
+                  LbTestsHelper::CalculateLBGKEqmF<LatticeType>(density,
+                                                                momentum[0],
+                                                                momentum[1],
+                                                                momentum[2],
+                                                                fEquilibrium);
+                  distribn_t fPostCollision[LatticeType::NUMVECTORS];
+                  LbTestsHelper::CalculateLBGKCollision<LatticeType>(f,
+                                                                     fEquilibrium,
+                                                                     lbmParams->GetOmega(),
+                                                                     fPostCollision);
+
+                  for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+                  {
+                    const site_t toX = x + LatticeType::CX[direction];
+                    const site_t toY = y + LatticeType::CY[direction];
+                    const site_t toZ = z + LatticeType::CZ[direction];
+                    if (toX < 1 || toX > cubeSites || toY < 1 || toY > cubeSites || toZ < 1 || toZ > cubeSites)
+                    {
+                      streamed[CubeIndex(x, y, z, LatticeType::INVERSEDIRECTIONS[direction])] =
+                          fPostCollision[direction];
+                    }
+                    else
+                    {
+                      streamed[CubeIndex(toX, toY, toZ, direction)] = fPostCollision[direction];
+                    }
+                  }
+                }
+              }
+            }
+            distributions.swap(streamed);
+          }
+
+          static site_t CubeIndex(site_t x, site_t y, site_t z, Direction direction)
+          {
+            return ( ( (z - 1) * cubeSites + (y - 1)) * cubeSites + (x - 1)) * LatticeType::NUMVECTORS + direction;
+          }
+
+          /**
+           * Distributions that differ from site to site and direction to direction.
+           */
+          static distribn_t InitialValue(const util::Vector3D<site_t>& coords, Direction direction)
+          {
+            return (direction + 1) / 10.0 + (coords.x + 2 * coords.y + 3 * coords.z) / 100.0;
+          }
+
+          static const site_t cubeSites = 4;
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION ( AAStreamingTests);
+    }
+  }
+}
+
+#endif /* HEMELB_UNITTESTS_LBTESTS_AASTREAMINGTESTS_H */
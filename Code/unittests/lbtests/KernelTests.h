@@ -11,6 +11,8 @@
 #include <sstream>
 
 #include "lb/kernels/Kernels.h"
+#include "lb/kernels/MultiSiteLBGK.h"
+#include "lb/lattices/Lattices.h"
 #include "lb/kernels/rheologyModels/RheologyModels.h"
 #include "lb/kernels/momentBasis/DHumieresD3Q15MRTBasis.h"
 #include "lb/kernels/momentBasis/DHumieresD3Q19MRTBasis.h"
@@ -39,7 +41,8 @@ namespace hemelb
           CPPUNIT_TEST ( TestLBGKCalculationsAndCollision);
           CPPUNIT_TEST ( TestLBGKNNCalculationsAndCollision);
           CPPUNIT_TEST ( TestMRTConstantRelaxationTimeEqualsLBGK);
-          CPPUNIT_TEST ( TestD3Q19MRTConstantRelaxationTimeEqualsLBGK);CPPUNIT_TEST_SUITE_END();
+          CPPUNIT_TEST ( TestD3Q19MRTConstantRelaxationTimeEqualsLBGK);
+          CPPUNIT_TEST ( TestMultiSiteLBGKEqualsLBGK);CPPUNIT_TEST_SUITE_END();
         public:
           void setUp()
           {
@@ -699,6 +702,98 @@ namespace hemelb
                                                    allowedError);
             }
           }
+
+          void TestMultiSiteLBGKEqualsLBGK()
+          {
+            CheckMultiSiteLBGKEqualsLBGK<lb::lattices::D3Q15>();
+            CheckMultiSiteLBGKEqualsLBGK<lb::lattices::D3Q19>();
+            CheckMultiSiteLBGKEqualsLBGK<lb::lattices::D3Q27>();
+          }
+
+        private:
+          template<class LatticeType>
+          void CheckMultiSiteLBGKEqualsLBGK()
+          {
+            typedef lb::kernels::MultiSiteLBGK<LatticeType> MultiSiteKernel;
+            lb::kernels::LBGK<LatticeType> lbgk(initParams);
+
+            // Give every site a different asymmetric distribution.
+            distribn_t f_original[MultiSiteKernel::SITES][LatticeType::NUMVECTORS];
+            lb::kernels::MultiSiteHydroVars<LatticeType> multiSiteHydroVars;
+
+            for (unsigned site = 0; site < MultiSiteKernel::SITES; ++site)
+            {
+              LbTestsHelper::InitialiseAnisotropicTestData<LatticeType>(site, f_original[site]);
+
+              for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+              {
+                multiSiteHydroVars.f[direction * MultiSiteKernel::SITES + site] = f_original[site][direction];
+              }
+            }
+
+            MultiSiteKernel::CalculateDensityMomentumFeqAndCollide(lbmParams->GetOmega(), multiSiteHydroVars);
+
+            distribn_t allowedError = 1e-12;
+
+            for (unsigned site = 0; site < MultiSiteKernel::SITES; ++site)
+            {
+              lb::kernels::HydroVars<lb::kernels::LBGK<LatticeType> > hydroVars(f_original[site]);
+              lbgk.CalculateDensityMomentumFeq(hydroVars, site);
+              lbgk.DoCollide(lbmParams, hydroVars);
+
+              std::stringstream context;
+              context << "Multi-site LBGK, Q" << LatticeType::NUMVECTORS << ", site " << site << ", ";
+
+              CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(context.str() + "density",
+                                                   hydroVars.density,
+                                                   multiSiteHydroVars.density[site],
+                                                   allowedError);
+              CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(context.str() + "momentum x",
+                                                   hydroVars.momentum.x,
+                                                   multiSiteHydroVars.momentumX[site],
+                                                   allowedError);
+              CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(context.str() + "momentum y",
+                                                   hydroVars.momentum.y,
+                                                   multiSiteHydroVars.momentumY[site],
+                                                   allowedError);
+              CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(context.str() + "momentum z",
+                                                   hydroVars.momentum.z,
+                                                   multiSiteHydroVars.momentumZ[site],
+                                                   allowedError);
+              CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(context.str() + "velocity x",
+                                                   hydroVars.velocity.x,
+                                                   multiSiteHydroVars.velocityX[site],
+                                                   allowedError);
+              CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(context.str() + "velocity y",
+                                                   hydroVars.velocity.y,
+                                                   multiSiteHydroVars.velocityY[site],
+                                                   allowedError);
+              CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(context.str() + "velocity z",
+                                                   hydroVars.velocity.z,
+                                                   multiSiteHydroVars.velocityZ[site],
+                                                   allowedError);
+
+              for (Direction direction = 0; direction < LatticeType::NUMVECTORS; ++direction)
+              {
+                std::stringstream message;
+                message << context.str() << "direction " << direction;
+                const unsigned index = direction * MultiSiteKernel::SITES + site;
+
+                CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(message.str() + " f_eq",
+                                                     hydroVars.GetFEq()[direction],
+                                                     multiSiteHydroVars.fEq[index],
+                                                     allowedError);
+                CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(message.str() + " f_neq",
+                                                     hydroVars.GetFNeq()[direction],
+                                                     multiSiteHydroVars.fNeq[index],
+                                                     allowedError);
+                CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE(message.str() + " post-collision",
+                                                     hydroVars.GetFPostCollision()[direction],
+                                                     multiSiteHydroVars.fPostCollision[index],
+                                                     allowedError);
+              }
+            }
+          }
       };
       CPPUNIT_TEST_SUITE_REGISTRATION ( KernelTests);
     }
@@ -214,10 +214,11 @@ namespace hemelb
             for (site_t site = 0; site < latDat.GetLocalFluidSiteCount(); ++site)
             {
               distribn_t density, feq[Lattice::NUMVECTORS];
+              distribn_t fOldBuffer[Lattice::NUMVECTORS];
               util::Vector3D<distribn_t> momentum;
               util::Vector3D<distribn_t> velocity;
 
-              Lattice::CalculateDensityMomentumFEq(latDat.GetSite(site).GetFOld<Lattice> (),
+              Lattice::CalculateDensityMomentumFEq(latDat.GetSite(site).LoadFOld<Lattice> (fOldBuffer),
                                                    density,
                                                    momentum[0],
                                                    momentum[1],
@@ -0,0 +1,105 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_UNITTESTS_LBTESTS_STABILITYACCUMULATORTESTS_H
+#define HEMELB_UNITTESTS_LBTESTS_STABILITYACCUMULATORTESTS_H
+
+#include <limits>
+#include <cppunit/TestFixture.h>
+#include "lb/StabilityAccumulator.h"
+#include "lb/lattices/D3Q15.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace lbtests
+    {
+      /**
+       * Check that the per-site stability and convergence checks made during the collision
+       * flag the right sites, and only on the steps they're asked to.
+       */
+      class StabilityAccumulatorTests : public CppUnit::TestFixture
+      {
+          CPPUNIT_TEST_SUITE(StabilityAccumulatorTests);
+          CPPUNIT_TEST(TestStability);
+          CPPUNIT_TEST(TestConvergence);
+          CPPUNIT_TEST_SUITE_END();
+
+          typedef lb::lattices::D3Q15 Lattice;
+
+        public:
+          void setUp()
+          {
+            for (Direction direction = 0; direction < Lattice::NUMVECTORS; ++direction)
+            {
+              f[direction] = Lattice::EQMWEIGHTS[direction];
+            }
+          }
+
+          void TestStability()
+          {
+            lb::StabilityAccumulator accumulator(2);
+            const util::Vector3D<distribn_t> momentum(0.0);
+
+            // A bad site is ignored when not checking.
+            f[3] = std::numeric_limits<distribn_t>::quiet_NaN();
+            accumulator.Accumulate<Lattice>(0, f, 1.0, momentum);
+            CPPUNIT_ASSERT(!accumulator.IsActive());
+            CPPUNIT_ASSERT(!accumulator.FoundUnstableSite());
+
+            accumulator.SetChecking(true);
+            CPPUNIT_ASSERT(accumulator.IsActive());
+            accumulator.Accumulate<Lattice>(0, f, 1.0, momentum);
+            CPPUNIT_ASSERT(accumulator.FoundUnstableSite());
+            CPPUNIT_ASSERT(!accumulator.FoundUnconvergedSite());
+
+            accumulator.ResetFlags();
+            f[3] = 0.0;
+            accumulator.Accumulate<Lattice>(1, f, 1.0, momentum);
+            CPPUNIT_ASSERT(accumulator.FoundUnstableSite());
+
+            accumulator.ResetFlags();
+            f[3] = Lattice::EQMWEIGHTS[3];
+            accumulator.Accumulate<Lattice>(1, f, 1.0, momentum);
+            CPPUNIT_ASSERT(!accumulator.FoundUnstableSite());
+          }
+
+          void TestConvergence()
+          {
+            lb::StabilityAccumulator accumulator(2);
+            accumulator.EnableConvergenceCheck(0.1, 1e-3);
+
+            // Record the velocities on one step...
+            accumulator.SetRecording(true);
+            accumulator.Accumulate<Lattice>(0, f, 1.0, util::Vector3D<distribn_t>(0.01, 0.0, 0.0));
+            accumulator.Accumulate<Lattice>(1, f, 2.0, util::Vector3D<distribn_t>(0.0, 0.02, 0.0));
+            CPPUNIT_ASSERT(!accumulator.FoundUnconvergedSite());
+
+            // ... and compare with them on the next.
+            accumulator.SetRecording(false);
+            accumulator.SetChecking(true);
+            accumulator.Accumulate<Lattice>(0, f, 1.0, util::Vector3D<distribn_t>(0.01 + 5e-5, 0.0, 0.0));
+            accumulator.Accumulate<Lattice>(1, f, 1.0, util::Vector3D<distribn_t>(0.0, 0.01, 0.0));
+            CPPUNIT_ASSERT(!accumulator.FoundUnconvergedSite());
+
+            accumulator.Accumulate<Lattice>(1, f, 1.0, util::Vector3D<distribn_t>(0.0, 0.01, 2e-4));
+            CPPUNIT_ASSERT(accumulator.FoundUnconvergedSite());
+            CPPUNIT_ASSERT(!accumulator.FoundUnstableSite());
+
+            accumulator.ResetFlags();
+            CPPUNIT_ASSERT(!accumulator.FoundUnconvergedSite());
+          }
+
+        private:
+          distribn_t f[Lattice::NUMVECTORS];
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION(StabilityAccumulatorTests);
+    }
+  }
+}
+
+#endif /* HEMELB_UNITTESTS_LBTESTS_STABILITYACCUMULATORTESTS_H */
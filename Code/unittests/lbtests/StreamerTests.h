@@ -9,6 +9,7 @@
 
 #include <cppunit/TestFixture.h>
 #include <iostream>
+#include <set>
 #include <sstream>
 
 #include "lb/streamers/Streamers.h"
@@ -24,6 +25,48 @@ namespace hemelb
     {
       static const distribn_t allowedError = 1e-10;
 
+      /**
+       * A link delegate that records the links it is given, to check which delegate a
+       * streamer picks for each type of link. Tag tells apart the instantiations for different
+       * types of link.
+       */
+      template<typename CollisionImpl, int Tag>
+      class RecordingDelegate : public lb::streamers::BaseStreamerDelegate<CollisionImpl>
+      {
+        public:
+          typedef CollisionImpl CollisionType;
+          typedef std::set<std::pair<site_t, Direction> > Links;
+
+          RecordingDelegate(CollisionType& delegatorCollider, lb::kernels::InitParams& initParams)
+          {
+          }
+
+          inline void StreamLink(const lb::LbmParameters* lbmParams,
+                                 geometry::LatticeData* const latticeData,
+                                 const geometry::Site<geometry::LatticeData>& site,
+                                 lb::kernels::HydroVars<typename CollisionType::CKernel>& hydroVars,
+                                 const Direction& direction)
+          {
+            streamed.insert(std::make_pair(site.GetIndex(), direction));
+          }
+
+          inline void PostStepLink(geometry::LatticeData* const latticeData,
+                                   const geometry::Site<geometry::LatticeData>& site,
+                                   const Direction& direction)
+          {
+            postStepped.insert(std::make_pair(site.GetIndex(), direction));
+          }
+
+          static Links streamed;
+          static Links postStepped;
+      };
+
+      template<typename CollisionImpl, int Tag>
+      typename RecordingDelegate<CollisionImpl, Tag>::Links RecordingDelegate<CollisionImpl, Tag>::streamed;
+
+      template<typename CollisionImpl, int Tag>
+      typename RecordingDelegate<CollisionImpl, Tag>::Links RecordingDelegate<CollisionImpl, Tag>::postStepped;
+
       /**
        * StreamerTests:
        *
@@ -40,7 +83,8 @@ namespace hemelb
           CPPUNIT_TEST ( TestGuoZhengShi);
           CPPUNIT_TEST ( TestNashZerothOrderPressureIolet);
           CPPUNIT_TEST ( TestNashZerothOrderPressureBB);
-          CPPUNIT_TEST ( TestJunkYangEquivalentToBounceBack);CPPUNIT_TEST_SUITE_END();
+          CPPUNIT_TEST ( TestJunkYangEquivalentToBounceBack);
+          CPPUNIT_TEST ( TestWallIoletLinkPrecedence);CPPUNIT_TEST_SUITE_END();
         public:
 
           void setUp()
@@ -300,6 +344,48 @@ namespace hemelb
             }
           }
 
+          void TestWallIoletLinkPrecedence()
+          {
+            typedef lb::collisions::Normal<lb::kernels::LBGK<lb::lattices::D3Q15> > Collision;
+            typedef RecordingDelegate<Collision, 0> WallDelegate;
+            typedef RecordingDelegate<Collision, 1> IoletDelegate;
+            WallDelegate::streamed.clear();
+            WallDelegate::postStepped.clear();
+            IoletDelegate::streamed.clear();
+            IoletDelegate::postStepped.clear();
+
+            latDat->SetWallOnFirstIoletLinks();
+            lb::streamers::WallIoletStreamerTypeFactory<Collision, WallDelegate, IoletDelegate> streamer(initParams);
+            LbTestsHelper::InitialiseAnisotropicTestData<lb::lattices::D3Q15>(latDat);
+            streamer.StreamAndCollide<false> (0, latDat->GetLocalFluidSiteCount(), lbmParams, latDat, *propertyCache);
+            streamer.PostStep<false> (0, latDat->GetLocalFluidSiteCount(), lbmParams, latDat, *propertyCache);
+
+            // A link that hits both a wall and an iolet is streamed by the iolet delegate, but
+            // the wall delegate does the post step for it.
+            site_t wallIoletLinks = 0;
+            for (site_t siteIndex = 0; siteIndex < latDat->GetLocalFluidSiteCount(); ++siteIndex)
+            {
+              const geometry::Site<geometry::LatticeData> site = latDat->GetSite(siteIndex);
+              for (Direction direction = 0; direction < lb::lattices::D3Q15::NUMVECTORS; ++direction)
+              {
+                const std::pair<site_t, Direction> link(siteIndex, direction);
+                const bool wall = site.HasWall(direction);
+                const bool iolet = site.HasIolet(direction);
+
+                CPPUNIT_ASSERT_EQUAL(wall && !iolet, WallDelegate::streamed.count(link) == 1);
+                CPPUNIT_ASSERT_EQUAL(iolet, IoletDelegate::streamed.count(link) == 1);
+                CPPUNIT_ASSERT_EQUAL(wall, WallDelegate::postStepped.count(link) == 1);
+                CPPUNIT_ASSERT_EQUAL(iolet && !wall, IoletDelegate::postStepped.count(link) == 1);
+
+                if (wall && iolet)
+                {
+                  ++wallIoletLinks;
+                }
+              }
+            }
+            CPPUNIT_ASSERT(wallIoletLinks > 0);
+          }
+
           void TestSimpleBounceBack()
           {
             // Initialise fOld in the lattice data. We choose values so that each site has
@@ -10,8 +10,10 @@
 #include "unittests/lbtests/KernelTests.h"
 #include "unittests/lbtests/CollisionTests.h"
 #include "unittests/lbtests/StreamerTests.h"
+#include "unittests/lbtests/AAStreamingTests.h"
 #include "unittests/lbtests/RheologyModelTests.h"
 #include "unittests/lbtests/IncompressibilityCheckerTests.h"
+#include "unittests/lbtests/StabilityAccumulatorTests.h"
 #include "unittests/lbtests/LatticeTests.h"
 #include "unittests/lbtests/iolets/BoundaryTests.h"
 #include "unittests/lbtests/iolets/InOutLetTests.h"
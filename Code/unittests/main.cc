@@ -19,6 +19,7 @@
 #include "unittests/configuration/configuration.h"
 #include "unittests/geometry/geometry.h"
 #include "unittests/SimulationMasterTests.h"
+#include "unittests/CheckpointerTests.h"
 #include "unittests/extraction/extraction.h"
 #include "unittests/net/net.h"
 #include "unittests/multiscale/multiscale.h"
@@ -0,0 +1,123 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_UNITTESTS_NET_NEIGHBOURHOODPOINTPOINTTESTS_H
+#define HEMELB_UNITTESTS_NET_NEIGHBOURHOODPOINTPOINTTESTS_H
+
+#include <string>
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include "net/net.h"
+#include "unittests/helpers/FourCubeBasedTestFixture.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace net
+    {
+      using namespace hemelb::net;
+      using hemelb::geometry::distribn_storage_t;
+
+      /**
+       * Test that the exchange through a neighbourhood collective delivers the same as
+       * CoalescePointPoint. Each rank sends the distributions of every other site of its four
+       * cube, one at a time, to itself as its only neighbour, as a rank that shares sites with
+       * itself across a periodic boundary would. Only the first rank holds the cube's sites.
+       */
+      class NeighbourhoodPointPointTests : public helpers::FourCubeBasedTestFixture
+      {
+          CPPUNIT_TEST_SUITE ( NeighbourhoodPointPointTests);
+          CPPUNIT_TEST ( TestSameAsCoalesce);
+          CPPUNIT_TEST_SUITE_END();
+
+        public:
+          void setUp()
+          {
+            helpers::FourCubeBasedTestFixture::setUp();
+
+            const proc_t rank = Comms().Rank();
+            neighbours.assign(1, rank);
+
+            const Direction numVectors = latDat->GetLatticeInfo().GetNumVectors();
+            for (site_t site = 0; site < latDat->GetLocalFluidSiteCount(); ++site)
+            {
+              for (Direction direction = 0; direction < numVectors; ++direction)
+              {
+                *latDat->GetFNew(latDat->GetDistributionIndex(site, direction)) = Value(rank, site, direction);
+              }
+            }
+          }
+
+          void TestSameAsCoalesce()
+          {
+            std::vector<std::vector<distribn_storage_t> > coalesced, neighbourhood;
+            Exchange("Coalesce", coalesced);
+            Exchange("Neighbourhood", neighbourhood);
+
+            const Direction numVectors = latDat->GetLatticeInfo().GetNumVectors();
+            for (size_t neighbourId = 0; neighbourId < neighbours.size(); ++neighbourId)
+            {
+              CPPUNIT_ASSERT(coalesced[neighbourId] == neighbourhood[neighbourId]);
+
+              size_t index = 0;
+              for (site_t site = 0; site < latDat->GetLocalFluidSiteCount(); site += 2)
+              {
+                for (Direction direction = 0; direction < numVectors; ++direction)
+                {
+                  CPPUNIT_ASSERT_EQUAL(Value(neighbours[neighbourId], site, direction),
+                                       neighbourhood[neighbourId][index++]);
+                }
+              }
+            }
+          }
+
+        private:
+          /**
+           * Exchange every other site's distributions with the neighbours, through the given
+           * point-to-point implementation.
+           * @param implementation
+           * @param received What came from each neighbour
+           */
+          void Exchange(const std::string& implementation, std::vector<std::vector<distribn_storage_t> >& received)
+          {
+            const Direction numVectors = latDat->GetLatticeInfo().GetNumVectors();
+            const site_t sentSites = (latDat->GetLocalFluidSiteCount() + 1) / 2;
+            received.assign(neighbours.size(), std::vector<distribn_storage_t>(sentSites * numVectors, -1));
+
+            Net net(Comms());
+            net.SetNeighbourhood(neighbours);
+            net.SelectPointPoint(implementation);
+            for (size_t neighbourId = 0; neighbourId < neighbours.size(); ++neighbourId)
+            {
+              size_t index = 0;
+              for (site_t site = 0; site < latDat->GetLocalFluidSiteCount(); site += 2)
+              {
+                for (Direction direction = 0; direction < numVectors; ++direction)
+                {
+                  net.RequestSend(latDat->GetFNew(latDat->GetDistributionIndex(site, direction)),
+                                  1,
+                                  neighbours[neighbourId]);
+                  net.RequestReceive(&received[neighbourId][index++], 1, neighbours[neighbourId]);
+                }
+              }
+            }
+            net.Dispatch();
+          }
+
+          static distribn_storage_t Value(proc_t rank, site_t site, Direction direction)
+          {
+            return distribn_storage_t(10000 * rank + 100 * site + direction);
+          }
+
+          std::vector<proc_t> neighbours;
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION ( NeighbourhoodPointPointTests);
+    }
+  }
+}
+
+#endif /* HEMELB_UNITTESTS_NET_NEIGHBOURHOODPOINTPOINTTESTS_H */
@@ -0,0 +1,146 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_UNITTESTS_NET_PACKEDPOINTPOINTTESTS_H
+#define HEMELB_UNITTESTS_NET_PACKEDPOINTPOINTTESTS_H
+
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include "net/net.h"
+#include "unittests/helpers/HasCommsTestFixture.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace net
+    {
+      using namespace hemelb::net;
+
+      /**
+       * Test that the packed point-to-point implementation gathers several non-contiguous
+       * requests to one peer into its message, and scatters the message received to where
+       * each request asked for it. Each rank exchanges with itself.
+       */
+      class PackedPointPointTests : public helpers::HasCommsTestFixture
+      {
+          CPPUNIT_TEST_SUITE ( PackedPointPointTests);
+          CPPUNIT_TEST ( TestSingleRequest);
+          CPPUNIT_TEST ( TestScatter);
+          CPPUNIT_TEST ( TestScatterSplitDifferently);
+          CPPUNIT_TEST ( TestMixedTypes);
+          CPPUNIT_TEST_SUITE_END();
+
+        public:
+          void setUp()
+          {
+            helpers::HasCommsTestFixture::setUp();
+            net = new Net(Comms());
+            net->SelectPointPoint("Packed");
+            sent.resize(arraySize);
+            received.assign(arraySize, -1);
+            for (int i = 0; i < arraySize; ++i)
+            {
+              sent[i] = 100 * Comms().Rank() + i;
+            }
+          }
+
+          void tearDown()
+          {
+            delete net;
+            helpers::HasCommsTestFixture::tearDown();
+          }
+
+          void TestSingleRequest()
+          {
+            net->RequestSend(&sent[2], 5, Comms().Rank());
+            net->RequestReceive(&received[10], 5, Comms().Rank());
+            net->Dispatch();
+
+            for (int i = 0; i < arraySize; ++i)
+            {
+              CPPUNIT_ASSERT_EQUAL(i >= 10 && i < 15 ?
+                                     sent[i - 8] :
+                                     -1,
+                                   received[i]);
+            }
+          }
+
+          void TestScatter()
+          {
+            // Every other pair of values, received in the same places they were sent from.
+            for (int step = 0; step < 2; ++step)
+            {
+              received.assign(arraySize, -1);
+              for (int i = 0; i < arraySize; i += 4)
+              {
+                net->RequestSend(&sent[i], 2, Comms().Rank());
+                net->RequestReceive(&received[i], 2, Comms().Rank());
+              }
+              net->Dispatch();
+
+              for (int i = 0; i < arraySize; ++i)
+              {
+                CPPUNIT_ASSERT_EQUAL(i % 4 < 2 ?
+                                       sent[i] :
+                                       -1,
+                                     received[i]);
+              }
+            }
+          }
+
+          void TestScatterSplitDifferently()
+          {
+            // The message is just bytes, so pieces sent separately can be received together,
+            // and the other way round.
+            net->RequestSend(&sent[0], 3, Comms().Rank());
+            net->RequestSend(&sent[10], 1, Comms().Rank());
+            net->RequestSend(&sent[20], 4, Comms().Rank());
+            net->RequestReceive(&received[1], 2, Comms().Rank());
+            net->RequestReceive(&received[5], 4, Comms().Rank());
+            net->RequestReceive(&received[12], 2, Comms().Rank());
+            net->Dispatch();
+
+            const int expected[] = { -1, sent[0], sent[1], -1, -1, sent[2], sent[10], sent[20], sent[21], -1, -1, -1,
+                                     sent[22], sent[23], -1 };
+            for (int i = 0; i < 15; ++i)
+            {
+              CPPUNIT_ASSERT_EQUAL(expected[i], received[i]);
+            }
+          }
+
+          void TestMixedTypes()
+          {
+            double sentDouble = 0.5 + Comms().Rank();
+            double receivedDouble = 0.0;
+            net->RequestSend(&sent[3], 2, Comms().Rank());
+            net->RequestSend(&sentDouble, 1, Comms().Rank());
+            net->RequestSend(&sent[7], 1, Comms().Rank());
+            net->RequestReceive(&received[0], 2, Comms().Rank());
+            net->RequestReceive(&receivedDouble, 1, Comms().Rank());
+            net->RequestReceive(&received[9], 1, Comms().Rank());
+            net->Dispatch();
+
+            CPPUNIT_ASSERT_EQUAL(sent[3], received[0]);
+            CPPUNIT_ASSERT_EQUAL(sent[4], received[1]);
+            CPPUNIT_ASSERT_EQUAL(sentDouble, receivedDouble);
+            CPPUNIT_ASSERT_EQUAL(sent[7], received[9]);
+            CPPUNIT_ASSERT_EQUAL(-1, received[2]);
+            CPPUNIT_ASSERT_EQUAL(-1, received[8]);
+          }
+
+        private:
+          static const int arraySize = 30;
+          Net* net;
+          std::vector<int> sent;
+          std::vector<int> received;
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION ( PackedPointPointTests);
+    }
+  }
+}
+
+#endif /* HEMELB_UNITTESTS_NET_PACKEDPOINTPOINTTESTS_H */
@@ -0,0 +1,132 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_UNITTESTS_NET_PERSISTENTPOINTPOINTTESTS_H
+#define HEMELB_UNITTESTS_NET_PERSISTENTPOINTPOINTTESTS_H
+
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include "net/net.h"
+#include "unittests/helpers/HasCommsTestFixture.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace net
+    {
+      using namespace hemelb::net;
+
+      /**
+       * Test that the persistent point-to-point implementation makes its requests once for
+       * each of a few exchanges that take turns, rather than each time the exchange changes.
+       * Each rank exchanges with itself.
+       */
+      class PersistentPointPointTests : public helpers::HasCommsTestFixture
+      {
+          CPPUNIT_TEST_SUITE ( PersistentPointPointTests);
+          CPPUNIT_TEST ( TestRepeatedExchange);
+          CPPUNIT_TEST ( TestAlternatingExchanges);
+          CPPUNIT_TEST ( TestMoreExchangesThanCached);
+          CPPUNIT_TEST_SUITE_END();
+
+        public:
+          void setUp()
+          {
+            helpers::HasCommsTestFixture::setUp();
+            net = new Net(Comms());
+            net->SelectPointPoint("Persistent");
+            exchangeCount = PersistentPointPoint::CACHE_SIZE + 1;
+            sent.assign(exchangeCount, std::vector<int>(exchangeSize));
+            received.assign(exchangeCount, std::vector<int>(exchangeSize));
+          }
+
+          void tearDown()
+          {
+            delete net;
+            helpers::HasCommsTestFixture::tearDown();
+          }
+
+          void TestRepeatedExchange()
+          {
+            for (int step = 0; step < 10; ++step)
+            {
+              Exchange(0, step);
+            }
+            // One set of requests for the sends and one for the receives.
+            CPPUNIT_ASSERT_EQUAL(2ul, net->GetPersistentRequestsBuilt());
+          }
+
+          void TestAlternatingExchanges()
+          {
+            // As the lattice's halo exchange alternating with the steps of a phased broadcast.
+            for (int step = 0; step < 10; ++step)
+            {
+              Exchange(0, step);
+              Exchange(1, step);
+            }
+            CPPUNIT_ASSERT_EQUAL(4ul, net->GetPersistentRequestsBuilt());
+          }
+
+          void TestMoreExchangesThanCached()
+          {
+            // Taking turns round more exchanges than are kept, each has to be made afresh every
+            // time, but they must still arrive.
+            for (int step = 0; step < 3; ++step)
+            {
+              for (size_t exchange = 0; exchange < exchangeCount; ++exchange)
+              {
+                Exchange(exchange, step);
+              }
+            }
+            CPPUNIT_ASSERT_EQUAL((unsigned long) (2 * 3 * exchangeCount), net->GetPersistentRequestsBuilt());
+          }
+
+        private:
+          /**
+           * Send one of the exchanges to this rank, in two non-contiguous requests, and check
+           * that it arrives.
+           */
+          void Exchange(size_t exchange, int step)
+          {
+            const int half = exchangeSize / 2;
+            for (int i = 0; i < exchangeSize; ++i)
+            {
+              sent[exchange][i] = Value(exchange, step, i);
+              received[exchange][i] = -1;
+            }
+            net->RequestReceive(&received[exchange][0], half, Comms().Rank());
+            net->RequestReceive(&received[exchange][half + 1], exchangeSize - half - 1, Comms().Rank());
+            net->RequestSend(&sent[exchange][0], half, Comms().Rank());
+            net->RequestSend(&sent[exchange][half + 1], exchangeSize - half - 1, Comms().Rank());
+            net->Dispatch();
+
+            for (int i = 0; i < exchangeSize; ++i)
+            {
+              CPPUNIT_ASSERT_EQUAL(i == half ?
+                                     -1 :
+                                     Value(exchange, step, i),
+                                   received[exchange][i]);
+            }
+          }
+
+          static int Value(size_t exchange, int step, int i)
+          {
+            return 10000 * (int) exchange + 100 * step + i;
+          }
+
+          static const int exchangeSize = 9;
+          Net* net;
+          size_t exchangeCount;
+          std::vector<std::vector<int> > sent;
+          std::vector<std::vector<int> > received;
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION ( PersistentPointPointTests);
+    }
+  }
+}
+
+#endif /* HEMELB_UNITTESTS_NET_PERSISTENTPOINTPOINTTESTS_H */
@@ -156,6 +156,14 @@ namespace hemelb
             sendProcessorComms.clear();
           }
 
+          /**
+           * Mock-progress - the mock sends and receives complete as soon as they are made
+           */
+          bool ProgressPointToPoint()
+          {
+            return true;
+          }
+
           /**
            * Assert that all required sends and receives have occurred.
            */
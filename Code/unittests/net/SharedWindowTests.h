@@ -0,0 +1,114 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_UNITTESTS_NET_SHAREDWINDOWTESTS_H
+#define HEMELB_UNITTESTS_NET_SHAREDWINDOWTESTS_H
+
+#include <vector>
+#include <cppunit/TestFixture.h>
+#include "net/net.h"
+#include "net/SharedWindowAllocator.h"
+#include "unittests/helpers/HasCommsTestFixture.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace net
+    {
+      using namespace hemelb::net;
+
+      /**
+       * Test the exchange through memory shared between the processes of a node, as the
+       * lattice data does it when built with HEMELB_USE_SHARED_WINDOWS: each process writes
+       * into its own pair of arrays, syncs and sends a token, and its neighbour receives the
+       * token, syncs and reads the writes straight out of the other's segment.
+       */
+      class SharedWindowTests : public helpers::HasCommsTestFixture
+      {
+          CPPUNIT_TEST_SUITE ( SharedWindowTests);
+          CPPUNIT_TEST ( TestOwnSegment);
+          CPPUNIT_TEST ( TestExchange);
+          CPPUNIT_TEST_SUITE_END();
+
+          typedef std::vector<double, SharedWindowAllocator<double> > SharedArray;
+
+        public:
+          void setUp()
+          {
+            helpers::HasCommsTestFixture::setUp();
+            nodeComms = Comms().SplitShared();
+          }
+
+          void TestOwnSegment()
+          {
+            const SharedWindowAllocator<double> allocator(nodeComms);
+            SharedArray array(arraySize, 0.0, allocator);
+
+            CPPUNIT_ASSERT_EQUAL(&array[0], SharedWindowAllocator<double>::GetSegment(&array[0], nodeComms.Rank()));
+            CPPUNIT_ASSERT(SharedWindowAllocator<double>::GetWindow(&array[0]) != MPI_WIN_NULL);
+          }
+
+          void TestExchange()
+          {
+            const SharedWindowAllocator<double> allocator(nodeComms);
+            SharedArray oldValues(arraySize, 0.0, allocator);
+            SharedArray newValues(arraySize, 0.0, allocator);
+
+            // Each process streams to the next on the node, and from the previous, which is
+            // itself when it's alone there.
+            const int next = (nodeComms.Rank() + 1) % nodeComms.Size();
+            const int previous = (nodeComms.Rank() + nodeComms.Size() - 1) % nodeComms.Size();
+            const double* previousOld = SharedWindowAllocator<double>::GetSegment(&oldValues[0], previous);
+            const double* previousNew = SharedWindowAllocator<double>::GetSegment(&newValues[0], previous);
+
+            Net net(nodeComms);
+            char sendToken = 0;
+            char receiveToken = 0;
+            for (int step = 0; step < 4; ++step)
+            {
+              for (int i = 0; i < arraySize; ++i)
+              {
+                newValues[i] = Value(nodeComms.Rank(), step, i);
+              }
+              HEMELB_MPI_CALL(MPI_Win_sync, (SharedWindowAllocator<double>::GetWindow(&newValues[0])));
+
+              net.RequestReceive(&receiveToken, 1, previous);
+              net.RequestSend(&sendToken, 1, next);
+              net.Dispatch();
+
+              HEMELB_MPI_CALL(MPI_Win_sync, (SharedWindowAllocator<double>::GetWindow(&newValues[0])));
+              for (int i = 0; i < arraySize; ++i)
+              {
+                CPPUNIT_ASSERT_EQUAL(Value(previous, step, i), previousNew[i]);
+              }
+
+              // The arrays swap over, and with them which of the neighbour's segments is new.
+              oldValues.swap(newValues);
+              std::swap(previousOld, previousNew);
+
+              // Wait for the neighbour to finish reading before the next step overwrites it.
+              net.RequestReceive(&receiveToken, 1, next);
+              net.RequestSend(&sendToken, 1, previous);
+              net.Dispatch();
+            }
+          }
+
+        private:
+          static double Value(int rank, int step, int i)
+          {
+            return 1000.0 * rank + 100.0 * step + i;
+          }
+
+          static const int arraySize = 37;
+          MpiCommunicator nodeComms;
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION ( SharedWindowTests);
+    }
+  }
+}
+
+#endif /* HEMELB_UNITTESTS_NET_SHAREDWINDOWTESTS_H */
@@ -9,5 +9,9 @@
 
 #include "unittests/net/phased/phased.h"
 #include "unittests/net/MpiTests.h"
+#include "unittests/net/SharedWindowTests.h"
+#include "unittests/net/PersistentPointPointTests.h"
+#include "unittests/net/NeighbourhoodPointPointTests.h"
+#include "unittests/net/PackedPointPointTests.h"
 
 #endif
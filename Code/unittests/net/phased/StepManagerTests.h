@@ -12,6 +12,9 @@
 #include "unittests/net/phased/MockIteratedAction.h"
 #include "net/phased/NetConcern.h"
 #include <cppunit/TestFixture.h>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
 
 namespace hemelb
 {
@@ -46,6 +49,9 @@ namespace hemelb
             CPPUNIT_TEST (TestCallAllActionsManyPhases);
             CPPUNIT_TEST (TestCallAllActionsPhaseByPhase);
 
+            CPPUNIT_TEST (TestTimeline);
+            CPPUNIT_TEST (TestTimelineCutShort);
+
             CPPUNIT_TEST_SUITE_END();
 
           public:
@@ -460,6 +466,73 @@ namespace hemelb
               netConcern = new NetConcern(*netMock);
             }
 
+            void TestTimeline()
+            {
+              concern = new MockConcern("mockTwo");
+              stepManager->Register(0, steps::BeginAll, *concern, 17);
+              stepManager->Register(1, steps::PreSend, *concern, 0);
+
+              const std::string path("StepManagerTestsTimeline.json");
+              Tracer tracer(hemelb::net::MpiCommunicator::World(), path, 2, 1);
+              stepManager->SetTracer(&tracer);
+              for (int step = 1; step <= 3; ++step)
+              {
+                stepManager->CallActions();
+              }
+
+              std::ifstream file(path.c_str());
+              std::stringstream contents;
+              contents << file.rdbuf();
+              std::string timeline = contents.str();
+              std::remove(path.c_str());
+
+              // Only the second step's two actions, as complete events on this rank.
+              CPPUNIT_ASSERT_EQUAL((size_t) 0, timeline.find("{\"traceEvents\":["));
+              CPPUNIT_ASSERT_EQUAL(timeline.size() - 4, timeline.rfind("\n]}\n"));
+              CPPUNIT_ASSERT(timeline.find("\"name\":\"hemelb::unittests::net::phased::MockConcern\",\"cat\":\"BeginAll\"")
+                  != std::string::npos);
+              CPPUNIT_ASSERT(timeline.find("\"cat\":\"PreSend\"") != std::string::npos);
+              CPPUNIT_ASSERT(timeline.find("\"args\":{\"step\":2,\"phase\":1}") != std::string::npos);
+              CPPUNIT_ASSERT(timeline.find("\"step\":1,") == std::string::npos);
+              CPPUNIT_ASSERT(timeline.find("\"step\":3,") == std::string::npos);
+
+              std::vector<int> shouldHaveCalled;
+              for (int step = 1; step <= 3; ++step)
+              {
+                shouldHaveCalled.push_back(17);
+                shouldHaveCalled.push_back(0);
+              }
+              CPPUNIT_ASSERT_EQUAL(shouldHaveCalled, concern->ActionsCalled());
+            }
+
+            void TestTimelineCutShort()
+            {
+              concern = new MockConcern("mockTwo");
+              stepManager->Register(1, steps::PreSend, *concern, 0);
+
+              // The window runs past the end of the run, so finishing writes what there is.
+              const std::string path("StepManagerTestsTimelineCutShort.json");
+              Tracer tracer(hemelb::net::MpiCommunicator::World(), path, 2, 10);
+              stepManager->SetTracer(&tracer);
+              for (int step = 1; step <= 3; ++step)
+              {
+                stepManager->CallActions();
+              }
+              tracer.Finish();
+
+              std::ifstream file(path.c_str());
+              std::stringstream contents;
+              contents << file.rdbuf();
+              std::string timeline = contents.str();
+              std::remove(path.c_str());
+
+              CPPUNIT_ASSERT_EQUAL((size_t) 0, timeline.find("{\"traceEvents\":["));
+              CPPUNIT_ASSERT(timeline.find("\"args\":{\"step\":2,\"phase\":1}") != std::string::npos);
+              CPPUNIT_ASSERT(timeline.find("\"args\":{\"step\":3,\"phase\":1}") != std::string::npos);
+              CPPUNIT_ASSERT(timeline.find("\"step\":1,") == std::string::npos);
+              CPPUNIT_ASSERT(!tracer.IsRecording());
+            }
+
           private:
 
             StepManager *stepManager;
@@ -0,0 +1,105 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_UNITTESTS_UTIL_THREADPOOLTESTS_H
+#define HEMELB_UNITTESTS_UTIL_THREADPOOLTESTS_H
+
+#include <vector>
+#include "util/ThreadPool.h"
+
+namespace hemelb
+{
+  namespace unittests
+  {
+    namespace util
+    {
+      using namespace hemelb::util;
+
+      class ThreadPoolTests : public CppUnit::TestFixture
+      {
+          CPPUNIT_TEST_SUITE( ThreadPoolTests);
+          CPPUNIT_TEST( TestSingleThread);
+          CPPUNIT_TEST( TestEverySiteVisitedOnce);
+          CPPUNIT_TEST( TestSmallRangeNotSplit);CPPUNIT_TEST_SUITE_END();
+
+        public:
+          void TestSingleThread()
+          {
+            ThreadPool pool(1);
+            CPPUNIT_ASSERT_EQUAL(1u, pool.GetThreadCount());
+
+            std::vector<int> visits(10000, 0);
+            unsigned calls = 0;
+            pool.ParallelFor(0, 10000, [&visits, &calls] (site_t first, site_t count)
+            {
+              ++calls;
+              for (site_t i = first; i < first + count; ++i)
+              {
+                ++visits[i];
+              }
+            });
+
+            CPPUNIT_ASSERT_EQUAL(1u, calls);
+            for (site_t i = 0; i < 10000; ++i)
+            {
+              CPPUNIT_ASSERT_EQUAL(1, visits[i]);
+            }
+          }
+
+          void TestEverySiteVisitedOnce()
+          {
+            ThreadPool pool(4);
+            CPPUNIT_ASSERT_EQUAL(4u, pool.GetThreadCount());
+
+            const site_t first = 17, count = 100003;
+            std::vector<int> visits(first + count, 0);
+
+            // Repeat so that the workers are reused across calls.
+            for (unsigned repeat = 0; repeat < 5; ++repeat)
+            {
+              pool.ParallelFor(first, count, [&visits] (site_t chunkFirst, site_t chunkCount)
+              {
+                for (site_t i = chunkFirst; i < chunkFirst + chunkCount; ++i)
+                {
+                  ++visits[i];
+                }
+              });
+            }
+
+            for (site_t i = 0; i < first; ++i)
+            {
+              CPPUNIT_ASSERT_EQUAL(0, visits[i]);
+            }
+            for (site_t i = first; i < first + count; ++i)
+            {
+              CPPUNIT_ASSERT_EQUAL(5, visits[i]);
+            }
+          }
+
+          void TestSmallRangeNotSplit()
+          {
+            ThreadPool pool(4);
+
+            unsigned calls = 0;
+            pool.ParallelFor(0, ThreadPool::MIN_SITES_PER_THREAD, [&calls] (site_t, site_t)
+            {
+              ++calls;
+            });
+            CPPUNIT_ASSERT_EQUAL(1u, calls);
+
+            // An empty range must not hang or call the work on a bogus range.
+            pool.ParallelFor(0, 0, [] (site_t, site_t count)
+            {
+              CPPUNIT_ASSERT_EQUAL((site_t) 0, count);
+            });
+          }
+      };
+
+      CPPUNIT_TEST_SUITE_REGISTRATION( ThreadPoolTests);
+    }
+  }
+}
+
+#endif /* HEMELB_UNITTESTS_UTIL_THREADPOOLTESTS_H */
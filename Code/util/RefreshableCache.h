@@ -45,6 +45,13 @@ namespace hemelb
          */
         bool RequiresRefresh() const;
 
+        /**
+         * Change the size of cache that may be required, e.g. when the sites it holds
+         * are redistributed.
+         * @param size
+         */
+        void Resize(unsigned long size);
+
       private:
         /**
          * Boolean to indicate whether the cache needs refreshing.
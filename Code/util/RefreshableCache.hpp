@@ -44,6 +44,13 @@ namespace hemelb
     {
       return requiresRefreshing;
     }
+
+    template<typename CacheType>
+    void RefreshableCache<CacheType>::Resize(unsigned long size)
+    {
+      cacheSize = size;
+      CheckingCache<CacheType>::Reserve(cacheSize);
+    }
   }
 }
 
@@ -0,0 +1,108 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#include "util/ThreadPool.h"
+#include <algorithm>
+
+namespace hemelb
+{
+  namespace util
+  {
+    const site_t ThreadPool::MIN_SITES_PER_THREAD;
+
+    ThreadPool::ThreadPool(unsigned threadCount) :
+        threadCount(threadCount), currentTask(NULL), currentTaskCount(0), generation(0),
+            pendingWorkers(0), shuttingDown(false)
+    {
+      if (this->threadCount == 0)
+      {
+        this->threadCount = std::max(1u, std::thread::hardware_concurrency());
+      }
+
+      for (unsigned worker = 1; worker < this->threadCount; ++worker)
+      {
+        workers.push_back(std::thread(&ThreadPool::WorkerLoop, this, worker));
+      }
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        shuttingDown = true;
+      }
+      workAvailable.notify_all();
+
+      for (std::vector<std::thread>::iterator worker = workers.begin(); worker != workers.end(); ++worker)
+      {
+        worker->join();
+      }
+    }
+
+    site_t ThreadPool::GetChunkCount(const site_t siteCount) const
+    {
+      return std::min<site_t>(threadCount, siteCount / MIN_SITES_PER_THREAD);
+    }
+
+    void ThreadPool::RunOnAll(const unsigned taskCount, const std::function<void(unsigned)>& task)
+    {
+      {
+        std::lock_guard<std::mutex> lock(mutex);
+        currentTask = &task;
+        currentTaskCount = taskCount;
+        pendingWorkers = (unsigned) workers.size();
+        ++generation;
+      }
+      workAvailable.notify_all();
+
+      task(0);
+
+      std::unique_lock<std::mutex> lock(mutex);
+      workDone.wait(lock, [this]
+      { return pendingWorkers == 0;});
+      currentTask = NULL;
+    }
+
+    void ThreadPool::WorkerLoop(const unsigned workerIndex)
+    {
+      unsigned long seenGeneration = 0;
+
+      while (true)
+      {
+        const std::function<void(unsigned)>* task;
+        unsigned taskCount;
+        {
+          std::unique_lock<std::mutex> lock(mutex);
+          workAvailable.wait(lock, [this, seenGeneration]
+          { return shuttingDown || generation != seenGeneration;});
+
+          if (shuttingDown)
+          {
+            return;
+          }
+
+          seenGeneration = generation;
+          task = currentTask;
+          taskCount = currentTaskCount;
+        }
+
+        if (workerIndex < taskCount)
+        {
+          (*task)(workerIndex);
+        }
+
+        bool lastToFinish;
+        {
+          std::lock_guard<std::mutex> lock(mutex);
+          lastToFinish = (--pendingWorkers == 0);
+        }
+        if (lastToFinish)
+        {
+          workDone.notify_one();
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,115 @@
+// This file is part of HemeLB and is Copyright (C)
+// the HemeLB team and/or their institutions, as detailed in the
+// file AUTHORS. This software is provided under the terms of the
+// license in the file LICENSE.
+
+#ifndef HEMELB_UTIL_THREADPOOL_H
+#define HEMELB_UTIL_THREADPOOL_H
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "units.h"
+
+namespace hemelb
+{
+  namespace util
+  {
+    /**
+     * A fixed-size pool of worker threads for splitting contiguous ranges of sites
+     * within a single MPI rank.
+     *
+     * The calling thread always takes part in the work, so a pool of size N owns N - 1
+     * background threads. A pool of size 1 owns no threads at all and simply runs the work
+     * inline, which keeps the single-threaded behaviour identical to the serial code.
+     *
+     * Only the calling thread is expected to make MPI calls (MPI_THREAD_FUNNELED).
+     */
+    class ThreadPool
+    {
+      public:
+        /**
+         * Constructor. Starts threadCount - 1 worker threads.
+         * @param threadCount The total number of threads to use, including the caller. Zero
+         * means use std::thread::hardware_concurrency().
+         */
+        explicit ThreadPool(unsigned threadCount);
+        ~ThreadPool();
+
+        /**
+         * @return the number of threads (including the calling thread) that share work.
+         */
+        unsigned GetThreadCount() const
+        {
+          return threadCount;
+        }
+
+        /**
+         * Split the site range [firstIndex, firstIndex + siteCount) into contiguous chunks,
+         * one per thread, and call work(chunkFirstIndex, chunkSiteCount) on each. Returns once
+         * every chunk has been processed. Ranges too small to be worth splitting are run
+         * entirely on the calling thread.
+         *
+         * @param firstIndex
+         * @param siteCount
+         * @param work
+         */
+        template<typename Functor>
+        void ParallelFor(const site_t firstIndex, const site_t siteCount, const Functor& work)
+        {
+          const site_t chunkCount = GetChunkCount(siteCount);
+
+          if (chunkCount <= 1)
+          {
+            work(firstIndex, siteCount);
+            return;
+          }
+
+          RunOnAll(chunkCount, [&work, firstIndex, siteCount, chunkCount] (unsigned chunk)
+          {
+            const site_t begin = firstIndex + (siteCount * chunk) / chunkCount;
+            const site_t end = firstIndex + (siteCount * (chunk + 1)) / chunkCount;
+            work(begin, end - begin);
+          });
+        }
+
+        /**
+         * The minimum number of sites each thread should be given before a range is split.
+         */
+        static const site_t MIN_SITES_PER_THREAD = 256;
+
+      private:
+        // Uncopyable.
+        ThreadPool(const ThreadPool&);
+        const ThreadPool& operator=(const ThreadPool&);
+
+        site_t GetChunkCount(const site_t siteCount) const;
+
+        /**
+         * Run task(i) for i in [0, taskCount), with taskCount <= threadCount. Task 0 is run
+         * on the calling thread.
+         */
+        void RunOnAll(const unsigned taskCount, const std::function<void(unsigned)>& task);
+
+        void WorkerLoop(const unsigned workerIndex);
+
+        unsigned threadCount;
+        std::vector<std::thread> workers;
+
+        std::mutex mutex;
+        std::condition_variable workAvailable;
+        std::condition_variable workDone;
+
+        const std::function<void(unsigned)>* currentTask;
+        unsigned currentTaskCount;
+        unsigned long generation;
+        unsigned pendingWorkers;
+        bool shuttingDown;
+    };
+  }
+}
+
+#endif /* HEMELB_UTIL_THREADPOOL_H */
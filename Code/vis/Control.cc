@@ -91,6 +91,17 @@ namespace hemelb
       visSettings.ctr_y = 0.5F * (float) (latticeData->GetBlockSize() * (mins[1] + maxes[1]));
       visSettings.ctr_z = 0.5F * (float) (latticeData->GetBlockSize() * (mins[2] + maxes[2]));
 
+      CreateDrawers();
+
+      // Note that rtInit does stuff to this->ctr_x (because this has
+      // to be global)
+      visSettings.ctr_x -= vis->half_dim[0];
+      visSettings.ctr_y -= vis->half_dim[1];
+      visSettings.ctr_z -= vis->half_dim[2];
+    }
+
+    void Control::CreateDrawers()
+    {
       normalRayTracer =
           new raytracer::RayTracer<raytracer::ClusterWithWallNormals, raytracer::RayDataNormal>(latticeData,
                                                                                                 &domainStats,
@@ -105,11 +116,15 @@ namespace hemelb
 #else
       myStreaker = NULL;
 #endif
-      // Note that rtInit does stuff to this->ctr_x (because this has
-      // to be global)
-      visSettings.ctr_x -= vis->half_dim[0];
-      visSettings.ctr_y -= vis->half_dim[1];
-      visSettings.ctr_z -= vis->half_dim[2];
+    }
+
+    void Control::Rebuild()
+    {
+      // The extent of the geometry, and so the view of it, stays the same.
+      delete myStreaker;
+      delete myGlypher;
+      delete normalRayTracer;
+      CreateDrawers();
     }
 
     void Control::SetProjection(const int &iPixels_x,
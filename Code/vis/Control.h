@@ -78,6 +78,12 @@ namespace hemelb
 
         void ProgressStreaklines(unsigned long time_step, unsigned long period);
 
+        /**
+         * Set up the drawers again for the lattice after it has been rebuilt for a new
+         * decomposition. Any streaklines are lost. There must be no images in progress.
+         */
+        void Rebuild();
+
         void UpdateImageSize(int pixels_x, int pixels_y);
         void SetMouseParams(double iPhysicalPressure, double iPhysicalStress);
 
@@ -126,6 +132,7 @@ namespace hemelb
         };
 
         void initLayers();
+        void CreateDrawers();
         void Render(unsigned long startIteration);
 
         mapType localResultsByStartIt;